@@ -0,0 +1,200 @@
+// The steady-state acquisition path must not touch the heap. Runs the
+// firmware's AcquisitionCycle (sensor read, filter, accumulate, change watch
+// and fast reports, report into the store, subscription polls, adaptive
+// scheduling) against the emulated SEN66, with sinks that read back what the
+// history, Matter and display consumers read, and every host allocation
+// reported to AllocationProbe as heap_caps does on the target.
+
+#include "AcquisitionCycle.h"
+#include "AirQualityIndex.h"
+#include "AllocationProbe.h"
+#include "HostCheck.h"
+#include "MatterUnits.h"
+#include "MeasurementStore.h"
+#include "SensirionSEN66.h"
+#include "TextRow.h"
+#include "sen66_i2c.h"
+#include "sensirion_i2c_hal_emulator.h"
+
+#include <esp_timer.h>
+#include <nvs.h>
+#include <stdio.h>
+#include <vector>
+
+namespace {
+
+using Type = Sensor::MeasurementType;
+
+constexpr uint64_t kSecondUs = 1000000;
+constexpr uint32_t kReportPeriodSec = 10;
+
+// A slowly varying hour of 1 Hz samples, with a CO2 step and a PM spike the
+// filter and change watch have to deal with
+std::vector<sensirion_emu_sample_t> MakeTrace()
+{
+    std::vector<sensirion_emu_sample_t> trace(3600);
+    for (size_t i = 0; i < trace.size(); i++) {
+        sensirion_emu_sample_t& s = trace[i];
+        s.pm1p0 = (uint16_t)(30 + i % 7);
+        s.pm2p5 = (uint16_t)(45 + i % 11);
+        s.pm4p0 = (uint16_t)(50 + i % 13);
+        s.pm10p0 = (uint16_t)(54 + i % 17);
+        s.humidity = (int16_t)(4500 + i % 50);
+        s.temperature = (int16_t)(4300 + i % 40);
+        s.voc_index = 1000;
+        s.nox_index = 10;
+        s.co2 = (uint16_t)(i < 1800 ? 620 + i % 9 : 1250 + i % 9);
+    }
+    trace[900].pm2p5 = 900;
+    return trace;
+}
+
+// The store as app_main and the Matter endpoints set it up
+void SetUpStore(MeasurementStore& store)
+{
+    const Type hourWindows[] = {Type::CO2, Type::PM1p0, Type::PM2p5, Type::PM10p0, Type::NOx, Type::VOC};
+    for (Type type : hourWindows) {
+        store.TrackWindows(type, 3600, 3600);
+    }
+    store.TrackWindows(Type::RelativeHumidity, 60, 60);
+    store.TrackWindows(Type::Temperature, 60, 60);
+    store.TrackRollups(Type::Temperature);
+    store.TrackRollups(Type::RelativeHumidity);
+    store.TrackRollups(Type::CO2);
+    store.TrackPercentiles(Type::CO2, 100.0f, 10000.0f, 0.03f, 24 * 3600);
+    store.TrackPercentiles(Type::PM2p5, 1.0f, 1000.0f, 0.05f, 24 * 3600);
+    store.TrackHistory(Type::CO2, 20);
+}
+
+// The emulated SEN66 in place of the firmware's sensor, and consumers that
+// read back what the firmware's read: the closed hours and trend figures
+// the history sink logs, the Matter thread's lock-free copy with its
+// classification and unit conversion, and one display row
+struct HostSinks : AcquisitionCycle::Sinks {
+    SensirionSEN66 sensor;
+    MeasurementStore* store = nullptr;
+    uint32_t published = 0;
+    uint32_t closedHours = 0;
+    uint32_t subscriptionPolls = 0;
+    uint32_t periodChanges = 0;
+    uint32_t lastClosedHour = UINT32_MAX;
+
+    bool Acquire(MeasurementSnapshot& sample) override
+    {
+        Sensor::MeasurementRecord record;
+        if (!sensor.ReadMeasurements(record) || record.IsEmpty()) {
+            return false;
+        }
+        sample = MeasurementSnapshot::FromRecord(record, esp_timer_get_time());
+        return true;
+    }
+
+    void PersistHistory(const MeasurementSnapshot& report) override
+    {
+        uint32_t startSeconds;
+        RollupSeries::Summary hour;
+        if (store->GetNewestClosedHour(Type::CO2, startSeconds, hour) && startSeconds != lastClosedHour) {
+            lastClosedHour = startSeconds;
+            closedHours++;
+            RollupSeries::Summary day = store->GetRollup(Type::CO2, 24 * 3600);
+            QuantileSketch::Percentiles exposure = store->GetPercentiles(Type::CO2, 8 * 3600);
+            char line[96];
+            TextRow(line).Native<0>(Type::CO2, day.mean).Float<0>(exposure.p95).Int(report.sampleCount);
+        }
+    }
+
+    void Publish(const MeasurementSnapshot& report) override
+    {
+        MeasurementStore::Published copy;
+        store->GetPublished(copy);
+        AirQualityIndex::Level level = AirQualityIndex::Classify(copy);
+        float co2 = MatterUnits::Concentration(Type::CO2, copy.GetLatest(Type::CO2)).value_or(0.0f);
+        char row[21];
+        TextRow(row).Reading(Type::CO2, report.GetNative(Type::CO2)).Int((int32_t)level).Int((int32_t)co2);
+        published++;
+    }
+
+    void PollSubscriptions() override { subscriptionPolls++; }
+    bool ConsumersIdle() override { return true; }
+    void OnPeriodChanged() override { periodChanges++; }
+    bool IsSensorRecovering() override { return sensor.IsRecovering(); }
+};
+
+// Volatile, so an optimising build cannot elide the allocations below
+int* volatile s_object;
+void* volatile s_block;
+
+// The probe must see host allocations, or a zero below proves nothing
+void TestProbeCountsAllocations()
+{
+    AllocationProbe::Begin();
+    s_object = new int(1);
+    s_block = malloc(16);
+    uint32_t count = AllocationProbe::End();
+    delete s_object;
+    free(s_block);
+    CHECK(AllocationProbe::kEnabled);
+    CHECK_EQ(count, 2);
+}
+
+void TestSteadyStateAllocatesNothing()
+{
+    sensirion_emu_reset();
+    nvs_host_erase_all();
+    std::vector<sensirion_emu_sample_t> trace = MakeTrace();
+    CHECK_EQ(sensirion_emu_add_sen66(0, SEN66_I2C_ADDR_6B), 0);
+    sensirion_emu_set_trace(0, SEN66_I2C_ADDR_6B, trace.data(), trace.size());
+
+    MeasurementStore store;
+    SetUpStore(store);
+    HostSinks sinks;
+    sinks.store = &store;
+    CHECK(sinks.sensor.Init());
+    AcquisitionCycle cycle(store, sinks);
+    cycle.Configure(true, kReportPeriodSec, 60, esp_timer_get_time());
+
+    // Warm-up: the first reports fill the store's windows and rollups
+    for (int i = 0; i < 120; i++) {
+        sensirion_emu_advance_us(kSecondUs);
+        cycle.Run(false);
+    }
+
+    uint32_t maxPerCycle = 0;
+    uint64_t total = 0;
+    uint32_t scheduled = 0;
+    uint32_t publishedBefore = sinks.published;
+    const int cycles = 3 * 3600;
+    for (int i = 0; i < cycles; i++) {
+        sensirion_emu_advance_us(kSecondUs);
+        // As RunAcquisitionCycle() brackets it on the device
+        AllocationProbe::Begin();
+        scheduled += cycle.Run(false);
+        uint32_t count = AllocationProbe::End();
+        total += count;
+        maxPerCycle = count > maxPerCycle ? count : maxPerCycle;
+    }
+    uint32_t published = sinks.published - publishedBefore;
+
+    printf("%d cycles, %u report(s) (%u out of cycle), %u closed hour(s), %u period change(s): "
+           "%llu allocation(s), at most %u in one cycle\n",
+           cycles, (unsigned)published, (unsigned)(published - scheduled), (unsigned)sinks.closedHours,
+           (unsigned)sinks.periodChanges, (unsigned long long)total, (unsigned)maxPerCycle);
+    CHECK_EQ(total, 0);
+    // Every path ran: scheduled and out-of-cycle reports, hours closing,
+    // subscription polls and the period stretching
+    CHECK(scheduled >= cycles / 60);
+    CHECK(published > scheduled);
+    CHECK(sinks.closedHours >= 2);
+    CHECK(sinks.subscriptionPolls >= cycles / 10);
+    CHECK(sinks.periodChanges > 0);
+    CHECK(cycle.GetReportPeriodSec() > kReportPeriodSec);
+}
+
+} // namespace
+
+int main()
+{
+    TestProbeCountsAllocations();
+    TestSteadyStateAllocatesNothing();
+    return HostCheck::ExitCode();
+}
@@ -0,0 +1,206 @@
+// The adaptive refresh with the firmware's stable bands: the period doubles
+// after every kStableReportsPerStep stable reports up to the ceiling, and
+// drops back to the floor on a value leaving its band, a value appearing, a
+// consumer, or Wake(), each of which also restarts the stable count.
+
+#include "AdaptiveScheduler.h"
+#include "HostCheck.h"
+
+#include <stdio.h>
+
+namespace {
+
+using Type = Sensor::MeasurementType;
+
+constexpr uint32_t kFloor = 30;
+constexpr uint32_t kCeiling = 300;
+
+void Set(MeasurementSnapshot& snapshot, Type type, int32_t native)
+{
+    snapshot.values[static_cast<size_t>(type)] = native;
+    snapshot.validMask |= MeasurementSnapshot::Bit(type);
+}
+
+// A quiet room, in native steps
+MeasurementSnapshot Quiet()
+{
+    MeasurementSnapshot report;
+    Set(report, Type::Temperature, 4400);       // 22 °C
+    Set(report, Type::RelativeHumidity, 4500);  // 45 %RH
+    Set(report, Type::CO2, 600);                // ppm
+    Set(report, Type::PM2p5, 30);               // 3.0 µg/m³
+    return report;
+}
+
+// As kStableBands in AcquisitionCycle.cpp, bounded as at boot
+void SetUp(AdaptiveScheduler& scheduler)
+{
+    scheduler.SetBounds(kFloor, kCeiling);
+    scheduler.SetStableBand(Type::Temperature, 0.2f);
+    scheduler.SetStableBand(Type::RelativeHumidity, 1.0f);
+    scheduler.SetStableBand(Type::CO2, 25.0f);
+    scheduler.SetStableBand(Type::PM2p5, 0.3f);
+}
+
+// Feeds stable reports until the period changes; returns how many it took
+int ReportsUntilChange(AdaptiveScheduler& scheduler, const MeasurementSnapshot& report)
+{
+    for (int n = 1; n <= 10; n++) {
+        if (scheduler.OnReport(report, true)) {
+            return n;
+        }
+    }
+    return 0;
+}
+
+// 30 s doubles every three stable reports to 60, 120, 240, then stops at
+// the 300 s ceiling
+void TestDoubling()
+{
+    AdaptiveScheduler scheduler;
+    SetUp(scheduler);
+    MeasurementSnapshot report = Quiet();
+    CHECK_EQ(scheduler.GetPeriodSec(), kFloor);
+    CHECK(!scheduler.IsStretched());
+
+    // The first report has nothing to compare with, so it isn't stable
+    CHECK(!scheduler.OnReport(report, true));
+    const uint32_t kSteps[] = {60, 120, 240, 300};
+    for (uint32_t period : kSteps) {
+        CHECK_EQ(ReportsUntilChange(scheduler, report), AdaptiveScheduler::kStableReportsPerStep);
+        CHECK_EQ(scheduler.GetPeriodSec(), period);
+        CHECK(scheduler.IsStretched());
+    }
+    CHECK_EQ(ReportsUntilChange(scheduler, report), 0);
+    CHECK_EQ(scheduler.GetPeriodSec(), kCeiling);
+}
+
+// Each band is inclusive, a type without one never counts, and any reason to
+// wake goes straight back to the floor
+void TestBands()
+{
+    struct Case {
+        Type type;
+        int32_t inBand;  // native steps; one more leaves the band
+        const char* name;
+    };
+    const Case kCases[] = {
+        {Type::Temperature, 40, "temperature"},
+        {Type::RelativeHumidity, 100, "humidity"},
+        {Type::CO2, 25, "CO2"},
+        {Type::PM2p5, 3, "PM2.5"},
+    };
+
+    for (const Case& c : kCases) {
+        AdaptiveScheduler scheduler;
+        SetUp(scheduler);
+        MeasurementSnapshot report = Quiet();
+        scheduler.OnReport(report, true);
+        CHECK_EQ(ReportsUntilChange(scheduler, report), AdaptiveScheduler::kStableReportsPerStep);
+
+        // Drifting by the band each report is still stable
+        for (int n = 0; n < 3; n++) {
+            Set(report, c.type, report.GetNative(c.type) + c.inBand);
+            CHECK(!scheduler.OnReport(report, true) || scheduler.GetPeriodSec() == 120);
+        }
+        CHECK_EQ(scheduler.GetPeriodSec(), 120);
+
+        Set(report, c.type, report.GetNative(c.type) - c.inBand - 1);
+        if (!CHECK(scheduler.OnReport(report, true))) {
+            fprintf(stderr, "%s left its band without waking\n", c.name);
+        }
+        CHECK_EQ(scheduler.GetPeriodSec(), kFloor);
+    }
+
+    // VOC has no band: any change is stable
+    AdaptiveScheduler scheduler;
+    SetUp(scheduler);
+    MeasurementSnapshot report = Quiet();
+    Set(report, Type::VOC, 100);
+    scheduler.OnReport(report, true);
+    Set(report, Type::VOC, 400);
+    CHECK(!scheduler.OnReport(report, true));
+    Set(report, Type::VOC, 20);
+    CHECK(!scheduler.OnReport(report, true));
+    Set(report, Type::VOC, 500);
+    CHECK(scheduler.OnReport(report, true));
+    CHECK_EQ(scheduler.GetPeriodSec(), 60);
+}
+
+// A value the previous report lacked, and a busy consumer, both wake
+void TestNewsAndConsumers()
+{
+    AdaptiveScheduler scheduler;
+    SetUp(scheduler);
+    MeasurementSnapshot report = Quiet();
+    report.validMask &= ~MeasurementSnapshot::Bit(Type::PM2p5);
+    scheduler.OnReport(report, true);
+    CHECK_EQ(ReportsUntilChange(scheduler, report), AdaptiveScheduler::kStableReportsPerStep);
+
+    MeasurementSnapshot withPm = Quiet();
+    CHECK(scheduler.OnReport(withPm, true));
+    CHECK_EQ(scheduler.GetPeriodSec(), kFloor);
+
+    CHECK_EQ(ReportsUntilChange(scheduler, withPm), AdaptiveScheduler::kStableReportsPerStep);
+    CHECK(scheduler.OnReport(withPm, false)); // display on or a subscription
+    CHECK_EQ(scheduler.GetPeriodSec(), kFloor);
+    CHECK(!scheduler.OnReport(withPm, false)); // already at the floor
+}
+
+// Wake() drops to the floor and restarts the count; at the floor it changes
+// nothing, but the count still restarts
+void TestWake()
+{
+    AdaptiveScheduler scheduler;
+    SetUp(scheduler);
+    MeasurementSnapshot report = Quiet();
+    scheduler.OnReport(report, true);
+
+    CHECK(!scheduler.OnReport(report, true));
+    CHECK(!scheduler.OnReport(report, true));
+    CHECK(!scheduler.Wake());
+    CHECK_EQ(ReportsUntilChange(scheduler, report), AdaptiveScheduler::kStableReportsPerStep);
+    CHECK_EQ(scheduler.GetPeriodSec(), 60);
+
+    CHECK(!scheduler.OnReport(report, true));
+    CHECK(!scheduler.OnReport(report, true));
+    CHECK(scheduler.Wake());
+    CHECK_EQ(scheduler.GetPeriodSec(), kFloor);
+    CHECK(!scheduler.IsStretched());
+    CHECK_EQ(ReportsUntilChange(scheduler, report), AdaptiveScheduler::kStableReportsPerStep);
+
+    // New bounds restart at the new floor
+    scheduler.SetBounds(10, 40);
+    CHECK_EQ(scheduler.GetPeriodSec(), 10);
+    CHECK_EQ(ReportsUntilChange(scheduler, report), AdaptiveScheduler::kStableReportsPerStep);
+    CHECK_EQ(scheduler.GetPeriodSec(), 20);
+}
+
+// A ceiling at or below the floor never stretches
+void TestDisabled()
+{
+    const uint32_t kCeilings[] = {kFloor, kFloor / 2};
+    for (uint32_t ceiling : kCeilings) {
+        AdaptiveScheduler scheduler;
+        SetUp(scheduler);
+        scheduler.SetBounds(kFloor, ceiling);
+        MeasurementSnapshot report = Quiet();
+        for (int n = 0; n < 20; n++) {
+            CHECK(!scheduler.OnReport(report, true));
+        }
+        CHECK_EQ(scheduler.GetPeriodSec(), kFloor);
+        CHECK(!scheduler.Wake());
+    }
+}
+
+} // namespace
+
+int main()
+{
+    TestDoubling();
+    TestBands();
+    TestNewsAndConsumers();
+    TestWake();
+    TestDisabled();
+    return HostCheck::ExitCode();
+}
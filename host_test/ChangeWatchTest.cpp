@@ -0,0 +1,250 @@
+// The fast-report watch with the firmware's CO2 and PM2.5 thresholds: jumps
+// away from the last reported value, slopes over at least the slope window
+// with the reference moving once per window whether or not it trips, which
+// type is named when several trip, and Reset(). A random trace is then run
+// against the same rules worked out in units.
+
+#include "ChangeWatch.h"
+#include "HostCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace {
+
+using Type = Sensor::MeasurementType;
+
+constexpr int64_t kSecondUs = 1000000;
+
+// As kFastReportTriggers in AcquisitionCycle.cpp
+void SetFirmwareThresholds(ChangeWatch& watch)
+{
+    watch.SetThreshold(Type::CO2, 200.0f, 150.0f);   // ppm
+    watch.SetThreshold(Type::PM2p5, 15.0f, 10.0f);   // µg/m³
+    watch.SetThreshold(Type::PM10p0, 25.0f, 20.0f);  // µg/m³
+    watch.SetThreshold(Type::VOC, 100.0f, 0.0f);     // index
+    watch.SetThreshold(Type::NOx, 50.0f, 0.0f);      // index
+}
+
+void Set(MeasurementSnapshot& snapshot, Type type, int32_t native)
+{
+    snapshot.values[static_cast<size_t>(type)] = native;
+    snapshot.validMask |= MeasurementSnapshot::Bit(type);
+}
+
+// A CO2 reading (native steps are ppm) at the given second
+MeasurementSnapshot Co2(int32_t ppm, int64_t seconds)
+{
+    MeasurementSnapshot snapshot;
+    snapshot.timestampUs = seconds * kSecondUs;
+    Set(snapshot, Type::CO2, ppm);
+    return snapshot;
+}
+
+bool Trips(ChangeWatch& watch, const MeasurementSnapshot& sample, Type expected = Type::CO2)
+{
+    Type trigger = Type::AmbientLight;
+    if (!watch.Check(sample, trigger)) {
+        return false;
+    }
+    CHECK(trigger == expected);
+    return true;
+}
+
+// 200 ppm away from the baseline trips in either direction; nothing trips
+// on a jump before there is a baseline
+void TestJump()
+{
+    ChangeWatch watch;
+    watch.SetThreshold(Type::CO2, 200.0f, 0.0f);
+    CHECK(!Trips(watch, Co2(5000, 0)));
+
+    watch.SetBaseline(Co2(800, 0));
+    CHECK(!Trips(watch, Co2(999, 1)));
+    CHECK(Trips(watch, Co2(1000, 2)));
+    CHECK(!Trips(watch, Co2(601, 3)));
+    CHECK(Trips(watch, Co2(600, 4)));
+
+    // The baseline only moves when told
+    CHECK(Trips(watch, Co2(1000, 5)));
+    watch.SetBaseline(Co2(1000, 5));
+    CHECK(!Trips(watch, Co2(1100, 6)));
+
+    // A report without CO2 leaves its baseline alone
+    MeasurementSnapshot other;
+    Set(other, Type::PM2p5, 50);
+    watch.SetBaseline(other);
+    CHECK(!Trips(watch, Co2(1199, 7)));
+    CHECK(Trips(watch, Co2(1200, 8)));
+
+    // A sample without CO2 checks nothing
+    CHECK(!Trips(watch, other));
+}
+
+// 150 ppm per minute, measured against a reference that moves once per 30 s
+// window, tripped or not
+void TestSlope()
+{
+    ChangeWatch watch;
+    watch.SetThreshold(Type::CO2, 0.0f, 150.0f);
+
+    CHECK(!Trips(watch, Co2(800, 0)));   // the first sample becomes the reference
+    CHECK(!Trips(watch, Co2(1500, 10))); // steep, but inside the window
+    CHECK(!Trips(watch, Co2(800, 29)));
+    CHECK(Trips(watch, Co2(875, 30)));   // 75 ppm in 30 s: exactly 150/min
+
+    // The reference is now 875 at 30 s
+    CHECK(!Trips(watch, Co2(2000, 40)));
+    CHECK(!Trips(watch, Co2(949, 60)));  // 74 ppm in 30 s: 148/min
+    // ...and moved again without tripping: 949 at 60 s
+    CHECK(Trips(watch, Co2(874, 90)));   // falling 75 ppm in 30 s
+
+    // A long gap dilutes the change: 299 ppm over 2 min is 149.5/min
+    CHECK(!Trips(watch, Co2(1173, 210)));
+    CHECK(Trips(watch, Co2(1473, 330)));
+
+    // Reset() drops the reference: the next sample starts a new window
+    watch.Reset();
+    CHECK(!Trips(watch, Co2(3000, 340)));
+    CHECK(!Trips(watch, Co2(3074, 370)));
+    CHECK(Trips(watch, Co2(3149, 400)));
+}
+
+// All of the firmware's triggers at once: the type first in enum order is
+// named, and types without a threshold never trip
+void TestFirmwareThresholds()
+{
+    ChangeWatch watch;
+    SetFirmwareThresholds(watch);
+    MeasurementSnapshot baseline;
+    Set(baseline, Type::CO2, 800);
+    Set(baseline, Type::PM2p5, 50);       // 5.0 µg/m³
+    Set(baseline, Type::Temperature, 4400);
+    watch.SetBaseline(baseline);
+    CHECK(!Trips(watch, baseline));
+
+    MeasurementSnapshot sample = baseline;
+    sample.timestampUs = 1 * kSecondUs;
+    Set(sample, Type::PM2p5, 200);        // +15 µg/m³
+    CHECK(Trips(watch, sample, Type::PM2p5));
+    Set(sample, Type::CO2, 1000);
+    CHECK(Trips(watch, sample, Type::CO2)); // CO2 comes before PM2.5
+    Set(sample, Type::CO2, 800);
+    Set(sample, Type::PM2p5, 199);
+    Set(sample, Type::Temperature, 8000); // no threshold: ignored
+    CHECK(!Trips(watch, sample));
+
+    // Reset() forgets the baseline until the next report
+    watch.Reset();
+    Set(sample, Type::CO2, 5000);
+    sample.timestampUs = 2 * kSecondUs;
+    CHECK(!Trips(watch, sample));
+    watch.SetBaseline(baseline);
+    CHECK(Trips(watch, sample));
+}
+
+// The same rules in units, from the thresholds as configured
+class Reference
+{
+public:
+    Reference(float jump, float slopePerMinute, float scale)
+        : m_jump(jump)
+        , m_slope(slopePerMinute)
+        , m_scale(scale)
+    {
+    }
+
+    void SetBaseline(int32_t native)
+    {
+        m_baseline = native / m_scale;
+        m_haveBaseline = true;
+    }
+
+    bool Check(int32_t native, int64_t timestampUs)
+    {
+        double value = native / m_scale;
+        bool hit = m_haveBaseline && fabs(value - m_baseline) >= m_jump - 1e-6;
+        if (!m_haveReference) {
+            m_haveReference = true;
+        } else if (timestampUs - m_referenceUs >= ChangeWatch::kSlopeWindowUs) {
+            double minutes = (timestampUs - m_referenceUs) / 60e6;
+            hit = hit || fabs(value - m_reference) / minutes >= m_slope - 1e-6;
+        } else {
+            return hit;
+        }
+        m_reference = value;
+        m_referenceUs = timestampUs;
+        return hit;
+    }
+
+private:
+    double m_jump;
+    double m_slope;
+    double m_scale;
+    double m_baseline = 0;
+    bool m_haveBaseline = false;
+    double m_reference = 0;
+    int64_t m_referenceUs = 0;
+    bool m_haveReference = false;
+};
+
+struct Lcg {
+    uint32_t state = 4242;
+
+    int32_t operator()(int32_t range)
+    {
+        state = state * 1664525u + 1013904223u;
+        return (int32_t)((state >> 8) % (uint32_t)(2 * range + 1)) - range;
+    }
+};
+
+// A day of PM2.5 (tenths of µg/m³) sampled every 1-20 s as a random walk,
+// reported every 5 minutes or when the watch trips
+void TestRandomTrace()
+{
+    ChangeWatch watch;
+    SetFirmwareThresholds(watch);
+    Reference reference(15.0f, 10.0f, Sensor::NativeScale(Type::PM2p5));
+    Lcg random;
+    int32_t pm = 100;
+    int64_t timestampUs = 0;
+    int64_t lastReportUs = 0;
+    int trips = 0, mismatches = 0;
+
+    while (timestampUs < 86400 * kSecondUs && mismatches < 5) {
+        pm = std::max(0, pm + random(random(50) == 0 ? 200 : 15));
+        timestampUs += (10 + random(9)) * kSecondUs + random(400000);
+        MeasurementSnapshot sample;
+        sample.timestampUs = timestampUs;
+        Set(sample, Type::PM2p5, pm);
+
+        Type trigger;
+        bool tripped = watch.Check(sample, trigger);
+        bool expected = reference.Check(pm, timestampUs);
+        if (!CHECK_EQ(tripped, expected)) {
+            fprintf(stderr, "PM2.5 %d at %.1f s\n", (int)pm, timestampUs / 1e6);
+            mismatches++;
+        }
+        trips += tripped;
+        if (tripped || timestampUs - lastReportUs >= 300 * kSecondUs) {
+            watch.SetBaseline(sample);
+            reference.SetBaseline(pm);
+            lastReportUs = timestampUs;
+        }
+    }
+    CHECK(trips > 50);
+    printf("PM2.5 random walk: %d trip(s) in a day, all as worked out in units\n", trips);
+}
+
+} // namespace
+
+int main()
+{
+    TestJump();
+    TestSlope();
+    TestFirmwareThresholds();
+    TestRandomTrace();
+    return HostCheck::ExitCode();
+}
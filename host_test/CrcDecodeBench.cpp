@@ -0,0 +1,164 @@
+// Sensirion response frames: the bit-by-bit CRC-8 the driver used to compute
+// against its lookup table, and the read paths from raw frame to words.
+//   before:  bitwise CRC, in-place compaction, then one
+//            sensirion_common_bytes_to_uint16_t() per field
+//   inplace: sensirion_i2c_read_data_inplace() as it is now (table CRC), then
+//            per field
+//   decoded: sensirion_i2c_read_words_decoded(), one pass
+// Frame sizes are the SEN66's raw values and number concentrations (5 words),
+// measured values (9 words, 18 data bytes), the serial number (16 words) and
+// the largest frame the driver accepts (32 words).
+//
+// Built against the protocol layer only; the HAL here hands back a prepared
+// frame, so the figures are the decoding alone.
+
+#include "HostBench.h"
+#include "HostCheck.h"
+#include "sensirion_common.h"
+#include "sensirion_i2c.h"
+#include "sensirion_i2c_hal.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+
+constexpr uint16_t kFrameBytesPerWord = SENSIRION_WORD_SIZE + CRC8_LEN;
+
+uint8_t s_frame[SENSIRION_MAX_BUFFER_WORDS * kFrameBytesPerWord];
+
+// The driver's CRC before the table
+uint8_t BitwiseCrc(const uint8_t* data, uint16_t count)
+{
+    uint8_t crc = CRC8_INIT;
+    for (uint16_t i = 0; i < count; i++) {
+        crc ^= data[i];
+        for (int bit = 8; bit > 0; --bit) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ CRC8_POLYNOMIAL) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// sensirion_i2c_read_data_inplace() with the bitwise CRC, as it was
+int16_t ReadInplaceBitwise(uint8_t* buffer, uint16_t dataBytes)
+{
+    uint16_t size = (dataBytes / SENSIRION_WORD_SIZE) * kFrameBytesPerWord;
+    if (sensirion_i2c_hal_read(0, buffer, (uint8_t)size) != NO_ERROR) {
+        return I2C_BUS_ERROR;
+    }
+    for (uint16_t i = 0, j = 0; i < size; i += kFrameBytesPerWord) {
+        if (BitwiseCrc(&buffer[i], SENSIRION_WORD_SIZE) != buffer[i + SENSIRION_WORD_SIZE]) {
+            return CRC_ERROR;
+        }
+        buffer[j++] = buffer[i];
+        buffer[j++] = buffer[i + 1];
+    }
+    return NO_ERROR;
+}
+
+// A valid frame of distinct words
+void PrepareFrame(uint16_t words)
+{
+    for (uint16_t i = 0; i < words; i++) {
+        uint8_t* p = &s_frame[i * kFrameBytesPerWord];
+        uint16_t word = (uint16_t)(0x1234 + i * 0x0F0F);
+        p[0] = (uint8_t)(word >> 8);
+        p[1] = (uint8_t)word;
+        p[2] = BitwiseCrc(p, SENSIRION_WORD_SIZE);
+    }
+}
+
+} // namespace
+
+// The HAL the protocol layer calls: every read returns the prepared frame
+extern "C" int8_t sensirion_i2c_hal_read(uint8_t, uint8_t* data, uint8_t count)
+{
+    memcpy(data, s_frame, count);
+    return NO_ERROR;
+}
+
+extern "C" int8_t sensirion_i2c_hal_write(uint8_t, const uint8_t*, uint8_t)
+{
+    return NO_ERROR;
+}
+
+extern "C" void sensirion_i2c_hal_sleep_usec(uint32_t)
+{
+}
+
+int main(int argc, char** argv)
+{
+    const uint64_t iterations = HostBench::Iterations(argc, argv, 2000000);
+
+    // The table gives the same CRC as the loop for every word
+    for (uint32_t word = 0; word <= 0xFFFF; word++) {
+        uint8_t bytes[2] = {(uint8_t)(word >> 8), (uint8_t)word};
+        if (!CHECK_EQ(sensirion_i2c_generate_crc(bytes, 2), BitwiseCrc(bytes, 2))) {
+            break;
+        }
+    }
+    const uint8_t example[2] = {0xBE, 0xEF};
+    CHECK_EQ(sensirion_i2c_generate_crc(example, 2), 0x92); // datasheet example
+
+    printf("%6s %12s %12s %12s %12s %12s\n", "words", "CRC bitwise", "CRC table", "before", "inplace",
+           "decoded");
+    printf("%6s %12s %12s %12s %12s %12s\n", "", "ns/frame", "ns/frame", "ns/frame", "ns/frame", "ns/frame");
+
+    const uint16_t sizes[] = {5, 9, 16, SENSIRION_MAX_BUFFER_WORDS};
+    for (uint16_t words : sizes) {
+        PrepareFrame(words);
+        const uint16_t frameBytes = words * kFrameBytesPerWord;
+
+        double crcBitwise = HostBench::NsPerCall(iterations, [&](uint64_t) {
+            uint8_t sum = 0;
+            for (uint16_t i = 0; i < frameBytes; i += kFrameBytesPerWord) {
+                sum ^= BitwiseCrc(&s_frame[i], SENSIRION_WORD_SIZE);
+            }
+            HostBench::Keep(sum);
+        });
+        double crcTable = HostBench::NsPerCall(iterations, [&](uint64_t) {
+            uint8_t sum = 0;
+            for (uint16_t i = 0; i < frameBytes; i += kFrameBytesPerWord) {
+                sum ^= sensirion_i2c_generate_crc(&s_frame[i], SENSIRION_WORD_SIZE);
+            }
+            HostBench::Keep(sum);
+        });
+
+        uint8_t buffer[sizeof(s_frame)];
+        uint16_t before[SENSIRION_MAX_BUFFER_WORDS];
+        uint16_t inplace[SENSIRION_MAX_BUFFER_WORDS];
+        uint16_t decoded[SENSIRION_MAX_BUFFER_WORDS];
+
+        double beforeNs = HostBench::NsPerCall(iterations, [&](uint64_t) {
+            ReadInplaceBitwise(buffer, words * SENSIRION_WORD_SIZE);
+            for (uint16_t i = 0; i < words; i++) {
+                before[i] = sensirion_common_bytes_to_uint16_t(&buffer[i * SENSIRION_WORD_SIZE]);
+            }
+            HostBench::Keep(before);
+        });
+        double inplaceNs = HostBench::NsPerCall(iterations, [&](uint64_t) {
+            sensirion_i2c_read_data_inplace(0, buffer, words * SENSIRION_WORD_SIZE);
+            for (uint16_t i = 0; i < words; i++) {
+                inplace[i] = sensirion_common_bytes_to_uint16_t(&buffer[i * SENSIRION_WORD_SIZE]);
+            }
+            HostBench::Keep(inplace);
+        });
+        double decodedNs = HostBench::NsPerCall(iterations, [&](uint64_t) {
+            sensirion_i2c_read_words_decoded(0, decoded, words);
+            HostBench::Keep(decoded);
+        });
+
+        CHECK(memcmp(before, decoded, words * sizeof(uint16_t)) == 0);
+        CHECK(memcmp(inplace, decoded, words * sizeof(uint16_t)) == 0);
+        printf("%6u %12.1f %12.1f %12.1f %12.1f %12.1f\n", (unsigned)words, crcBitwise, crcTable, beforeNs,
+               inplaceNs, decodedNs);
+    }
+
+    // A corrupted CRC is still caught by the one-pass decoder
+    PrepareFrame(9);
+    s_frame[4 * kFrameBytesPerWord + 2] ^= 0x01;
+    uint16_t words[9];
+    CHECK_EQ(sensirion_i2c_read_words_decoded(0, words, 9), CRC_ERROR);
+    return HostCheck::ExitCode();
+}
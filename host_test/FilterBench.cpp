@@ -0,0 +1,197 @@
+// What the SampleFilter stage costs per sample and what it saves: a day of
+// 1 Hz SEN66-like samples goes through the acquisition pipeline (change
+// watch between 60 s scheduled reports) without and with the firmware's
+// filter configuration, counting the out-of-cycle reports the change watch
+// sends and how often the reported air-quality level changes (the LED
+// colour).
+//
+// There are no recorded traces in the tree, so the day is synthetic but
+// shaped on the sensor: a slow CO2 swing with read noise, a real cooking
+// event (PM2.5 up for 20 minutes, CO2 up with it), and single-read glitches
+// on the PM and CO2 channels of the kind the Hampel stage is there for.
+
+#include "AirQualityIndex.h"
+#include "ChangeWatch.h"
+#include "HostBench.h"
+#include "HostCheck.h"
+#include "SampleAccumulator.h"
+#include "SampleFilter.h"
+
+#include <cmath>
+#include <stdio.h>
+#include <vector>
+
+namespace {
+
+using Type = Sensor::MeasurementType;
+using Level = AirQualityIndex::Level;
+
+constexpr int kDaySec = 24 * 3600;
+constexpr int kReportSec = 60;
+constexpr int kCookingStartSec = 18 * 3600;
+constexpr int kCookingSec = 20 * 60;
+
+// Deterministic noise, uniform in [-range, range]
+struct Noise {
+    uint32_t state = 12345;
+
+    int32_t operator()(int32_t range)
+    {
+        state = state * 1664525u + 1013904223u;
+        return (int32_t)((state >> 8) % (uint32_t)(2 * range + 1)) - range;
+    }
+};
+
+void Set(MeasurementSnapshot& s, Type type, int32_t value)
+{
+    size_t i = static_cast<size_t>(type);
+    s.values[i] = s.minValues[i] = s.maxValues[i] = value;
+    s.validMask |= MeasurementSnapshot::Bit(type);
+}
+
+std::vector<MeasurementSnapshot> MakeDay(uint32_t& glitches)
+{
+    std::vector<MeasurementSnapshot> day(kDaySec);
+    Noise noise;
+    glitches = 0;
+    for (int t = 0; t < kDaySec; t++) {
+        MeasurementSnapshot& s = day[t];
+        s.timestampUs = (int64_t)t * 1000000;
+
+        bool cooking = t >= kCookingStartSec && t < kCookingStartSec + kCookingSec;
+        int32_t co2 = 750 + (int32_t)(300 * std::sin(2 * M_PI * t / kDaySec)) + noise(10) + (cooking ? 350 : 0);
+        int32_t pm25 = 60 + noise(4) + (cooking ? 600 : 0); // tenths of ug/m3
+
+        // A glitch about every 20 min on PM, every 2 h on CO2
+        if (noise(600) == 0) {
+            pm25 += 700 + noise(200);
+            glitches++;
+        }
+        if (noise(3600) == 0) {
+            co2 += 500;
+            glitches++;
+        }
+
+        Set(s, Type::CO2, co2);
+        Set(s, Type::PM1p0, pm25 * 2 / 3);
+        Set(s, Type::PM2p5, pm25);
+        Set(s, Type::PM4p0, pm25 + 5);
+        Set(s, Type::PM10p0, pm25 + 15 + noise(5));
+        Set(s, Type::Temperature, 4400 + noise(4));
+        Set(s, Type::RelativeHumidity, 4500 + noise(20));
+    }
+    return day;
+}
+
+// The firmware's filter and change-watch settings (AcquisitionCycle.cpp)
+void ConfigureFilter(SampleFilter& filter)
+{
+    filter.Configure(Type::CO2, {5, 30, 30.0f, 0, 0});
+    filter.Configure(Type::PM1p0, {5, 30, 2.0f, 0, 0});
+    filter.Configure(Type::PM2p5, {5, 30, 2.0f, 0, 0});
+    filter.Configure(Type::PM4p0, {5, 30, 2.0f, 0, 0});
+    filter.Configure(Type::PM10p0, {5, 30, 3.0f, 0, 0});
+}
+
+void ConfigureWatch(ChangeWatch& watch)
+{
+    watch.SetThreshold(Type::CO2, 200.0f, 150.0f);
+    watch.SetThreshold(Type::PM2p5, 15.0f, 10.0f);
+    watch.SetThreshold(Type::PM10p0, 25.0f, 20.0f);
+}
+
+Level LevelOf(const MeasurementSnapshot& report)
+{
+    return std::max(AirQualityIndex::ByCO2(report.GetNative(Type::CO2)),
+                    AirQualityIndex::ByPM25(report.GetNative(Type::PM2p5), report.GetNative(Type::PM2p5)));
+}
+
+struct Outcome {
+    uint32_t fastReports = 0;
+    uint32_t cookingFastReports = 0;
+    uint32_t levelChanges = 0;
+    uint32_t rejected = 0;
+};
+
+Outcome Replay(const std::vector<MeasurementSnapshot>& day, bool filtered)
+{
+    SampleFilter filter;
+    if (filtered) {
+        ConfigureFilter(filter);
+    }
+    ChangeWatch watch;
+    ConfigureWatch(watch);
+    SampleAccumulator accumulator;
+    Outcome outcome;
+    Level level = Level::Unknown;
+
+    auto publish = [&](const MeasurementSnapshot& report) {
+        watch.SetBaseline(report);
+        Level now = LevelOf(report);
+        if (level != Level::Unknown && now != level) {
+            outcome.levelChanges++;
+        }
+        level = now;
+    };
+
+    for (int t = 0; t < kDaySec; t++) {
+        MeasurementSnapshot sample = day[t];
+        filter.Apply(sample);
+        accumulator.Add(sample);
+
+        if ((t + 1) % kReportSec == 0) {
+            MeasurementSnapshot report;
+            accumulator.Decimate(sample.timestampUs, report);
+            accumulator.Reset();
+            publish(report);
+            continue;
+        }
+        Type trigger;
+        if (watch.Check(sample, trigger)) {
+            outcome.fastReports++;
+            if (t >= kCookingStartSec && t < kCookingStartSec + kCookingSec) {
+                outcome.cookingFastReports++;
+            }
+            publish(sample);
+        }
+    }
+    outcome.rejected = filter.GetRejectedCount();
+    return outcome;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    uint32_t glitches;
+    const std::vector<MeasurementSnapshot> day = MakeDay(glitches);
+
+    Outcome raw = Replay(day, false);
+    Outcome filtered = Replay(day, true);
+
+    printf("synthetic day: %d samples, %u single-read glitches\n", kDaySec, (unsigned)glitches);
+    printf("%-26s %10s %10s\n", "", "unfiltered", "filtered");
+    printf("%-26s %10u %10u\n", "out-of-cycle reports", (unsigned)raw.fastReports, (unsigned)filtered.fastReports);
+    printf("%-26s %10u %10u\n", "  of them while cooking", (unsigned)raw.cookingFastReports,
+           (unsigned)filtered.cookingFastReports);
+    printf("%-26s %10u %10u\n", "air-quality level changes", (unsigned)raw.levelChanges,
+           (unsigned)filtered.levelChanges);
+    printf("%-26s %10s %10u\n", "samples rejected", "-", (unsigned)filtered.rejected);
+
+    // Cost of Apply() with the five filtered types, over the same day
+    SampleFilter filter;
+    ConfigureFilter(filter);
+    std::vector<MeasurementSnapshot> samples = day;
+    const uint64_t passes = HostBench::Iterations(argc, argv, 1000);
+    uint64_t start = 0;
+    double ns = HostBench::NsPerCall(passes * kDaySec / 100, [&](uint64_t) {
+        MeasurementSnapshot sample = samples[start++ % kDaySec];
+        HostBench::Keep(filter.Apply(sample));
+    });
+    printf("Apply(): %.1f ns per sample, five filtered types\n", ns);
+
+    CHECK(filtered.fastReports < raw.fastReports);
+    CHECK(filtered.cookingFastReports >= 1); // the real event still gets through
+    CHECK(filtered.levelChanges <= raw.levelChanges);
+    return HostCheck::ExitCode();
+}
@@ -0,0 +1,319 @@
+// The hourly history log on a RAM-backed partition the size of the firmware's
+// "history" partition (26 sectors): formatting, appending, recovering the
+// write position after a reboot, wrapping around the ring, skipping records
+// torn or corrupted in flash, and the flash traffic an hour costs.
+
+#include "HistoryLog.h"
+#include "HostCheck.h"
+
+#include <esp_partition.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+constexpr const char* kLabel = "history";
+constexpr size_t kSectorSize = 4096;
+constexpr size_t kSectors = 26;
+constexpr size_t kRecordsPerSector = kSectorSize / sizeof(HistoryLog::Record) - 1;
+constexpr size_t kTypesPerHour = 3; // what the firmware persists
+
+// Record n of a test sequence; its fields all derive from n
+HistoryLog::Record MakeRecord(uint32_t n)
+{
+    return {n, (uint8_t)(n % 11), 0, (uint16_t)(n % 1000 + 1), (uint16_t)n, (uint16_t)(n - 7), (uint16_t)(n + 7), 0};
+}
+
+bool IsRecord(const HistoryLog::Record& record, uint32_t n)
+{
+    HistoryLog::Record expected = MakeRecord(n);
+    return record.hour == expected.hour && record.type == expected.type && record.count == expected.count &&
+           record.mean == expected.mean && record.min == expected.min && record.max == expected.max;
+}
+
+// Appends records first .. first + count - 1, batch at a time
+bool AppendRange(HistoryLog& log, uint32_t first, uint32_t count, uint32_t batch = kTypesPerHour)
+{
+    std::vector<HistoryLog::Record> records;
+    for (uint32_t n = first; n < first + count; n += batch) {
+        records.clear();
+        for (uint32_t i = n; i < first + count && i < n + batch; i++) {
+            records.push_back(MakeRecord(i));
+        }
+        if (!log.Append(records.data(), records.size())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<uint32_t> ReadHours(const HistoryLog& log)
+{
+    std::vector<uint32_t> hours;
+    log.ForEach([&](const HistoryLog::Record& record) { hours.push_back(record.hour); });
+    return hours;
+}
+
+// The log holds exactly records first .. first + count - 1, oldest first
+bool Holds(const HistoryLog& log, uint32_t first, uint32_t count)
+{
+    uint32_t next = first;
+    bool intact = true;
+    log.ForEach([&](const HistoryLog::Record& record) { intact = intact && IsRecord(record, next++); });
+    return CHECK(intact) && CHECK_EQ(next - first, count);
+}
+
+void NewPartition()
+{
+    esp_partition_host_create(kLabel, kSectors * kSectorSize);
+}
+
+void TestFormat()
+{
+    NewPartition();
+    HistoryLog log;
+    CHECK(log.Init(kLabel));
+    CHECK(log.IsReady());
+    CHECK_EQ(log.GetCapacity(), (kSectors - 1) * kRecordsPerSector);
+    CHECK(ReadHours(log).empty());
+    CHECK_EQ(log.GetSectorErases(), 1);
+    CHECK_EQ(log.GetBytesWritten(), sizeof(HistoryLog::Record)); // the header
+
+    // Formatted once: the next boot finds the header, erases nothing
+    HistoryLog rebooted;
+    CHECK(rebooted.Init(kLabel));
+    CHECK_EQ(rebooted.GetSectorErases(), 0);
+    CHECK(ReadHours(rebooted).empty());
+}
+
+void TestNoPartition()
+{
+    esp_partition_host_remove_all();
+    HistoryLog log;
+    CHECK(!log.Init(kLabel));
+    CHECK(!log.IsReady());
+    HistoryLog::Record record = MakeRecord(1);
+    CHECK(!log.Append(&record, 1));
+    CHECK_EQ(log.GetCapacity(), 0);
+
+    // Too small to hold a ring
+    esp_partition_host_create(kLabel, kSectorSize);
+    CHECK(!log.Init(kLabel));
+}
+
+// After a reboot the binary search finds the first free slot, whatever the
+// head sector's fill, and appending carries on there
+void TestRecovery()
+{
+    const uint32_t fills[] = {0, 1, 2, 127, kRecordsPerSector - 1, kRecordsPerSector, kRecordsPerSector + 1,
+                              3 * kRecordsPerSector + 100};
+    for (uint32_t fill : fills) {
+        NewPartition();
+        {
+            HistoryLog log;
+            log.Init(kLabel);
+            CHECK(AppendRange(log, 0, fill));
+        }
+        HistoryLog rebooted;
+        CHECK(rebooted.Init(kLabel));
+        if (!Holds(rebooted, 0, fill)) {
+            fprintf(stderr, "after %u records\n", (unsigned)fill);
+        }
+        CHECK(AppendRange(rebooted, fill, 5));
+        HistoryLog again;
+        again.Init(kLabel);
+        Holds(again, 0, fill + 5);
+    }
+}
+
+// A single batch can span sectors
+void TestBatchAcrossSectors()
+{
+    NewPartition();
+    HistoryLog log;
+    log.Init(kLabel);
+    CHECK(AppendRange(log, 0, kRecordsPerSector - 2));
+    CHECK(AppendRange(log, kRecordsPerSector - 2, 10, 10));
+    CHECK_EQ(log.GetSectorErases(), 2);
+    Holds(log, 0, kRecordsPerSector + 8);
+}
+
+// Around the ring one and a half times: the oldest sector is erased for each
+// new one, and the log keeps at least GetCapacity() of the newest records
+void TestWrap()
+{
+    NewPartition();
+    const uint32_t total = (kSectors + 10) * kRecordsPerSector + 40; // head at sequence 37
+    {
+        HistoryLog log;
+        log.Init(kLabel);
+        CHECK(AppendRange(log, 0, total));
+        CHECK_EQ(log.GetSectorErases(), kSectors + 11);
+    }
+    HistoryLog rebooted;
+    CHECK(rebooted.Init(kLabel));
+    std::vector<uint32_t> hours = ReadHours(rebooted);
+    CHECK(hours.size() >= rebooted.GetCapacity());
+    CHECK_EQ(hours.size(), (kSectors - 1) * kRecordsPerSector + 40);
+    Holds(rebooted, total - (uint32_t)hours.size(), (uint32_t)hours.size());
+
+    // And carries on from the head
+    CHECK(AppendRange(rebooted, total, 300));
+    HistoryLog again;
+    again.Init(kLabel);
+    hours = ReadHours(again);
+    CHECK(!hours.empty() && hours.back() == total + 299);
+    Holds(again, total + 300 - (uint32_t)hours.size(), (uint32_t)hours.size());
+}
+
+// A power cut while a record was being programmed leaves it partly written:
+// its CRC fails, it is skipped, and its slot is not reused
+void TestTornRecord()
+{
+    NewPartition();
+    {
+        HistoryLog log;
+        log.Init(kLabel);
+        AppendRange(log, 0, 30);
+    }
+    // Half of record 30 made it to flash
+    uint8_t* flash = esp_partition_host_data(kLabel);
+    HistoryLog::Record torn = MakeRecord(30);
+    memcpy(flash + (30 + 1) * sizeof(HistoryLog::Record), &torn, sizeof(torn) / 2);
+
+    HistoryLog rebooted;
+    CHECK(rebooted.Init(kLabel));
+    Holds(rebooted, 0, 30);
+    CHECK(AppendRange(rebooted, 31, 6));
+    std::vector<uint32_t> hours = ReadHours(rebooted);
+    CHECK_EQ(hours.size(), 36);
+    CHECK(hours.size() == 36 && hours[29] == 29 && hours[30] == 31 && hours.back() == 36);
+}
+
+// A bit flipped in a record or a sector header drops that record or sector,
+// nothing else
+void TestCorruption()
+{
+    NewPartition();
+    {
+        HistoryLog log;
+        log.Init(kLabel);
+        AppendRange(log, 0, 3 * kRecordsPerSector);
+    }
+    uint8_t* flash = esp_partition_host_data(kLabel);
+    flash[(10 + 1) * sizeof(HistoryLog::Record) + 8] ^= 0x01; // record 10's mean
+    flash[kSectorSize + 4] ^= 0x01;                           // sector 1's sequence
+
+    HistoryLog rebooted;
+    CHECK(rebooted.Init(kLabel));
+    std::vector<uint32_t> hours = ReadHours(rebooted);
+    CHECK_EQ(hours.size(), 2 * kRecordsPerSector - 1);
+    bool skipped = true;
+    for (uint32_t hour : hours) {
+        skipped = skipped && hour != 10 && (hour < kRecordsPerSector || hour >= 2 * kRecordsPerSector);
+    }
+    CHECK(skipped);
+}
+
+// Values keep the range MeasuredValues keeps: CO2 up to the sensors' 40000
+// ppm and beyond 32767, temperature below zero, both through a reboot
+void TestValueRange()
+{
+    using Type = Sensor::MeasurementType;
+    const int32_t co2[] = {0, 400, 32767, 32768, 40000, 65534};
+    for (int32_t value : co2) {
+        CHECK_EQ(HistoryLog::DecodeValue(Type::CO2, HistoryLog::EncodeValue(Type::CO2, value)), value);
+    }
+    CHECK_EQ(HistoryLog::EncodeValue(Type::CO2, 70000), 65534);
+    CHECK_EQ(HistoryLog::EncodeValue(Type::CO2, -5), 0);
+    CHECK_EQ(HistoryLog::DecodeValue(Type::CO2, HistoryLog::EncodeValue(Type::CO2, Sensor::kNoValue)),
+             Sensor::kNoValue);
+
+    const int32_t temperature[] = {-32767, -2000, -1, 0, 1, 5000, 32767}; // 1/200 °C
+    for (int32_t value : temperature) {
+        CHECK_EQ(HistoryLog::DecodeValue(Type::Temperature, HistoryLog::EncodeValue(Type::Temperature, value)),
+                 value);
+    }
+    CHECK_EQ(HistoryLog::DecodeValue(Type::Temperature, HistoryLog::EncodeValue(Type::Temperature, -40000)),
+             -32767);
+    CHECK_EQ(HistoryLog::DecodeValue(Type::Temperature, HistoryLog::EncodeValue(Type::Temperature, Sensor::kNoValue)),
+             Sensor::kNoValue);
+
+    NewPartition();
+    {
+        HistoryLog log;
+        log.Init(kLabel);
+        HistoryLog::Record records[] = {
+            {7, (uint8_t)Type::CO2, 0, 3600, HistoryLog::EncodeValue(Type::CO2, 38000),
+             HistoryLog::EncodeValue(Type::CO2, 33000), HistoryLog::EncodeValue(Type::CO2, 40000), 0},
+            {7, (uint8_t)Type::Temperature, 0, 3600, HistoryLog::EncodeValue(Type::Temperature, -2000),
+             HistoryLog::EncodeValue(Type::Temperature, -2400), HistoryLog::EncodeValue(Type::Temperature, 100), 0},
+        };
+        CHECK(log.Append(records, 2));
+    }
+    HistoryLog rebooted;
+    rebooted.Init(kLabel);
+    int restored = 0;
+    rebooted.ForEach([&](const HistoryLog::Record& record) {
+        auto type = static_cast<Type>(record.type);
+        int32_t mean = HistoryLog::DecodeValue(type, record.mean);
+        int32_t min = HistoryLog::DecodeValue(type, record.min);
+        int32_t max = HistoryLog::DecodeValue(type, record.max);
+        if (type == Type::CO2) {
+            CHECK_EQ(mean, 38000);
+            CHECK_EQ(min, 33000);
+            CHECK_EQ(max, 40000);
+        } else {
+            CHECK_EQ(mean, -2000);
+            CHECK_EQ(min, -2400);
+            CHECK_EQ(max, 100);
+        }
+        restored++;
+    });
+    CHECK_EQ(restored, 2);
+}
+
+// What a year of hourly appends of the persisted types costs: each append
+// is one write of 48 bytes, and the ring erases each sector every
+// kSectors * kRecordsPerSector / 3 hours (2210 h, 92 days)
+void TestWearBudget()
+{
+    NewPartition();
+    HistoryLog log;
+    log.Init(kLabel);
+    const uint32_t hours = 365 * 24;
+    for (uint32_t hour = 0; hour < hours; hour++) {
+        if (!CHECK(AppendRange(log, hour * kTypesPerHour, kTypesPerHour))) {
+            break;
+        }
+    }
+    uint32_t erases = log.GetSectorErases();
+    uint32_t sectorsStarted = (hours * kTypesPerHour + kRecordsPerSector - 1) / kRecordsPerSector;
+    CHECK_EQ(erases, sectorsStarted);
+    CHECK_EQ(log.GetBytesWritten(), (hours * kTypesPerHour + sectorsStarted) * sizeof(HistoryLog::Record));
+
+    double hoursPerSector = (double)kRecordsPerSector / kTypesPerHour;
+    double erasesPerSectorYear = (double)erases / kSectors;
+    printf("a year of hourly records: %u bytes written, %u sector erases, each sector erased every %.0f h "
+           "(%.0f days, %.1f times a year)\n",
+           (unsigned)log.GetBytesWritten(), (unsigned)erases, hoursPerSector * kSectors,
+           hoursPerSector * kSectors / 24, erasesPerSectorYear);
+    CHECK(erasesPerSectorYear > 3.5 && erasesPerSectorYear < 4.5);
+}
+
+} // namespace
+
+int main()
+{
+    TestFormat();
+    TestNoPartition();
+    TestRecovery();
+    TestBatchAcrossSectors();
+    TestWrap();
+    TestTornRecord();
+    TestCorruption();
+    TestValueRange();
+    TestWearBudget();
+    return HostCheck::ExitCode();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <stdint.h>
+#include <string.h>
+
+// Wall-clock timing for the host benchmarks. The figures are host
+// nanoseconds: meaningful as ratios between two implementations of the same
+// thing, not as ESP32-C6 cycle counts. ctest passes --quick, which cuts the
+// iteration counts to a smoke run.
+namespace HostBench {
+
+// Iterations to run: full when run by hand, a hundredth with --quick
+inline uint64_t Iterations(int argc, char** argv, uint64_t full)
+{
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            return full >= 100 ? full / 100 : 1;
+        }
+    }
+    return full;
+}
+
+// Keeps the optimiser from dropping a result the benchmark never reads
+template <typename T>
+inline void Keep(const T& value)
+{
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+// Best of five runs of fn(i) for i in [0, iterations), in ns per call
+template <typename Fn>
+double NsPerCall(uint64_t iterations, Fn fn)
+{
+    using Clock = std::chrono::steady_clock;
+    double best = 0;
+    for (int run = 0; run < 5; run++) {
+        Clock::time_point start = Clock::now();
+        for (uint64_t i = 0; i < iterations; i++) {
+            fn(i);
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+        if (run == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+} // namespace HostBench
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdio.h>
+
+// Minimal assertions for the host tests. A failed check prints the
+// expression and its line and the test carries on, so one run reports every
+// failure; main() returns HostCheck::ExitCode() for ctest.
+namespace HostCheck {
+
+inline int& Failures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+inline bool Report(bool ok, const char* file, int line, const char* expression)
+{
+    if (!ok) {
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+        Failures()++;
+    }
+    return ok;
+}
+
+inline bool ReportEqual(long long actual, long long expected, const char* file, int line, const char* expression)
+{
+    if (actual != expected) {
+        fprintf(stderr, "%s:%d: check failed: %s (got %lld, expected %lld)\n", file, line, expression, actual,
+                expected);
+        Failures()++;
+        return false;
+    }
+    return true;
+}
+
+inline int ExitCode()
+{
+    if (Failures() != 0) {
+        fprintf(stderr, "%d check(s) failed\n", Failures());
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace HostCheck
+
+#define CHECK(expression) HostCheck::Report((expression), __FILE__, __LINE__, #expression)
+#define CHECK_EQ(actual, expected) \
+    HostCheck::ReportEqual((long long)(actual), (long long)(expected), __FILE__, __LINE__, #actual " == " #expected)
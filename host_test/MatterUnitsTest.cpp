@@ -0,0 +1,131 @@
+// Native steps into Matter attribute units and back, and the air-quality
+// level the endpoint derives from the same published values.
+
+#include "AirQualityIndex.h"
+#include "HostCheck.h"
+#include "MatterUnits.h"
+#include "MeasurementStore.h"
+
+#include <cmath>
+
+namespace {
+
+using Type = Sensor::MeasurementType;
+using Level = AirQualityIndex::Level;
+
+constexpr int32_t kNoValue = MeasurementStore::kNoValue;
+
+// Humidity is native in 0.01 %RH, the attribute's own unit: identity over
+// the whole 0-100 % range
+void TestRelativeHumidity()
+{
+    for (int32_t native = 0; native <= 10000; native++) {
+        std::optional<uint16_t> reported = MatterUnits::RelativeHumidity(native);
+        if (!CHECK(reported.has_value()) || !CHECK_EQ(*reported, native)) {
+            return;
+        }
+    }
+    CHECK(!MatterUnits::RelativeHumidity(kNoValue).has_value());
+}
+
+// Temperature is native in 1/200 °C, reported in 0.01 °C: half away from
+// zero, and back to within one native step
+void TestTemperature()
+{
+    for (int32_t native = -40 * 200; native <= 125 * 200; native++) {
+        std::optional<int16_t> reported = MatterUnits::Temperature(native);
+        if (!CHECK(reported.has_value())) {
+            return;
+        }
+        int32_t expected = native >= 0 ? (native + 1) / 2 : -((-native + 1) / 2);
+        if (!CHECK_EQ(*reported, expected) || !CHECK(std::abs(*reported * 2 - native) <= 1)) {
+            return;
+        }
+    }
+    CHECK_EQ(*MatterUnits::Temperature(4410), 2205);  // 22.05 °C
+    CHECK_EQ(*MatterUnits::Temperature(-1), -1);      // -0.005 °C rounds away from zero
+    CHECK(!MatterUnits::Temperature(kNoValue).has_value());
+}
+
+// The concentrations are floats in the cluster's unit; a float holds every
+// native value exactly enough to get the same step back
+void TestConcentrations()
+{
+    const Type tenths[] = {Type::PM1p0, Type::PM2p5, Type::PM4p0, Type::PM10p0, Type::VOC, Type::NOx};
+    for (Type type : tenths) {
+        for (int32_t native = 0; native <= 10000; native++) {
+            std::optional<float> reported = MatterUnits::Concentration(type, native);
+            if (!CHECK(reported.has_value()) || !CHECK_EQ(lroundf(*reported * 10), native)) {
+                return;
+            }
+        }
+        CHECK(!MatterUnits::Concentration(type, kNoValue).has_value());
+    }
+    CHECK(*MatterUnits::Concentration(Type::PM2p5, 45) == 4.5f);
+
+    // CO2 is whole ppm over the SEN66's full 0-40000 ppm range
+    for (int32_t native = 0; native <= 40000; native++) {
+        std::optional<float> reported = MatterUnits::Concentration(Type::CO2, native);
+        if (!CHECK(reported.has_value()) || !CHECK(*reported == (float)native)) {
+            return;
+        }
+    }
+    CHECK(!MatterUnits::Concentration(Type::CO2, kNoValue).has_value());
+}
+
+// CO2 thresholds, including the missing reading and the sub-outdoor floor
+void TestCO2Levels()
+{
+    CHECK(AirQualityIndex::ByCO2(kNoValue) == Level::Unknown);
+    CHECK(AirQualityIndex::ByCO2(0) == Level::Unknown);
+    CHECK(AirQualityIndex::ByCO2(399) == Level::Unknown);
+    CHECK(AirQualityIndex::ByCO2(400) == Level::Good);
+    CHECK(AirQualityIndex::ByCO2(600) == Level::Good);
+    CHECK(AirQualityIndex::ByCO2(601) == Level::Fair);
+    CHECK(AirQualityIndex::ByCO2(700) == Level::Fair);
+    CHECK(AirQualityIndex::ByCO2(701) == Level::Moderate);
+    CHECK(AirQualityIndex::ByCO2(950) == Level::Poor);
+    CHECK(AirQualityIndex::ByCO2(1200) == Level::VeryPoor);
+    CHECK(AirQualityIndex::ByCO2(40000) == Level::ExtremelyPoor);
+}
+
+// PM thresholds are in µg/m³, compared in native tenths
+void TestPMLevels()
+{
+    CHECK(AirQualityIndex::ByPM25(kNoValue, 0) == Level::Unknown);
+    CHECK(AirQualityIndex::ByPM25(10, -1) == Level::Unknown);
+    CHECK(AirQualityIndex::ByPM25(10, 150) == Level::Good);
+    CHECK(AirQualityIndex::ByPM25(10, 151) == Level::Fair);
+    CHECK(AirQualityIndex::ByPM25(10, 1501) == Level::ExtremelyPoor);
+    CHECK(AirQualityIndex::ByPM10(kNoValue, 0) == Level::Unknown);
+    CHECK(AirQualityIndex::ByPM10(10, 300) == Level::Good);
+    CHECK(AirQualityIndex::ByPM10(10, 301) == Level::Fair);
+    CHECK(AirQualityIndex::ByPM10(10, 4001) == Level::ExtremelyPoor);
+}
+
+// The overall level is the worst known one; nothing published is Unknown
+void TestClassify()
+{
+    MeasurementStore::Published published;
+    CHECK(AirQualityIndex::Classify(published) == Level::Unknown);
+
+    published.latest[Measurements::SlotOf(Type::CO2)] = 650;
+    CHECK(AirQualityIndex::Classify(published) == Level::Fair);
+
+    published.latest[Measurements::SlotOf(Type::PM2p5)] = 120;
+    published.averages[Measurements::SlotOf(Type::PM2p5)] = 600; // 60 µg/m³
+    CHECK(AirQualityIndex::Classify(published) == Level::Poor);
+}
+
+} // namespace
+
+int main()
+{
+    TestRelativeHumidity();
+    TestTemperature();
+    TestConcentrations();
+    TestCO2Levels();
+    TestPMLevels();
+    TestClassify();
+    return HostCheck::ExitCode();
+}
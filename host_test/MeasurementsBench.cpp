@@ -0,0 +1,139 @@
+// One report pass over the Measurements store: the std::map keyed by Matter
+// cluster ID it used to be, with GetIds() building a vector each time,
+// against today's flat array indexed by measurement type. A pass adds the
+// report's eight values and reads latest, average and peak of each, as the
+// Matter update does. Both wrap today's MeasuredValues, so only the
+// container differs.
+
+#include "AllocationProbe.h"
+#include "HostBench.h"
+#include "HostCheck.h"
+#include "Measurements.h"
+
+#include <map>
+#include <stdio.h>
+#include <vector>
+
+namespace {
+
+using Type = Sensor::MeasurementType;
+
+struct Metric {
+    Type type;
+    uint32_t clusterId;
+};
+
+const Metric kMetrics[] = {
+    {Type::RelativeHumidity, 0x0405}, {Type::Temperature, 0x0402}, {Type::CO2, 0x040D},
+    {Type::NOx, 0x0413},              {Type::VOC, 0x042E},         {Type::PM1p0, 0x042C},
+    {Type::PM2p5, 0x042A},            {Type::PM10p0, 0x042D},
+};
+
+constexpr uint32_t kWindowSec = 3600;
+constexpr int64_t kReportUs = 10 * 1000000;
+
+// The store as it was: a tree lookup per access, unchecked
+class MapMeasurements
+{
+public:
+    void AddId(uint32_t id, Type type)
+    {
+        m_measurements.emplace(id, MeasuredValues(id, Sensor::IsSigned(type), kWindowSec, kWindowSec,
+                                                  Measurements::kMinSamplePeriodSeconds));
+    }
+
+    void AddMeasurement(uint32_t id, int32_t value, int32_t low, int32_t peak, int64_t timestampUs)
+    {
+        m_measurements.find(id)->second.Add(value, low, peak, timestampUs);
+    }
+
+    int32_t GetLatest(uint32_t id) { return m_measurements.find(id)->second.GetLatest(); }
+    int32_t GetAverage(uint32_t id) { return m_measurements.find(id)->second.GetAverage(); }
+    int32_t GetPeak(uint32_t id) { return m_measurements.find(id)->second.GetPeak(); }
+
+    std::vector<uint32_t> GetIds() const
+    {
+        std::vector<uint32_t> ids;
+        ids.reserve(m_measurements.size());
+        for (const auto& entry : m_measurements) {
+            ids.push_back(entry.first);
+        }
+        return ids;
+    }
+
+private:
+    std::map<uint32_t, MeasuredValues> m_measurements;
+};
+
+int32_t Value(uint64_t pass, size_t metric)
+{
+    return 400 + (int32_t)((pass * 7 + metric * 13) % 50);
+}
+
+int64_t MapPass(MapMeasurements& store, uint64_t pass)
+{
+    for (size_t m = 0; m < sizeof(kMetrics) / sizeof(kMetrics[0]); m++) {
+        int32_t value = Value(pass, m);
+        store.AddMeasurement(kMetrics[m].clusterId, value, value - 10, value + 20, (int64_t)pass * kReportUs);
+    }
+    int64_t sum = 0;
+    for (uint32_t id : store.GetIds()) {
+        sum += store.GetLatest(id) + store.GetAverage(id) + store.GetPeak(id);
+    }
+    return sum;
+}
+
+int64_t FlatPass(Measurements& store, uint64_t pass)
+{
+    for (size_t m = 0; m < sizeof(kMetrics) / sizeof(kMetrics[0]); m++) {
+        int32_t value = Value(pass, m);
+        store.AddMeasurement(kMetrics[m].type, value, value - 10, value + 20, (int64_t)pass * kReportUs);
+    }
+    int64_t sum = 0;
+    store.ForEachType([&](Type type) { sum += store.GetLatest(type) + store.GetAverage(type) + store.GetPeak(type); });
+    return sum;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const uint64_t iterations = HostBench::Iterations(argc, argv, 200000);
+
+    MapMeasurements mapStore;
+    Measurements flatStore;
+    for (const Metric& metric : kMetrics) {
+        mapStore.AddId(metric.clusterId, metric.type);
+        flatStore.AddType(metric.type, kWindowSec, kWindowSec);
+    }
+
+    // Fill both windows; every pass must read the same values
+    uint64_t pass = 0;
+    for (; pass < 2 * kWindowSec / 10; pass++) {
+        if (!CHECK_EQ(MapPass(mapStore, pass), FlatPass(flatStore, pass))) {
+            break;
+        }
+    }
+
+    AllocationProbe::Begin();
+    MapPass(mapStore, pass);
+    uint32_t mapAllocations = AllocationProbe::End();
+    AllocationProbe::Begin();
+    FlatPass(flatStore, pass);
+    uint32_t flatAllocations = AllocationProbe::End();
+    pass++;
+
+    uint64_t next = pass;
+    double mapNs = HostBench::NsPerCall(iterations, [&](uint64_t) { HostBench::Keep(MapPass(mapStore, next++)); });
+    next = pass;
+    double flatNs =
+        HostBench::NsPerCall(iterations, [&](uint64_t) { HostBench::Keep(FlatPass(flatStore, next++)); });
+
+    printf("%-24s %12s %12s\n", "report pass", "ns/pass", "allocations");
+    printf("%-24s %12.1f %12u\n", "std::map by cluster ID", mapNs, (unsigned)mapAllocations);
+    printf("%-24s %12.1f %12u\n", "flat, by type", flatNs, (unsigned)flatAllocations);
+
+    CHECK_EQ(mapAllocations, 1); // GetIds()
+    CHECK_EQ(flatAllocations, 0);
+    return HostCheck::ExitCode();
+}
@@ -0,0 +1,212 @@
+// Sketch percentiles against exact nearest-rank percentiles of the same
+// samples: p50/p95/p99 within relativeError on uniform and heavy-tailed
+// (Pareto) data in the firmware's CO2 and PM2.5 configurations, values below
+// minValue reported as minValue / 2, values at or above maxValue clamped to
+// it, and the window's start after the slot ring has rotated.
+
+#include "HostCheck.h"
+#include "QuantileSketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdio.h>
+#include <vector>
+
+namespace {
+
+struct Lcg {
+    uint32_t state = 777;
+
+    // Uniform in [0, 1)
+    double operator()()
+    {
+        state = state * 1664525u + 1013904223u;
+        return (state >> 8) / 16777216.0;
+    }
+};
+
+// The configurations SetUpMeasurementStore() tracks, in native steps
+struct Config {
+    const char* name;
+    int32_t minValue;
+    int32_t maxValue;
+    float relativeError;
+};
+const Config kCo2 = {"CO2", 100, 10000, 0.03f};
+const Config kPm25 = {"PM2.5", 10, 10000, 0.05f};
+
+constexpr uint32_t kDay = 86400;
+constexpr int64_t kSecondUs = 1000000;
+
+// Nearest rank: the smallest sample with at least q of the samples at or
+// below it
+int32_t NearestRank(std::vector<int32_t> samples, float q)
+{
+    std::sort(samples.begin(), samples.end());
+    size_t rank = (size_t)ceilf(q * samples.size());
+    return samples[std::max<size_t>(rank, 1) - 1];
+}
+
+// The documented bound for one percentile
+bool WithinBound(const Config& config, float estimate, int32_t exact)
+{
+    const float slack = 1e-4f; // float rounding in the reported value
+    float error = config.relativeError + slack;
+    if (exact < config.minValue) {
+        return estimate == config.minValue / 2.0f;
+    }
+    if (exact > config.maxValue) {
+        // Clamped: maxValue, or the bin holding it when that reports below
+        return estimate <= config.maxValue && estimate >= config.maxValue * (1 - error);
+    }
+    return fabsf(estimate - exact) <= error * exact;
+}
+
+bool Compare(const Config& config, const char* data, const QuantileSketch::Percentiles& percentiles,
+             const std::vector<int32_t>& samples)
+{
+    const float kQuantiles[] = {0.50f, 0.95f, 0.99f};
+    const float estimates[] = {percentiles.p50, percentiles.p95, percentiles.p99};
+    bool ok = CHECK_EQ(percentiles.count, samples.size());
+    for (int i = 0; i < 3; i++) {
+        int32_t exact = NearestRank(samples, kQuantiles[i]);
+        if (!CHECK(WithinBound(config, estimates[i], exact))) {
+            fprintf(stderr, "%s %s p%d: sketch %.1f, exact %d\n", config.name, data, (int)(kQuantiles[i] * 100),
+                    estimates[i], (int)exact);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// A day of samples every 10 s in one sketch, checked as it fills
+template <typename Draw>
+void TestDistribution(const Config& config, const char* data, Draw draw)
+{
+    QuantileSketch sketch(config.minValue, config.maxValue, config.relativeError, kDay);
+    std::vector<int32_t> samples;
+    for (uint32_t seconds = 0; seconds < kDay; seconds += 10) {
+        int32_t value = draw();
+        sketch.Add(value, seconds * kSecondUs);
+        samples.push_back(value);
+        bool powerOfTwo = (samples.size() & (samples.size() - 1)) == 0;
+        if (powerOfTwo && !Compare(config, data, sketch.GetPercentiles(kDay), samples)) {
+            return;
+        }
+    }
+    QuantileSketch::Percentiles percentiles = sketch.GetPercentiles(kDay);
+    if (Compare(config, data, percentiles, samples)) {
+        printf("%-5s %-12s p50 %7.1f (exact %5d)  p95 %7.1f (exact %5d)  p99 %7.1f (exact %5d)\n", config.name,
+               data, percentiles.p50, (int)NearestRank(samples, 0.50f), percentiles.p95,
+               (int)NearestRank(samples, 0.95f), percentiles.p99, (int)NearestRank(samples, 0.99f));
+    }
+}
+
+void TestRandomData()
+{
+    Lcg random;
+    TestDistribution(kCo2, "uniform", [&] { return 400 + (int32_t)(random() * 2600); });
+    TestDistribution(kPm25, "uniform", [&] { return (int32_t)(random() * 1500); });
+
+    // Pareto, alpha 1.2: a long tail running past maxValue
+    TestDistribution(kCo2, "heavy-tailed", [&] { return (int32_t)(420 * pow(1 - random(), -1 / 1.2)); });
+    TestDistribution(kPm25, "heavy-tailed", [&] { return (int32_t)(30 * pow(1 - random(), -1 / 1.2)); });
+}
+
+// Every integer from 0 to past the clamp, one at a time: each is reported
+// within the bound for its range
+void TestEveryValue()
+{
+    for (const Config& config : {kCo2, kPm25}) {
+        QuantileSketch bins(config.minValue, config.maxValue, config.relativeError, 3600);
+        int failures = 0;
+        float lastEstimate = 0;
+        for (int32_t value = 0; value <= 3 * config.maxValue && failures < 5; value++) {
+            QuantileSketch sketch(config.minValue, config.maxValue, config.relativeError, 3600);
+            sketch.Add(value, 0);
+            float estimate = sketch.GetPercentiles(3600).p50;
+            if (!CHECK(WithinBound(config, estimate, value))) {
+                fprintf(stderr, "%s %d reported as %.2f\n", config.name, (int)value, estimate);
+                failures++;
+            }
+            // Bins never report out of order
+            CHECK(estimate >= lastEstimate);
+            lastEstimate = estimate;
+        }
+        // Below minValue: minValue / 2, whose error is at most minValue / 2
+        QuantileSketch low(config.minValue, config.maxValue, config.relativeError, 3600);
+        low.Add(0, 0);
+        low.Add(config.minValue - 1, 0);
+        CHECK_EQ(low.GetPercentiles(3600).p99, config.minValue / 2.0f);
+        // Far past maxValue: maxValue
+        QuantileSketch high(config.minValue, config.maxValue, config.relativeError, 3600);
+        high.Add(INT32_MAX, 0);
+        CHECK_EQ(high.GetPercentiles(3600).p50, (float)config.maxValue);
+        printf("%-5s every value 0..%d within %.0f%% (%u bytes)\n", config.name, (int)(3 * config.maxValue),
+               config.relativeError * 100, (unsigned)bins.GetMemorySize());
+    }
+}
+
+// Nothing added: no count, NAN percentiles
+void TestEmpty()
+{
+    QuantileSketch sketch(kCo2.minValue, kCo2.maxValue, kCo2.relativeError, kDay);
+    QuantileSketch::Percentiles percentiles = sketch.GetPercentiles(kDay);
+    CHECK_EQ(percentiles.count, 0);
+    CHECK(std::isnan(percentiles.p50));
+}
+
+// An 8 h sketch in 1 h slots fed for 40 hours with a pause of 20, each hour
+// at its own level: a window covers the slots overlapping it, never a slot
+// from before the ring's last rotation
+void TestWindowEdge()
+{
+    const uint32_t kHour = 3600;
+    const uint32_t kMaxWindow = 8 * kHour;
+    QuantileSketch sketch(kCo2.minValue, kCo2.maxValue, kCo2.relativeError, kMaxWindow);
+    struct Sample {
+        uint32_t seconds;
+        int32_t value;
+    };
+    std::vector<Sample> added;
+    const uint32_t kWindows[] = {1, kHour, kHour + 1, 3 * kHour + 600, kMaxWindow, 2 * kMaxWindow};
+
+    for (uint32_t seconds = 0; seconds < 60 * kHour; seconds += 60) {
+        uint32_t hour = seconds / kHour;
+        if (hour >= 25 && hour < 45) {
+            continue; // the pause: longer than the ring, so every slot is stale after it
+        }
+        int32_t value = 400 + (int32_t)(hour % 12) * 300 + (int32_t)(seconds / 60 % 7);
+        sketch.Add(value, seconds * kSecondUs);
+        added.push_back({seconds, value});
+        if (seconds % 1800 != 0) {
+            continue;
+        }
+        for (uint32_t window : kWindows) {
+            // The slots overlapping (newest - window, newest], at most the ring's
+            uint32_t slots = std::min((window + kHour - 1) / kHour + 1, kMaxWindow / kHour + 1);
+            std::vector<int32_t> inWindow;
+            for (const Sample& sample : added) {
+                if (hour - sample.seconds / kHour < slots) {
+                    inWindow.push_back(sample.value);
+                }
+            }
+            char data[32];
+            snprintf(data, sizeof(data), "%u s at %u h", (unsigned)window, (unsigned)hour);
+            if (!Compare(kCo2, data, sketch.GetPercentiles(window), inWindow)) {
+                return;
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    TestEmpty();
+    TestRandomData();
+    TestEveryValue();
+    TestWindowEdge();
+    return HostCheck::ExitCode();
+}
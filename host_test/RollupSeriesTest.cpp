@@ -0,0 +1,252 @@
+// The minute/hour/day cascade against a brute-force aggregate of every sample
+// over a synthetic ten-day trace: Query() for windows on each tier and at
+// the tier boundaries, including the cell the window's start cuts (taken
+// whole), the newest closed cell of each tier as periods roll over, and
+// hours replayed with AddCell() followed by live samples.
+
+#include "HostCheck.h"
+#include "RollupSeries.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kPeriodSeconds[RollupSeries::kTierCount] = {60, 3600, 86400};
+constexpr uint32_t kSpanSeconds[RollupSeries::kTierCount] = {3600, 48 * 3600, RollupSeries::kMaxWindowSeconds};
+
+// A sample, or a whole cell replayed into a tier
+struct Item {
+    uint32_t seconds;
+    int tier; // the tier it entered: finer tiers never see it
+    int64_t sum;
+    uint32_t count;
+    int32_t min;
+    int32_t max;
+};
+
+// Every item ever added, aggregated the way Query() promises to: the cells
+// of the coarsest tier needed whose period ends after the window's start
+class BruteForce
+{
+public:
+    void Add(int32_t value, int32_t low, int32_t high, uint32_t seconds)
+    {
+        m_items.push_back({seconds, RollupSeries::kMinute, value, 1, low, high});
+        m_newest = std::max(m_newest, seconds);
+    }
+
+    void AddCell(RollupSeries::Tier tier, uint32_t seconds, const RollupSeries::Summary& summary)
+    {
+        m_items.push_back({seconds, tier, (int64_t)summary.mean * summary.count, summary.count, summary.min,
+                           summary.max});
+        m_newest = std::max(m_newest, seconds);
+    }
+
+    RollupSeries::Summary Query(uint32_t windowSeconds) const
+    {
+        int tier = RollupSeries::kMinute;
+        while (tier + 1 < RollupSeries::kTierCount && kSpanSeconds[tier] < windowSeconds) {
+            tier++;
+        }
+        uint32_t cutoff = m_newest > windowSeconds ? m_newest - windowSeconds : 0;
+        uint32_t period = kPeriodSeconds[tier];
+        return Aggregate([&](const Item& item) {
+            return item.tier <= tier && item.seconds - item.seconds % period + period > cutoff;
+        });
+    }
+
+    // The tier's cell starting at start
+    RollupSeries::Summary Cell(int tier, uint32_t start) const
+    {
+        uint32_t period = kPeriodSeconds[tier];
+        return Aggregate([&](const Item& item) {
+            return item.tier <= tier && item.seconds - item.seconds % period == start;
+        });
+    }
+
+private:
+    template <typename Filter>
+    RollupSeries::Summary Aggregate(Filter filter) const
+    {
+        int64_t sum = 0;
+        uint32_t count = 0;
+        int32_t min = INT32_MAX;
+        int32_t max = INT32_MIN;
+        for (const Item& item : m_items) {
+            if (item.count > 0 && filter(item)) {
+                sum += item.sum;
+                count += item.count;
+                min = std::min(min, item.min);
+                max = std::max(max, item.max);
+            }
+        }
+        if (count == 0) {
+            return {Sensor::kNoValue, Sensor::kNoValue, Sensor::kNoValue, 0};
+        }
+        int64_t half = count / 2;
+        return {(int32_t)((sum + (sum >= 0 ? half : -half)) / count), min, max, count};
+    }
+
+    std::vector<Item> m_items;
+    uint32_t m_newest = 0;
+};
+
+bool Same(const RollupSeries::Summary& actual, const RollupSeries::Summary& expected, const char* what,
+          uint32_t at, uint32_t window)
+{
+    bool same = actual.count == expected.count && actual.mean == expected.mean && actual.min == expected.min &&
+                actual.max == expected.max;
+    if (!CHECK(same)) {
+        fprintf(stderr, "%s at %u s, window %u s: got %d/%d/%d n=%u, expected %d/%d/%d n=%u\n", what,
+                (unsigned)at, (unsigned)window, (int)actual.mean, (int)actual.min, (int)actual.max,
+                (unsigned)actual.count, (int)expected.mean, (int)expected.min, (int)expected.max,
+                (unsigned)expected.count);
+    }
+    return same;
+}
+
+// Windows on every tier, on and just past each tier's span, and unaligned
+const uint32_t kWindows[] = {1, 59, 60, 61, 600, 3599, 3600, 3601, 6 * 3600 + 17, 24 * 3600, 48 * 3600,
+                             48 * 3600 + 1, 7 * 86400, 31 * 86400, 40 * 86400};
+
+struct Lcg {
+    uint32_t state = 2024;
+
+    uint32_t operator()(uint32_t range)
+    {
+        state = state * 1664525u + 1013904223u;
+        return (state >> 8) % range;
+    }
+};
+
+// Ten days of samples every 30 s on average, with pauses of minutes, hours
+// and once two days, values crossing zero
+void TestTrace()
+{
+    RollupSeries series;
+    BruteForce reference;
+    Lcg random;
+    uint32_t seconds = 1000;
+    uint32_t nextQuery = 0;
+    uint32_t lastClosed[RollupSeries::kTierCount] = {};
+    int closings[RollupSeries::kTierCount] = {};
+    int failures = 0;
+    bool paused = false;
+
+    while (seconds < 10 * 86400 && failures < 5) {
+        int32_t value = (int32_t)random(10000) - 2000;
+        int32_t low = value - (int32_t)random(300);
+        int32_t high = value + (int32_t)random(300);
+        series.Add(value, low, high, (int64_t)seconds * 1000000);
+        reference.Add(value, low, high, seconds);
+
+        // A newly closed cell holds exactly its period's samples
+        for (int tier = 0; tier < RollupSeries::kTierCount; tier++) {
+            uint32_t start;
+            RollupSeries::Summary closed;
+            if (series.GetNewestClosed((RollupSeries::Tier)tier, start, closed) &&
+                (closings[tier] == 0 || start != lastClosed[tier])) {
+                CHECK_EQ(start % kPeriodSeconds[tier], 0);
+                CHECK(start + kPeriodSeconds[tier] <= seconds);
+                failures += !Same(closed, reference.Cell(tier, start), "newest closed", seconds, tier);
+                lastClosed[tier] = start;
+                closings[tier]++;
+            }
+        }
+
+        if (seconds >= nextQuery) {
+            for (uint32_t window : kWindows) {
+                failures += !Same(series.Query(window), reference.Query(window), "query", seconds, window);
+            }
+            nextQuery = seconds + 7200 + random(600);
+        }
+
+        uint32_t step = 20 + random(21);
+        uint32_t pause = random(10000);
+        if (!paused && seconds > 4 * 86400) {
+            step = 2 * 86400; // longer than the hour tier's span
+            paused = true;
+        } else if (pause < 3) {
+            step = 3600 + random(7200);
+        } else if (pause < 200) {
+            step = 120 + random(600);
+        }
+        seconds += step;
+    }
+    CHECK(closings[RollupSeries::kMinute] > 5000);
+    CHECK(closings[RollupSeries::kHour] > 150);
+    CHECK(closings[RollupSeries::kDay] >= 8);
+    CHECK(series.GetCellCount() <= 61 + 49 + 32);
+}
+
+// Nothing added: empty summaries, no closed cells
+void TestEmpty()
+{
+    RollupSeries series;
+    RollupSeries::Summary summary = series.Query(3600);
+    CHECK_EQ(summary.count, 0);
+    CHECK_EQ(summary.mean, Sensor::kNoValue);
+    uint32_t start;
+    CHECK(!series.GetNewestClosed(RollupSeries::kHour, start, summary));
+    CHECK_EQ(series.GetCellCount(), 0);
+}
+
+// Hours saved before a reboot replayed with AddCell(), then live samples
+// from the next hour on: the hours count in the hour and day tiers (not the
+// minute tier), roll into days, and the last one closes when the first live
+// minute does
+void TestReplayThenLive()
+{
+    RollupSeries series;
+    BruteForce reference;
+    Lcg random;
+    const uint32_t replayedHours = 60;
+    for (uint32_t hour = 0; hour < replayedHours; hour++) {
+        int32_t mean = 400 + (int32_t)random(2000);
+        RollupSeries::Summary cell = {mean, mean - (int32_t)random(200), mean + (int32_t)random(900),
+                                      1 + random(3600)};
+        series.AddCell(RollupSeries::kHour, hour * 3600, cell);
+        reference.AddCell(RollupSeries::kHour, hour * 3600, cell);
+    }
+    uint32_t now = (replayedHours - 1) * 3600;
+    for (uint32_t window : kWindows) {
+        Same(series.Query(window), reference.Query(window), "replayed", now, window);
+    }
+
+    uint32_t start;
+    RollupSeries::Summary closed;
+    CHECK(series.GetNewestClosed(RollupSeries::kHour, start, closed));
+    CHECK_EQ(start, (replayedHours - 2) * 3600); // the last replayed hour is still open
+    CHECK(series.GetNewestClosed(RollupSeries::kDay, start, closed));
+    CHECK_EQ(start, 86400);
+    Same(closed, reference.Cell(RollupSeries::kDay, 86400), "replayed day", now, 86400);
+
+    // Live samples from the next hour on, every 10 s for a day and a half
+    for (uint32_t seconds = replayedHours * 3600; seconds < replayedHours * 3600 + 36 * 3600; seconds += 10) {
+        int32_t value = 400 + (int32_t)random(3000);
+        series.Add(value, (int64_t)seconds * 1000000);
+        reference.Add(value, value, value, seconds);
+        if (seconds == replayedHours * 3600 || seconds == replayedHours * 3600 + 60) {
+            CHECK(series.GetNewestClosed(RollupSeries::kHour, start, closed));
+            CHECK_EQ(start, (replayedHours - (seconds % 3600 == 0 ? 2 : 1)) * 3600);
+            Same(closed, reference.Cell(RollupSeries::kHour, start), "last replayed hour", seconds, 3600);
+        }
+        if (seconds % 3000 == 0) {
+            for (uint32_t window : kWindows) {
+                Same(series.Query(window), reference.Query(window), "replayed then live", seconds, window);
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    TestEmpty();
+    TestTrace();
+    TestReplayThenLive();
+    return HostCheck::ExitCode();
+}
@@ -0,0 +1,234 @@
+// The Sensirion drivers and sensor classes against the emulated SEN66 and
+// SCD30: the measurement lifecycle with its timing on the virtual clock, and
+// the failure paths (injected timeouts, an unplugged sensor).
+
+#include "HostCheck.h"
+#include "SensirionSEN66.h"
+#include "scd30_i2c.h"
+#include "sen66_i2c.h"
+#include "sensirion_common.h"
+#include "sensirion_i2c.h"
+#include "sensirion_i2c_hal.h"
+#include "sensirion_i2c_hal_emulator.h"
+
+#include <nvs.h>
+
+namespace {
+
+using Type = Sensor::MeasurementType;
+
+constexpr uint8_t kBus = 0;
+constexpr uint64_t kMs = 1000;
+
+// Three measurement intervals; the second has CO2 past the int16_t range
+const sensirion_emu_sample_t kTrace[] = {
+    {30, 41, 47, 50, 4512, 4410, 1000, 10, 612},
+    {35, 52, 60, 63, 4620, 4398, 1010, 10, 40000},
+    {28, 39, 44, 47, 4701, 4385, 1020, 20, 805},
+};
+
+// Virtual time one call takes
+template <typename Fn>
+uint64_t Elapsed(Fn fn)
+{
+    uint64_t start = sensirion_emu_now_us();
+    fn();
+    return sensirion_emu_now_us() - start;
+}
+
+void AddSen66()
+{
+    sensirion_emu_reset();
+    nvs_host_erase_all();
+    CHECK_EQ(sensirion_emu_add_sen66(kBus, SEN66_I2C_ADDR_6B), 0);
+    sensirion_emu_set_trace(kBus, SEN66_I2C_ADDR_6B, kTrace, 3);
+    CHECK_EQ(sensirion_i2c_hal_select_bus(kBus), NO_ERROR);
+}
+
+struct Reading {
+    uint16_t pm[4];
+    int16_t humidity, temperature, voc, nox;
+    uint16_t co2;
+};
+
+int16_t ReadSen66(Reading& r)
+{
+    return sen66_read_measured_values_as_integers(&r.pm[0], &r.pm[1], &r.pm[2], &r.pm[3], &r.humidity,
+                                                  &r.temperature, &r.voc, &r.nox, &r.co2);
+}
+
+bool DataReady()
+{
+    uint8_t padding;
+    bool ready = false;
+    CHECK_EQ(sen66_get_data_ready(&padding, &ready), NO_ERROR);
+    return ready;
+}
+
+// start -> data ready -> read -> stop -> reset, with the documented
+// execution times
+void TestSen66Lifecycle()
+{
+    AddSen66();
+    CHECK_EQ(sen66_init(0x69), NOT_IMPLEMENTED_ERROR);
+    CHECK_EQ(sen66_init(SEN66_I2C_ADDR_6B), NO_ERROR);
+
+    uint64_t startedAt = sensirion_emu_now_us();
+    CHECK(Elapsed([] { CHECK_EQ(sen66_start_continuous_measurement(), NO_ERROR); }) >= 50 * kMs);
+    CHECK(!DataReady());
+
+    // First interval: ready, read, then not ready until the next one
+    sensirion_emu_advance_us(startedAt + 1000 * kMs - sensirion_emu_now_us());
+    CHECK(DataReady());
+    Reading r = {};
+    CHECK(Elapsed([&] { CHECK_EQ(ReadSen66(r), NO_ERROR); }) >= 20 * kMs);
+    CHECK_EQ(r.pm[1], 41);
+    CHECK_EQ(r.temperature, 4410);
+    CHECK_EQ(r.co2, 612);
+    CHECK(!DataReady());
+
+    // A second read in the next interval gets the next sample, all of it
+    sensirion_emu_advance_us(1000 * kMs);
+    CHECK(DataReady());
+    CHECK_EQ(ReadSen66(r), NO_ERROR);
+    CHECK_EQ(r.pm[1], 52);
+    CHECK_EQ(r.humidity, 4620);
+    CHECK_EQ(r.co2, 40000);
+
+    // Stop takes 1.4 s; reading while idle is refused
+    CHECK(Elapsed([] { CHECK_EQ(sen66_stop_measurement(), NO_ERROR); }) >= 1400 * kMs);
+    CHECK(ReadSen66(r) != NO_ERROR);
+
+    // A reset takes 1.2 s and leaves the sensor idle with defaults
+    CHECK(Elapsed([] { CHECK_EQ(sen66_device_reset(), NO_ERROR); }) >= 1200 * kMs);
+    uint16_t altitude = 1;
+    CHECK_EQ(sen66_get_sensor_altitude(&altitude), NO_ERROR);
+    CHECK_EQ(altitude, 0);
+    CHECK_EQ(sen66_start_continuous_measurement(), NO_ERROR);
+}
+
+// A device that stops answering mid-transaction costs the HAL timeout on
+// every attempt, then the command fails; the next command goes through
+void TestInjectedTimeouts()
+{
+    AddSen66();
+    CHECK_EQ(sen66_init(SEN66_I2C_ADDR_6B), NO_ERROR);
+    CHECK_EQ(sen66_start_continuous_measurement(), NO_ERROR);
+
+    // Two timeouts: the third attempt succeeds
+    sensirion_emu_inject_timeouts(kBus, SEN66_I2C_ADDR_6B, 2);
+    uint8_t padding;
+    bool ready;
+    uint64_t elapsed = Elapsed([&] { CHECK_EQ(sen66_get_data_ready(&padding, &ready), NO_ERROR); });
+    CHECK(elapsed >= 2 * 1000 * kMs + 2 * 2 * kMs);
+
+    // Three: every attempt of the write times out
+    sensirion_emu_inject_timeouts(kBus, SEN66_I2C_ADDR_6B, 3);
+    Reading r = {};
+    elapsed = Elapsed([&] { CHECK_EQ(ReadSen66(r), I2C_NACK_ERROR); });
+    CHECK(elapsed >= 3 * 1000 * kMs + 2 * 2 * kMs);
+    CHECK(elapsed < 3 * 1000 * kMs + 20 * kMs);
+
+    sensirion_emu_stats_t stats;
+    CHECK_EQ(sensirion_emu_get_stats(kBus, SEN66_I2C_ADDR_6B, &stats), 0);
+    CHECK_EQ(stats.timeouts, 5);
+
+    CHECK_EQ(ReadSen66(r), NO_ERROR);
+    CHECK_EQ(r.co2, 805); // the read came 6 s after the start
+}
+
+// SCD30 on a second bus, read with the blocking helper
+void TestScd30()
+{
+    sensirion_emu_reset();
+    CHECK_EQ(sensirion_emu_add_scd30(1, SCD30_I2C_ADDR_61), 0);
+    sensirion_emu_set_trace(1, SCD30_I2C_ADDR_61, kTrace, 3);
+    CHECK_EQ(sensirion_i2c_hal_select_bus(1), NO_ERROR);
+    CHECK_EQ(scd30_init(SCD30_I2C_ADDR_61), NO_ERROR);
+    CHECK_EQ(scd30_start_periodic_measurement(0), NO_ERROR);
+
+    float co2 = 0, temperature = 0, humidity = 0;
+    uint64_t elapsed =
+        Elapsed([&] { CHECK_EQ(scd30_blocking_read_measurement_data(&co2, &temperature, &humidity), NO_ERROR); });
+    CHECK(elapsed >= 2000 * kMs); // default 2 s interval
+    CHECK_EQ(co2, 612);
+    CHECK_EQ(temperature * 200, 4410);
+    CHECK_EQ(humidity * 100, 4512);
+
+    // Nothing answers at 0x61 on bus 0
+    CHECK_EQ(sensirion_i2c_hal_select_bus(0), NO_ERROR);
+    CHECK(scd30_init(SCD30_I2C_ADDR_61) != NO_ERROR);
+}
+
+// The SensirionSEN66 class as the firmware drives it: reads, then an
+// unplugged sensor, recovery and reads again
+void TestSen66Class()
+{
+    AddSen66();
+    SensirionSEN66 sensor;
+    CHECK(sensor.Init());
+
+    // Before the first interval the sensor marks every value unavailable
+    Sensor::MeasurementRecord record;
+    CHECK(sensor.ReadMeasurements(record));
+    CHECK(record.IsEmpty());
+    CHECK_EQ(record.Get(Type::CO2), Sensor::kNoValue);
+
+    sensirion_emu_advance_us(1000 * kMs);
+    CHECK(sensor.ReadMeasurements(record));
+    CHECK_EQ(record.Get(Type::CO2), 612);
+    CHECK_EQ(record.Get(Type::Temperature), 4410);
+
+    sensirion_emu_advance_us(1000 * kMs);
+    CHECK(sensor.ReadMeasurements(record));
+    CHECK_EQ(record.Get(Type::CO2), 40000);
+    CHECK_EQ(record.Get(Type::PM2p5), 52);
+
+    // Five failed reads start a recovery
+    sensirion_emu_set_unresponsive(kBus, SEN66_I2C_ADDR_6B, true);
+    for (int i = 0; i < 5; i++) {
+        sensirion_emu_advance_us(1000 * kMs);
+        CHECK(!sensor.ReadMeasurements(record));
+        CHECK(record.IsEmpty());
+    }
+    CHECK(sensor.IsRecovering());
+
+    // Plugged back in: reset, reconfigure, measure, one step per read
+    sensirion_emu_set_unresponsive(kBus, SEN66_I2C_ADDR_6B, false);
+    int reads = 0;
+    while (sensor.IsRecovering() && reads < 20) {
+        sensirion_emu_advance_us(1000 * kMs);
+        sensor.ReadMeasurements(record);
+        reads++;
+    }
+    CHECK(!sensor.IsRecovering());
+    sensirion_emu_advance_us(1000 * kMs);
+    CHECK(sensor.ReadMeasurements(record));
+    CHECK_EQ(record.Get(Type::CO2), 612); // the trace restarts with measurement
+}
+
+// Everything the drivers slept is accounted in the HAL's sleep statistics
+void TestSleepStats()
+{
+    AddSen66();
+    CHECK_EQ(sen66_init(SEN66_I2C_ADDR_6B), NO_ERROR);
+    uint64_t yieldedBefore, spunBefore;
+    sensirion_i2c_hal_get_sleep_stats(&yieldedBefore, &spunBefore);
+    CHECK_EQ(sen66_start_continuous_measurement(), NO_ERROR);
+    CHECK_EQ(sen66_stop_measurement(), NO_ERROR);
+    uint64_t yielded, spun;
+    sensirion_i2c_hal_get_sleep_stats(&yielded, &spun);
+    CHECK_EQ((yielded + spun) - (yieldedBefore + spunBefore), 1450 * kMs);
+}
+
+} // namespace
+
+int main()
+{
+    TestSen66Lifecycle();
+    TestInjectedTimeouts();
+    TestScd30();
+    TestSen66Class();
+    TestSleepStats();
+    return HostCheck::ExitCode();
+}
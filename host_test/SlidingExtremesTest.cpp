@@ -0,0 +1,150 @@
+// The wedges against a naive scan of every sample in the window, over random
+// traces: values from a handful of levels (so many are equal), random walks,
+// long falling and rising runs that fill a wedge, and pauses longer than the
+// window. With a one-second resolution the extremes are exact; with coarser
+// buckets they may also count samples up to one step older than the window.
+
+#include "HostCheck.h"
+#include "SlidingExtremes.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+
+namespace {
+
+struct Lcg {
+    uint32_t state = 99;
+
+    uint32_t operator()(uint32_t range)
+    {
+        state = state * 1664525u + 1013904223u;
+        return (state >> 8) % range;
+    }
+};
+
+struct Sample {
+    uint32_t seconds;
+    int32_t low;
+    int32_t high;
+};
+
+struct Extremes {
+    int32_t min = INT32_MAX;
+    int32_t max = INT32_MIN;
+};
+
+// Every sample at or after from
+Extremes Scan(const std::vector<Sample>& samples, uint32_t from)
+{
+    Extremes extremes;
+    for (size_t i = samples.size(); i-- > 0 && samples[i].seconds >= from;) {
+        extremes.min = std::min(extremes.min, samples[i].low);
+        extremes.max = std::max(extremes.max, samples[i].high);
+    }
+    return extremes;
+}
+
+enum class Shape { FewLevels, RandomWalk, Runs };
+
+const char* Name(Shape shape)
+{
+    switch (shape) {
+    case Shape::FewLevels:
+        return "few levels";
+    case Shape::RandomWalk:
+        return "random walk";
+    case Shape::Runs:
+        return "runs";
+    }
+    return "";
+}
+
+void TestTrace(uint32_t windowSeconds, uint32_t resolutionSeconds, uint32_t samplePeriod, Shape shape)
+{
+    SlidingExtremes extremes(windowSeconds, resolutionSeconds);
+    std::vector<Sample> samples;
+    Lcg random;
+    uint32_t seconds = 5;
+    int32_t level = 0;
+    int32_t direction = 1;
+    int failures = 0;
+    size_t fullest = 0;
+    int pauses = 0;
+
+    for (int n = 0; n < 20000 && failures < 5; n++) {
+        switch (shape) {
+        case Shape::FewLevels:
+            level = (int32_t)random(4) * 10 - 10;
+            break;
+        case Shape::RandomWalk:
+            level += (int32_t)random(21) - 10;
+            break;
+        case Shape::Runs:
+            if (random(200) == 0) {
+                direction = -direction;
+            }
+            level += direction;
+            break;
+        }
+        // Interval samples bring their own spread; some are a single reading
+        int32_t spread = random(3) == 0 ? 0 : (int32_t)random(4);
+        Sample sample = {seconds, level - spread, level + spread};
+        extremes.Add(sample.low, sample.high, (int64_t)seconds * 1000000);
+        samples.push_back(sample);
+
+        // Exact over [newest - window, newest]; a coarser bucket may hold
+        // on to a sample up to one step older
+        uint32_t from = seconds > windowSeconds ? seconds - windowSeconds : 0;
+        Extremes exact = Scan(samples, from);
+        Extremes loose = Scan(samples, from > resolutionSeconds - 1 ? from - (resolutionSeconds - 1) : 0);
+        bool ok = !extremes.IsEmpty() && extremes.GetMax() >= exact.max && extremes.GetMax() <= loose.max &&
+                  extremes.GetMin() <= exact.min && extremes.GetMin() >= loose.min;
+        if (resolutionSeconds == 1) {
+            ok = ok && extremes.GetMax() == exact.max && extremes.GetMin() == exact.min;
+        }
+        if (!CHECK(ok)) {
+            fprintf(stderr, "%s, window %u s / %u s, at %u s: min %d max %d, scan %d..%d (loose %d..%d)\n",
+                    Name(shape), (unsigned)windowSeconds, (unsigned)resolutionSeconds, (unsigned)seconds,
+                    (int)extremes.GetMin(), (int)extremes.GetMax(), (int)exact.min, (int)exact.max,
+                    (int)loose.min, (int)loose.max);
+            failures++;
+        }
+        CHECK(extremes.GetSize() <= extremes.GetCapacity());
+        fullest = std::max(fullest, extremes.GetSize());
+
+        uint32_t step = samplePeriod;
+        if (random(1000) == 0) {
+            step = windowSeconds + 1 + random(2 * windowSeconds); // the whole window goes stale
+            pauses++;
+        } else if (random(20) == 0) {
+            step += random(4 * samplePeriod);
+        }
+        seconds += step;
+    }
+    CHECK(pauses > 0);
+    printf("%-11s window %5u s / %3u s: %2d pauses, fullest wedge %3u of %3u\n", Name(shape),
+           (unsigned)windowSeconds, (unsigned)resolutionSeconds, pauses, (unsigned)fullest,
+           (unsigned)extremes.GetCapacity());
+}
+
+void TestEmpty()
+{
+    SlidingExtremes extremes(60, 1);
+    CHECK(extremes.IsEmpty());
+    CHECK_EQ(extremes.GetSize(), 0);
+}
+
+} // namespace
+
+int main()
+{
+    TestEmpty();
+    for (Shape shape : {Shape::FewLevels, Shape::RandomWalk, Shape::Runs}) {
+        TestTrace(60, 1, 1, shape);
+        TestTrace(600, 10, 2, shape);
+        // The firmware's peak window: an hour in 60 s steps, sampled every 5 s
+        TestTrace(3600, 60, 5, shape);
+    }
+    return HostCheck::ExitCode();
+}
@@ -0,0 +1,383 @@
+// The part of MeasurementStore::Record() behind the display and the flash
+// history: rollups for temperature, humidity and CO2, exposure percentiles
+// for CO2 and PM2.5, and the CO2 chart history, set up as app_main does. The
+// float version it replaced (units per report, float rollup cells, logf() per
+// percentile sample) against today's integer one.
+//
+// The C6 has no FPU, so each float operation there is a call into the
+// soft-float library and logf() is dozens of them. The host has an FPU, so its
+// times say nothing about that: instead the old version runs on a counting
+// float type that tallies those operations per report. The new version takes
+// and stores only integers, so it has none.
+
+#include "HostCheck.h"
+#include "MeasurementSnapshot.h"
+#include "QuantileSketch.h"
+#include "RingBuffer.h"
+#include "RollupSeries.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdio.h>
+#include <string.h>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+using Type = Sensor::MeasurementType;
+
+constexpr uint32_t kReportSec = 60;
+constexpr uint32_t kExposureWindowSec = 24 * 3600;
+constexpr size_t kChartColumns = 20;
+
+// A float that counts the operations the C6 would make soft-float calls for:
+// arithmetic, comparisons and conversions to and from integers. Constants
+// (float literals) cost nothing; logf() is counted apart.
+struct FloatOps {
+    static inline uint64_t operations = 0;
+    static inline uint64_t libmCalls = 0;
+};
+
+class CountedFloat
+{
+public:
+    CountedFloat() = default;
+    CountedFloat(float value) : m_value(value) {}
+
+    template <typename Int, typename = std::enable_if_t<std::is_integral<Int>::value>>
+    CountedFloat(Int value) : m_value((float)value)
+    {
+        FloatOps::operations++;
+    }
+
+    explicit operator int() const
+    {
+        FloatOps::operations++;
+        return (int)m_value;
+    }
+
+    float Raw() const { return m_value; }
+
+    friend CountedFloat operator+(CountedFloat a, CountedFloat b) { return Op(a.m_value + b.m_value); }
+    friend CountedFloat operator-(CountedFloat a, CountedFloat b) { return Op(a.m_value - b.m_value); }
+    friend CountedFloat operator*(CountedFloat a, CountedFloat b) { return Op(a.m_value * b.m_value); }
+    friend CountedFloat operator/(CountedFloat a, CountedFloat b) { return Op(a.m_value / b.m_value); }
+    CountedFloat& operator+=(CountedFloat other) { return *this = *this + other; }
+    friend bool operator<(CountedFloat a, CountedFloat b) { return Compare(a.m_value < b.m_value); }
+    friend bool operator>=(CountedFloat a, CountedFloat b) { return Compare(a.m_value >= b.m_value); }
+
+    friend CountedFloat logf(CountedFloat value)
+    {
+        FloatOps::libmCalls++;
+        return CountedFloat(::logf(value.m_value));
+    }
+
+private:
+    static CountedFloat Op(float value)
+    {
+        FloatOps::operations++;
+        return CountedFloat(value);
+    }
+
+    static bool Compare(bool result)
+    {
+        FloatOps::operations++;
+        return result;
+    }
+
+    float m_value = 0.0f;
+};
+
+float Raw(float value)
+{
+    return value;
+}
+
+[[maybe_unused]] float Raw(CountedFloat value)
+{
+    return value.Raw();
+}
+
+// RollupSeries::Add() as it was, on float cells in units (queries left out:
+// they ran for the display, not per report)
+template <typename F>
+class OldRollup
+{
+public:
+    OldRollup()
+    {
+        for (int tier = 0; tier < kTierCount; tier++) {
+            m_closed[tier].SetCapacity(kSpanSeconds[tier] / kPeriodSeconds[tier] + 1);
+        }
+    }
+
+    void Add(F value, F low, F high, int64_t timestampUs)
+    {
+        uint32_t seconds = (uint32_t)(timestampUs / 1000000);
+        Roll(kMinute, seconds);
+        Merge(m_open[kMinute], Cell{0, 1, value, low, high});
+    }
+
+    // The newest closed hour's mean
+    bool NewestHourMean(float& mean) const
+    {
+        if (m_closed[kHour].IsEmpty()) {
+            return false;
+        }
+        mean = Raw(m_closed[kHour].Back().mean);
+        return true;
+    }
+
+private:
+    enum { kMinute = 0, kHour, kDay, kTierCount };
+
+    struct Cell {
+        uint32_t start;
+        uint32_t count;
+        F mean;
+        F min;
+        F max;
+    };
+
+    static constexpr uint32_t kPeriodSeconds[kTierCount] = {60, 3600, 86400};
+    static constexpr uint32_t kSpanSeconds[kTierCount] = {3600, 48 * 3600, 31 * 86400};
+
+    static void Merge(Cell& into, const Cell& from)
+    {
+        if (from.count == 0) {
+            return;
+        }
+        if (into.count == 0) {
+            into.mean = from.mean;
+            into.min = from.min;
+            into.max = from.max;
+        } else {
+            into.mean += (from.mean - into.mean) * from.count / (into.count + from.count);
+            into.min = std::min(into.min, from.min);
+            into.max = std::max(into.max, from.max);
+        }
+        into.count += from.count;
+    }
+
+    void Roll(int tier, uint32_t seconds)
+    {
+        uint32_t start = seconds - seconds % kPeriodSeconds[tier];
+        Cell& open = m_open[tier];
+        if (open.count == 0 || open.start == start) {
+            open.start = start;
+            return;
+        }
+        m_closed[tier].PushBack(open);
+        if (tier + 1 < kTierCount) {
+            Roll(tier + 1, open.start);
+            Merge(m_open[tier + 1], open);
+        }
+        open = Cell{start, 0, 0.0f, 0.0f, 0.0f};
+    }
+
+    RingBuffer<Cell> m_closed[kTierCount];
+    Cell m_open[kTierCount] = {};
+};
+
+// QuantileSketch::Add() as it was: the bin from logf() of the value in units
+template <typename F>
+class OldSketch
+{
+public:
+    OldSketch(float minValue, float maxValue, float relativeError, uint32_t maxWindowSeconds)
+        : m_minValue(minValue)
+    {
+        float gamma = (1.0f + relativeError) / (1.0f - relativeError);
+        m_logGamma = ::logf(gamma);
+        m_binCount = (uint16_t)(ceilf(::logf(maxValue / minValue) / ::logf(gamma)) + 2);
+        m_slotCount = (uint16_t)((maxWindowSeconds + 3599) / 3600 + 1);
+        m_slotPeriods.assign(m_slotCount, UINT32_MAX);
+        m_counts.assign((size_t)m_slotCount * m_binCount, 0);
+    }
+
+    void Add(F value, int64_t timestampUs)
+    {
+        uint32_t slot = (uint32_t)(timestampUs / 1000000 / 3600);
+        uint16_t row = slot % m_slotCount;
+        uint16_t* counts = &m_counts[(size_t)row * m_binCount];
+        if (m_slotPeriods[row] != slot) {
+            m_slotPeriods[row] = slot;
+            memset(counts, 0, m_binCount * sizeof(uint16_t));
+        }
+        uint16_t bin = BinOf(value);
+        if (counts[bin] < UINT16_MAX) {
+            counts[bin]++;
+        }
+    }
+
+    float ValueOf(uint16_t bin) const
+    {
+        float gamma = expf(Raw(m_logGamma));
+        return bin == 0 ? Raw(m_minValue) / 2.0f
+                        : Raw(m_minValue) * expf((bin - 1) * Raw(m_logGamma)) * 2.0f * gamma / (1.0f + gamma);
+    }
+
+    uint16_t BinOf(F value) const
+    {
+        if (!(value >= m_minValue)) {
+            return 0;
+        }
+        int bin = 1 + (int)(logf(value / m_minValue) / m_logGamma);
+        return (uint16_t)std::min(bin, m_binCount - 1);
+    }
+
+private:
+    F m_minValue;
+    F m_logGamma;
+    int m_binCount;
+    uint16_t m_slotCount;
+    std::vector<uint32_t> m_slotPeriods;
+    std::vector<uint16_t> m_counts;
+};
+
+// The float half of the old Record(): values converted to units per report
+template <typename F>
+class OldPath
+{
+public:
+    OldPath()
+        : m_co2Sketch(100.0f, 10000.0f, 0.03f, kExposureWindowSec)
+        , m_pm25Sketch(1.0f, 1000.0f, 0.05f, kExposureWindowSec)
+    {
+        m_co2History.SetCapacity(kChartColumns);
+    }
+
+    void Record(const MeasurementSnapshot& report)
+    {
+        const Type rolled[] = {Type::Temperature, Type::RelativeHumidity, Type::CO2};
+        for (size_t i = 0; i < 3; i++) {
+            m_rollups[i].Add(Units(rolled[i], report.values), Units(rolled[i], report.minValues),
+                             Units(rolled[i], report.maxValues), report.timestampUs);
+        }
+        F co2 = Units(Type::CO2, report.values);
+        m_co2Sketch.Add(co2, report.timestampUs);
+        m_co2History.PushBack(co2);
+        m_pm25Sketch.Add(Units(Type::PM2p5, report.values), report.timestampUs);
+    }
+
+    OldRollup<F> m_rollups[3];
+    OldSketch<F> m_co2Sketch;
+    OldSketch<F> m_pm25Sketch;
+    RingBuffer<F> m_co2History;
+
+private:
+    // MeasurementSnapshot::Get() and friends, once per value
+    static F Units(Type type, const int32_t* steps)
+    {
+        return F(steps[static_cast<size_t>(type)]) / F(Sensor::NativeScale(type));
+    }
+};
+
+// The same work as MeasurementStore::Record() does it now
+class NewPath
+{
+public:
+    NewPath()
+        : m_co2Sketch(100, 10000, 0.03f, kExposureWindowSec)
+        , m_pm25Sketch(10, 10000, 0.05f, kExposureWindowSec)
+    {
+        m_co2History.SetCapacity(kChartColumns);
+    }
+
+    void Record(const MeasurementSnapshot& report)
+    {
+        const Type rolled[] = {Type::Temperature, Type::RelativeHumidity, Type::CO2};
+        for (size_t i = 0; i < 3; i++) {
+            size_t slot = static_cast<size_t>(rolled[i]);
+            m_rollups[i].Add(report.values[slot], report.minValues[slot], report.maxValues[slot],
+                             report.timestampUs);
+        }
+        int32_t co2 = report.GetNative(Type::CO2);
+        m_co2Sketch.Add(co2, report.timestampUs);
+        m_co2History.PushBack(co2);
+        m_pm25Sketch.Add(report.GetNative(Type::PM2p5), report.timestampUs);
+    }
+
+    RollupSeries m_rollups[3];
+    QuantileSketch m_co2Sketch;
+    QuantileSketch m_pm25Sketch;
+    RingBuffer<int32_t> m_co2History;
+};
+
+void Set(MeasurementSnapshot& report, Type type, int32_t value, int32_t spread)
+{
+    size_t i = static_cast<size_t>(type);
+    report.values[i] = value;
+    report.minValues[i] = value - spread;
+    report.maxValues[i] = value + spread;
+    report.validMask |= MeasurementSnapshot::Bit(type);
+}
+
+// Two days of reports, values swinging over their ranges
+std::vector<MeasurementSnapshot> MakeReports()
+{
+    const size_t count = 2 * 86400 / kReportSec;
+    std::vector<MeasurementSnapshot> reports(count);
+    for (size_t n = 0; n < count; n++) {
+        MeasurementSnapshot& report = reports[n];
+        report.timestampUs = (int64_t)(n + 1) * kReportSec * 1000000;
+        double phase = 2 * M_PI * n / (86400 / kReportSec);
+        Set(report, Type::Temperature, 4400 + (int32_t)(600 * sin(phase)), 20);           // 1/200 °C
+        Set(report, Type::RelativeHumidity, 4500 + (int32_t)(1500 * cos(phase)), 80);     // 0.01 %RH
+        Set(report, Type::CO2, 900 + (int32_t)(500 * sin(phase)) + (int32_t)(n % 37), 40); // ppm
+        Set(report, Type::PM2p5, 60 + (int32_t)(n * 7919 % 400), 10);                      // 0.1 ug/m3
+    }
+    return reports;
+}
+
+} // namespace
+
+int main()
+{
+    const std::vector<MeasurementSnapshot> reports = MakeReports();
+
+    // Float operations per report, over two days so every tier rolls over
+    auto counted = std::make_unique<OldPath<CountedFloat>>();
+    FloatOps::operations = 0;
+    FloatOps::libmCalls = 0;
+    for (const MeasurementSnapshot& report : reports) {
+        counted->Record(report);
+    }
+    double operations = (double)FloatOps::operations / reports.size();
+    double libmCalls = (double)FloatOps::libmCalls / reports.size();
+
+    // Both keep the same statistics: the newest hour's CO2 mean within a
+    // step, and every integer CO2 value in the same percentile bin
+    auto oldPath = std::make_unique<OldPath<float>>();
+    auto newPath = std::make_unique<NewPath>();
+    for (const MeasurementSnapshot& report : reports) {
+        oldPath->Record(report);
+        newPath->Record(report);
+    }
+    float oldMean;
+    uint32_t start;
+    RollupSeries::Summary newHour;
+    if (CHECK(oldPath->m_rollups[2].NewestHourMean(oldMean)) &&
+        CHECK(newPath->m_rollups[2].GetNewestClosed(RollupSeries::kHour, start, newHour))) {
+        CHECK(std::fabs(oldMean - newHour.mean) <= 0.5f);
+    }
+    uint32_t binMismatches = 0;
+    OldSketch<float> oldSketch(100.0f, 10000.0f, 0.03f, 3600);
+    for (int32_t co2 = 0; co2 < 10000; co2++) {
+        QuantileSketch single(100, 10000, 0.03f, 3600);
+        single.Add(co2, 0);
+        float reported = single.GetPercentiles(3600).p50;
+        float expected = oldSketch.ValueOf(oldSketch.BinOf((float)co2));
+        if (std::fabs(reported - expected) > 1e-3f * expected) {
+            binMismatches++;
+        }
+    }
+    CHECK_EQ(binMismatches, 0);
+
+    printf("%-22s %14s %14s\n", "per report", "float ops", "logf() calls");
+    printf("%-22s %14.1f %14.1f\n", "float, in units", operations, libmCalls);
+    printf("%-22s %14d %14d\n", "integer, native steps", 0, 0);
+    return HostCheck::ExitCode();
+}
@@ -0,0 +1,233 @@
+// LCD frame rendering: the snprintf("%.1f") rows DrawDisplay() used to build
+// from float readings and rollup statistics, against TextRow building them
+// from the store's native integer steps. Four pages, each frame rendered both
+// ways from the same values and checked to produce the same 80 characters.
+// Values avoid exact rounding ties, where printf rounds the float's binary
+// value and TextRow the native step and the last digit may differ.
+
+#include "HostBench.h"
+#include "HostCheck.h"
+#include "RollupSeries.h"
+#include "TextRow.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+using Type = Sensor::MeasurementType;
+
+constexpr size_t kColumns = 20;
+constexpr size_t kRows = 4;
+
+using Frame = char[kRows][kColumns + 1];
+
+struct Readings {
+    int32_t temperature, humidity, co2, voc, nox, pm1, pm25, pm4, pm10; // native steps
+};
+
+// A rollup summary in units, as the old code held it
+struct UnitSummary {
+    float mean, min, max;
+};
+
+struct Values {
+    Readings native;
+    float units[9]; // the same readings as the old code held them
+    RollupSeries::Summary temperature, humidity, co2; // native steps
+    UnitSummary temperatureUnits, humidityUnits, co2Units;
+};
+
+float Units(Type type, int32_t native)
+{
+    return (float)native / Sensor::NativeScale(type);
+}
+
+UnitSummary InUnits(Type type, const RollupSeries::Summary& summary)
+{
+    return {Units(type, summary.mean), Units(type, summary.min), Units(type, summary.max)};
+}
+
+// Readings spread over their ranges, stepping past the half-way values
+std::vector<Values> MakeValues()
+{
+    std::vector<Values> all(64);
+    for (size_t i = 0; i < all.size(); i++) {
+        Values& v = all[i];
+        Readings& r = v.native;
+        r.temperature = -1000 + (int32_t)i * 273 + ((i * 273) % 20 == 10 ? 1 : 0);
+        r.humidity = 1503 + (int32_t)i * 121;
+        r.humidity += r.humidity % 10 == 5 ? 1 : 0;
+        r.co2 = 400 + (int32_t)i * 97;
+        r.voc = 10 + (int32_t)i * 61;
+        r.voc += r.voc % 10 == 5 ? 1 : 0;
+        r.nox = 10 + (int32_t)(i % 7) * 10;
+        r.pm1 = (int32_t)i * 7;
+        r.pm25 = (int32_t)i * 11;
+        r.pm4 = (int32_t)i * 13;
+        r.pm10 = (int32_t)i * 17;
+
+        const Type types[] = {Type::Temperature, Type::RelativeHumidity, Type::CO2, Type::VOC, Type::NOx,
+                              Type::PM1p0,       Type::PM2p5,            Type::PM4p0, Type::PM10p0};
+        const int32_t* fields = &r.temperature;
+        for (size_t f = 0; f < 9; f++) {
+            v.units[f] = Units(types[f], fields[f]);
+        }
+        // Statistics around the readings, stepped past the half-way values
+        // of one decimal (temperature steps are 1/200 °C, humidity 0.01 %RH)
+        auto offTie = [](int32_t value, int32_t period, int32_t tie) {
+            return ((value % period) + period) % period == tie ? value + 1 : value;
+        };
+        v.temperature = {offTie(r.temperature + 3, 20, 10), offTie(r.temperature - 623, 20, 10),
+                         offTie(r.temperature + 853, 20, 10), 100};
+        v.humidity = {offTie(r.humidity - 37, 10, 5), offTie(r.humidity - 1021, 10, 5),
+                      offTie(r.humidity + 543, 10, 5), 100};
+        v.co2 = {r.co2 + 12, r.co2 - 130, r.co2 + 410, 100};
+        v.temperatureUnits = InUnits(Type::Temperature, v.temperature);
+        v.humidityUnits = InUnits(Type::RelativeHumidity, v.humidity);
+        v.co2Units = InUnits(Type::CO2, v.co2);
+    }
+    return all;
+}
+
+// The rows as they were built before TextRow (the live page's trend glyphs
+// are blank here: the same comparison either way)
+void OldLive(const Values& v, Frame& frame)
+{
+    snprintf(frame[0], sizeof(frame[0]), "%.1f\xDF" "C%c %.1f%%RH%c", v.units[0], ' ', v.units[1], ' ');
+    snprintf(frame[1], sizeof(frame[1]), "CO2 %.0fppm%c VOC %.0f", v.units[2], ' ', v.units[3]);
+    snprintf(frame[2], sizeof(frame[2]), "PM2.5 %.1f%c PM10 %.1f", v.units[6], ' ', v.units[8]);
+    snprintf(frame[3], sizeof(frame[3]), "Air: %s", "Good");
+}
+
+void OldParticles(const Values& v, Frame& frame)
+{
+    snprintf(frame[0], sizeof(frame[0]), "Particles \xE4g/m3");
+    snprintf(frame[1], sizeof(frame[1]), "PM1  %.1f  PM2.5 %.1f", v.units[5], v.units[6]);
+    snprintf(frame[2], sizeof(frame[2]), "PM4  %.1f  PM10  %.1f", v.units[7], v.units[8]);
+    snprintf(frame[3], sizeof(frame[3]), "NOx index %.0f", v.units[4]);
+}
+
+void OldMinMax(const Values& v, Frame& frame)
+{
+    const UnitSummary& t = v.temperatureUnits;
+    const UnitSummary& h = v.humidityUnits;
+    const UnitSummary& c = v.co2Units;
+    snprintf(frame[0], sizeof(frame[0]), "24h     MIN     MAX");
+    snprintf(frame[1], sizeof(frame[1]), "T\xDF" "C %8.1f %7.1f", t.min, t.max);
+    snprintf(frame[2], sizeof(frame[2]), "RH%% %8.1f %7.1f", h.min, h.max);
+    snprintf(frame[3], sizeof(frame[3]), "CO2 %8.0f %7.0f", c.min, c.max);
+}
+
+void OldWeek(const Values& v, Frame& frame)
+{
+    const UnitSummary& t = v.temperatureUnits;
+    const UnitSummary& h = v.humidityUnits;
+    const UnitSummary& c = v.co2Units;
+    snprintf(frame[0], sizeof(frame[0]), "7d   AVG   MIN   MAX");
+    snprintf(frame[1], sizeof(frame[1]), "T\xDF" "C%5.1f %5.1f %5.1f", t.mean, t.min, t.max);
+    snprintf(frame[2], sizeof(frame[2]), "RH%%%5.1f %5.1f %5.1f", h.mean, h.min, h.max);
+    snprintf(frame[3], sizeof(frame[3]), "CO2%5.0f %5.0f %5.0f", c.mean, c.min, c.max);
+}
+
+// The same rows as DrawDisplay() builds them now
+void NewLive(const Values& v, Frame& frame)
+{
+    const Readings& r = v.native;
+    TextRow(frame[0]).Native<1>(Type::Temperature, r.temperature).Text(LcdUnit::kCelsius).Char(' ').Char(' ')
+        .Native<1>(Type::RelativeHumidity, r.humidity).Text(LcdUnit::kPercentRH).Char(' ');
+    TextRow(frame[1]).Text("CO2 ").Native<0>(Type::CO2, r.co2).Text(LcdUnit::kPpm).Char(' ')
+        .Text(" VOC ").Native<0>(Type::VOC, r.voc);
+    TextRow(frame[2]).Text("PM2.5 ").Native<1>(Type::PM2p5, r.pm25).Char(' ')
+        .Text(" PM10 ").Native<1>(Type::PM10p0, r.pm10);
+    TextRow(frame[3]).Text("Air: ").Text("Good");
+}
+
+void NewParticles(const Values& v, Frame& frame)
+{
+    const Readings& r = v.native;
+    TextRow(frame[0]).Text("Particles ").Text(LcdUnit::kMicrogramsPerM3);
+    TextRow(frame[1]).Text("PM1  ").Native<1>(Type::PM1p0, r.pm1).Text("  PM2.5 ").Native<1>(Type::PM2p5, r.pm25);
+    TextRow(frame[2]).Text("PM4  ").Native<1>(Type::PM4p0, r.pm4).Text("  PM10  ").Native<1>(Type::PM10p0, r.pm10);
+    TextRow(frame[3]).Text("NOx index ").Native<0>(Type::NOx, r.nox);
+}
+
+void NewMinMax(const Values& v, Frame& frame)
+{
+    TextRow(frame[0]).Text("24h     MIN     MAX");
+    TextRow(frame[1]).Char('T').Text(LcdUnit::kCelsius).Char(' ')
+        .Native<1, 8>(Type::Temperature, v.temperature.min).Char(' ')
+        .Native<1, 7>(Type::Temperature, v.temperature.max);
+    TextRow(frame[2]).Text("RH% ")
+        .Native<1, 8>(Type::RelativeHumidity, v.humidity.min).Char(' ')
+        .Native<1, 7>(Type::RelativeHumidity, v.humidity.max);
+    TextRow(frame[3]).Text("CO2 ")
+        .Native<0, 8>(Type::CO2, v.co2.min).Char(' ')
+        .Native<0, 7>(Type::CO2, v.co2.max);
+}
+
+void NewWeek(const Values& v, Frame& frame)
+{
+    TextRow(frame[0]).Text("7d   AVG   MIN   MAX");
+    TextRow(frame[1]).Char('T').Text(LcdUnit::kCelsius)
+        .Native<1, 5>(Type::Temperature, v.temperature.mean).Char(' ')
+        .Native<1, 5>(Type::Temperature, v.temperature.min).Char(' ')
+        .Native<1, 5>(Type::Temperature, v.temperature.max);
+    TextRow(frame[2]).Text("RH%")
+        .Native<1, 5>(Type::RelativeHumidity, v.humidity.mean).Char(' ')
+        .Native<1, 5>(Type::RelativeHumidity, v.humidity.min).Char(' ')
+        .Native<1, 5>(Type::RelativeHumidity, v.humidity.max);
+    TextRow(frame[3]).Text("CO2")
+        .Native<0, 5>(Type::CO2, v.co2.mean).Char(' ')
+        .Native<0, 5>(Type::CO2, v.co2.min).Char(' ')
+        .Native<0, 5>(Type::CO2, v.co2.max);
+}
+
+struct Page {
+    const char* name;
+    void (*oldRender)(const Values&, Frame&);
+    void (*newRender)(const Values&, Frame&);
+};
+
+const Page kPages[] = {
+    {"live", OldLive, NewLive},
+    {"particles", OldParticles, NewParticles},
+    {"24h min/max", OldMinMax, NewMinMax},
+    {"7d", OldWeek, NewWeek},
+};
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const uint64_t iterations = HostBench::Iterations(argc, argv, 1000000);
+    const std::vector<Values> values = MakeValues();
+
+    printf("%-12s %14s %14s\n", "page", "snprintf", "TextRow");
+    printf("%-12s %14s %14s\n", "", "ns/frame", "ns/frame");
+    for (const Page& page : kPages) {
+        for (const Values& v : values) {
+            Frame oldFrame, newFrame;
+            page.oldRender(v, oldFrame);
+            page.newRender(v, newFrame);
+            for (size_t row = 0; row < kRows; row++) {
+                if (!CHECK(strcmp(oldFrame[row], newFrame[row]) == 0)) {
+                    fprintf(stderr, "%s row %zu: \"%s\" vs \"%s\"\n", page.name, row, oldFrame[row], newFrame[row]);
+                }
+            }
+        }
+
+        Frame frame;
+        double oldNs = HostBench::NsPerCall(iterations, [&](uint64_t i) {
+            page.oldRender(values[i % values.size()], frame);
+            HostBench::Keep(frame);
+        });
+        double newNs = HostBench::NsPerCall(iterations, [&](uint64_t i) {
+            page.newRender(values[i % values.size()], frame);
+            HostBench::Keep(frame);
+        });
+        printf("%-12s %14.1f %14.1f\n", page.name, oldNs, newNs);
+    }
+    return HostCheck::ExitCode();
+}
@@ -0,0 +1,115 @@
+// Worst-case button-to-screen latency with the sensor read on the esp_timer
+// task (before) and in the acquisition task (now), in the terms of the
+// firmware's own UI latency probe: the time a press waits for the esp_timer
+// task, plus the redraw.
+//
+// The acquisition calls run against the emulated SEN66 on its virtual clock:
+// an hour of reads, an I2C retry storm, an unplug and recovery, an altitude
+// update and a fan cleaning. The redraw is costed from the LCD2004 bus
+// traffic. Both designs use today's driver, so only the task split differs.
+
+#include "HostCheck.h"
+#include "SensirionSEN66.h"
+#include "sen66_i2c.h"
+#include "sensirion_i2c_hal.h"
+#include "sensirion_i2c_hal_emulator.h"
+
+#include <algorithm>
+#include <nvs.h>
+#include <stdio.h>
+
+namespace {
+
+constexpr uint8_t kBus = 0;
+constexpr uint64_t kSecondUs = 1000000;
+
+// LCD2004 full redraw: 4 rows of a DDRAM address command and 20 characters,
+// each byte two nibbles, each nibble two single-byte PCF8574 writes (address
+// and data byte at 100 kHz, 9 clocks each) and a 51 us settle
+constexpr uint64_t kExpanderWriteUs = 2 * 90;
+constexpr uint64_t kNibbleUs = 2 * kExpanderWriteUs + 51;
+constexpr uint64_t kRedrawUs = 4 * (1 + 20) * 2 * kNibbleUs;
+
+struct Worst {
+    uint64_t callUs = 0;    // longest acquisition call
+    uint64_t busHoldUs = 0; // longest bus time of a call on a healthy bus
+};
+
+Worst s_worst;
+
+// Runs one acquisition call and records how long it ran and how long it
+// held the bus (its time less what it slept)
+template <typename Fn>
+void Acquire(bool healthyBus, Fn fn)
+{
+    uint64_t yielded0, spun0;
+    sensirion_i2c_hal_get_sleep_stats(&yielded0, &spun0);
+    uint64_t start = sensirion_emu_now_us();
+    fn();
+    uint64_t elapsed = sensirion_emu_now_us() - start;
+    uint64_t yielded, spun;
+    sensirion_i2c_hal_get_sleep_stats(&yielded, &spun);
+
+    s_worst.callUs = std::max(s_worst.callUs, elapsed);
+    if (healthyBus) {
+        uint64_t slept = (yielded - yielded0) + (spun - spun0);
+        s_worst.busHoldUs = std::max(s_worst.busHoldUs, elapsed - slept);
+    }
+}
+
+void EverySecond(int count, bool healthyBus, SensirionSEN66& sensor)
+{
+    Sensor::MeasurementRecord record;
+    for (int i = 0; i < count; i++) {
+        sensirion_emu_advance_us(kSecondUs);
+        Acquire(healthyBus, [&] { sensor.ReadMeasurements(record); });
+    }
+}
+
+} // namespace
+
+int main()
+{
+    sensirion_emu_reset();
+    nvs_host_erase_all();
+    CHECK_EQ(sensirion_emu_add_sen66(kBus, SEN66_I2C_ADDR_6B), 0);
+    SensirionSEN66 sensor;
+    CHECK(sensor.Init());
+
+    EverySecond(3600, true, sensor);
+
+    // A bus that stops answering: every attempt of a read times out
+    Sensor::MeasurementRecord record;
+    for (int i = 0; i < 3; i++) {
+        sensirion_emu_advance_us(kSecondUs);
+        sensirion_emu_inject_timeouts(kBus, SEN66_I2C_ADDR_6B, 3);
+        Acquire(false, [&] { sensor.ReadMeasurements(record); });
+    }
+
+    sensirion_emu_set_unresponsive(kBus, SEN66_I2C_ADDR_6B, true);
+    EverySecond(5, true, sensor);
+    sensirion_emu_set_unresponsive(kBus, SEN66_I2C_ADDR_6B, false);
+    EverySecond(20, true, sensor);
+    CHECK(!sensor.IsRecovering());
+
+    Acquire(true, [&] { CHECK_EQ(sensor.UpdateAltitude(250.0f), 0); });
+    Acquire(true, [&] { CHECK_EQ(sensor.StartFanCleaning(), 0); });
+
+    // Before: the press waits for the sensor callback, which also redrew the
+    // report, then for its own redraw. Now the esp_timer task only redraws;
+    // the acquisition task runs below it, so the press waits for a report
+    // redraw, and that redraw at most for one SEN66 transfer on the shared bus.
+    // A stuck bus stalls the LCD in either design and is left out of "now".
+    uint64_t beforeUs = s_worst.callUs + kRedrawUs + kRedrawUs;
+    uint64_t nowUs = kRedrawUs + s_worst.busHoldUs + kRedrawUs;
+
+    printf("LCD redraw                       %8.1f ms\n", kRedrawUs / 1000.0);
+    printf("longest acquisition call         %8.1f ms\n", s_worst.callUs / 1000.0);
+    printf("longest SEN66 bus hold           %8.1f ms\n", s_worst.busHoldUs / 1000.0);
+    printf("button-to-screen, worst, before  %8.1f ms\n", beforeUs / 1000.0);
+    printf("button-to-screen, worst, now     %8.1f ms\n", nowUs / 1000.0);
+
+    CHECK(s_worst.callUs >= 3 * kSecondUs); // the retry storm
+    CHECK(nowUs < 200 * 1000);
+    return HostCheck::ExitCode();
+}
@@ -0,0 +1,111 @@
+// The window average of one measurement: the std::deque that GetAverage()
+// used to scan on every call, against today's MeasuredValues with its running
+// integer sum. One step of the benchmark is what a report does: Add() a sample
+// and read the average. 3600 s window, sampled every 10 s, 1 s and 250 ms.
+//
+// "scanned" is how many samples one GetAverage() visited: soft-float
+// additions on the ESP32-C6 for the deque, none for the running sum.
+
+#include "HostBench.h"
+#include "HostCheck.h"
+#include "MeasuredValues.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <stdio.h>
+
+namespace {
+
+constexpr uint32_t kWindowSec = 3600;
+
+// The average half of MeasuredValues as it was: float samples in a deque,
+// summed over the window on every GetAverage()
+class DequeAverage
+{
+public:
+    void Add(float value, float elapsedTimeSeconds)
+    {
+        m_samples.push_back({value, elapsedTimeSeconds});
+        while (!m_samples.empty() && m_samples.front().elapsedTimeSeconds < elapsedTimeSeconds - kWindowSec) {
+            m_samples.pop_front();
+        }
+    }
+
+    float GetAverage()
+    {
+        float sum = 0.0f;
+        size_t count = 0;
+        float minTime = m_samples.back().elapsedTimeSeconds - kWindowSec;
+        for (const Sample& sample : m_samples) {
+            if (sample.elapsedTimeSeconds >= minTime) {
+                sum += sample.value;
+                count++;
+            }
+        }
+        return count > 0 ? sum / count : 0.0f;
+    }
+
+    size_t Size() const { return m_samples.size(); }
+
+private:
+    struct Sample {
+        float value;
+        float elapsedTimeSeconds;
+    };
+    std::deque<Sample> m_samples;
+};
+
+// A CO2-like reading in ppm: a slow swing with some noise
+int32_t Reading(uint64_t i)
+{
+    return 800 + (int32_t)(200 * std::sin(i * 0.001)) + (int32_t)((uint32_t)(i * 2654435761u) >> 28);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const uint64_t iterations = HostBench::Iterations(argc, argv, 20000);
+    const uint32_t periodsMs[] = {10000, 1000, 250};
+
+    printf("%8s %9s %14s %14s %9s\n", "period", "scanned", "deque scan", "running sum", "max diff");
+    printf("%8s %9s %14s %14s %9s\n", "", "", "ns/report", "ns/report", "ppm");
+
+    for (uint32_t periodMs : periodsMs) {
+        DequeAverage deque;
+        MeasuredValues values(0, false, kWindowSec, kWindowSec, 1);
+        uint64_t i = 0;
+        float maxDiff = 0.0f;
+
+        // Fill the window, comparing the two as it goes
+        for (; i * periodMs < 2 * kWindowSec * 1000ull; i++) {
+            deque.Add((float)Reading(i), i * periodMs / 1000.0f);
+            values.Add(Reading(i), (int64_t)(i * periodMs) * 1000);
+            if (i * periodMs >= kWindowSec * 1000ull) {
+                maxDiff = std::max(maxDiff, std::fabs(deque.GetAverage() - values.GetAverage()));
+            }
+        }
+        size_t scanned = deque.Size();
+
+        uint64_t next = i;
+        double scanNs = HostBench::NsPerCall(iterations, [&](uint64_t) {
+            deque.Add((float)Reading(next), next * periodMs / 1000.0f);
+            HostBench::Keep(deque.GetAverage());
+            next++;
+        });
+        next = i;
+        double sumNs = HostBench::NsPerCall(iterations, [&](uint64_t) {
+            values.Add(Reading(next), (int64_t)(next * periodMs) * 1000);
+            HostBench::Keep(values.GetAverage());
+            next++;
+        });
+
+        printf("%6.2f s %9zu %14.1f %14.1f %9.2f\n", periodMs / 1000.0, scanned, scanNs, sumNs, maxDiff);
+
+        // Rounded to whole steps and merged into slots: within a step of the
+        // exact mean
+        CHECK(maxDiff <= 1.0f);
+    }
+    return HostCheck::ExitCode();
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF header of the same name. The host allocator
+// (host_test/stubs/heap_hooks.cpp) calls esp_heap_trace_alloc_hook() and
+// esp_heap_trace_free_hook() the way heap_caps does with
+// CONFIG_HEAP_USE_HOOKS.
+
+#include <stddef.h>
+#include <stdint.h>
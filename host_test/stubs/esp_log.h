@@ -0,0 +1,16 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF header of the same name: errors and warnings
+// go to stderr, info and below are dropped so test output stays readable
+// (still compiled, so their arguments count as used and formats are checked)
+
+#include "esp_err.h"
+#include <stdio.h>
+
+#define ESP_LOGE(tag, format, ...) fprintf(stderr, "E %s: " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) fprintf(stderr, "W %s: " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOG_DROPPED(tag, format, ...) \
+    do { if (0) fprintf(stderr, "%s: " format "\n", tag, ##__VA_ARGS__); } while (0)
+#define ESP_LOGI(tag, format, ...) ESP_LOG_DROPPED(tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) ESP_LOG_DROPPED(tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) ESP_LOG_DROPPED(tag, format, ##__VA_ARGS__)
@@ -0,0 +1,51 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF header of the same name: partitions live in
+// RAM, created by esp_partition_host_create(). They behave like NOR flash:
+// erase works on whole 4 kB sectors and sets every bit, a write can only
+// clear bits.
+
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+    ESP_PARTITION_TYPE_APP = 0x00,
+    ESP_PARTITION_TYPE_DATA = 0x01,
+} esp_partition_type_t;
+
+typedef enum {
+    ESP_PARTITION_SUBTYPE_ANY = 0xff,
+} esp_partition_subtype_t;
+
+typedef struct {
+    esp_partition_type_t type;
+    uint8_t subtype;
+    uint32_t address;
+    uint32_t size;
+    uint32_t erase_size;
+    char label[17];
+} esp_partition_t;
+
+#define SPI_FLASH_SEC_SIZE 4096
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label);
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t src_offset, void* dst, size_t size);
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t dst_offset, const void* src, size_t size);
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size);
+
+// Creates (or replaces) an erased data partition of size bytes
+void esp_partition_host_create(const char* label, size_t size);
+// The partition's contents, to inspect or corrupt; nullptr if there is none
+uint8_t* esp_partition_host_data(const char* label);
+// Forgets every partition
+void esp_partition_host_remove_all(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,17 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF header of the same name, computing the same
+// CRCs as the ROM functions
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len);
+uint16_t esp_rom_crc16_le(uint16_t crc, const uint8_t* buf, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
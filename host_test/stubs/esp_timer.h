@@ -0,0 +1,17 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF header of the same name. esp_timer time is
+// the Sensirion emulator's virtual clock, so code that paces itself with
+// esp_timer_get_time() sees the same time as the emulated sensors.
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
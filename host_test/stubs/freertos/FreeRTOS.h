@@ -0,0 +1,13 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF header of the same name
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define portMAX_DELAY 0xffffffffu
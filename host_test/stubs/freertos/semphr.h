@@ -0,0 +1,25 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF header of the same name: mutexes only,
+// backed by pthreads
+
+#include "FreeRTOS.h"
+#include <pthread.h>
+
+typedef struct {
+    pthread_mutex_t mutex;
+} StaticSemaphore_t;
+
+typedef StaticSemaphore_t* SemaphoreHandle_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* buffer);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+
+#ifdef __cplusplus
+}
+#endif
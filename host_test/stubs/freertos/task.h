@@ -0,0 +1,17 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF header of the same name: a task is a thread
+
+#include "FreeRTOS.h"
+
+typedef void* TaskHandle_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,83 @@
+// Host stand-in for ESP-IDF's heap allocation hooks (CONFIG_HEAP_USE_HOOKS):
+// every malloc-family call and every operator new reports to
+// esp_heap_trace_alloc_hook(), as heap_caps does on the target, so
+// AllocationProbe counts host allocations the same way. Linked only into the
+// tests that count allocations; relies on glibc's __libc_* entry points.
+
+#include <esp_heap_caps.h>
+
+#include <new>
+#include <stdlib.h>
+
+extern "C" {
+
+void esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps);
+void esp_heap_trace_free_hook(void* ptr);
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size)
+{
+    void* ptr = __libc_malloc(size);
+    esp_heap_trace_alloc_hook(ptr, size, 0);
+    return ptr;
+}
+
+void* calloc(size_t count, size_t size)
+{
+    void* ptr = __libc_calloc(count, size);
+    esp_heap_trace_alloc_hook(ptr, count * size, 0);
+    return ptr;
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    void* moved = __libc_realloc(ptr, size);
+    esp_heap_trace_alloc_hook(moved, size, 0);
+    return moved;
+}
+
+void free(void* ptr)
+{
+    esp_heap_trace_free_hook(ptr);
+    __libc_free(ptr);
+}
+
+} // extern "C"
+
+void* operator new(size_t size)
+{
+    void* ptr = malloc(size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
@@ -0,0 +1,253 @@
+// Host implementations of the ESP-IDF and FreeRTOS calls the stubs declare
+
+#include "esp_err.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "nvs.h"
+#include "sensirion_i2c_hal_emulator.h"
+
+#include <map>
+#include <memory>
+#include <string.h>
+#include <string>
+#include <vector>
+
+const char* esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:
+        return "ESP_OK";
+    case ESP_FAIL:
+        return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:
+        return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:
+        return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_SIZE:
+        return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:
+        return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NVS_NOT_FOUND:
+        return "ESP_ERR_NVS_NOT_FOUND";
+    default:
+        return "UNKNOWN ERROR";
+    }
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return (int64_t)sensirion_emu_now_us();
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* buffer)
+{
+    pthread_mutex_init(&buffer->mutex, nullptr);
+    return buffer;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t)
+{
+    return pthread_mutex_lock(&semaphore->mutex) == 0 ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    return pthread_mutex_unlock(&semaphore->mutex) == 0 ? pdTRUE : pdFALSE;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    static thread_local char task;
+    return &task;
+}
+
+namespace {
+
+// Namespaces by handle, blobs by key. Handles are 1-based indexes into
+// s_namespaces, so they stay valid while the store grows.
+std::vector<std::string> s_namespaces;
+std::map<std::string, std::vector<unsigned char>> s_blobs; // "namespace/key"
+
+std::string BlobKey(nvs_handle_t handle, const char* key)
+{
+    return s_namespaces.at(handle - 1) + "/" + key;
+}
+
+} // namespace
+
+esp_err_t nvs_open(const char* name, nvs_open_mode_t, nvs_handle_t* out_handle)
+{
+    s_namespaces.push_back(name);
+    *out_handle = (nvs_handle_t)s_namespaces.size();
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* out_value, size_t* length)
+{
+    auto it = s_blobs.find(BlobKey(handle, key));
+    if (it == s_blobs.end()) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (out_value != nullptr) {
+        if (*length < it->second.size()) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        std::copy(it->second.begin(), it->second.end(), static_cast<unsigned char*>(out_value));
+    }
+    *length = it->second.size();
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char* key, const void* value, size_t length)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(value);
+    s_blobs[BlobKey(handle, key)].assign(bytes, bytes + length);
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t)
+{
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t)
+{
+}
+
+void nvs_host_erase_all(void)
+{
+    s_blobs.clear();
+}
+
+namespace {
+
+struct HostPartition {
+    esp_partition_t partition;
+    std::vector<uint8_t> data;
+};
+
+std::vector<std::unique_ptr<HostPartition>> s_partitions;
+
+HostPartition* FindPartition(const char* label)
+{
+    for (auto& entry : s_partitions) {
+        if (strcmp(entry->partition.label, label) == 0) {
+            return entry.get();
+        }
+    }
+    return nullptr;
+}
+
+// The partition's bytes, if [offset, offset + size) lies inside it
+uint8_t* PartitionBytes(const esp_partition_t* partition, size_t offset, size_t size)
+{
+    HostPartition* host = FindPartition(partition->label);
+    if (host == nullptr || offset > host->data.size() || size > host->data.size() - offset) {
+        return nullptr;
+    }
+    return host->data.data() + offset;
+}
+
+} // namespace
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label)
+{
+    HostPartition* host = FindPartition(label);
+    if (host == nullptr || host->partition.type != type ||
+        (subtype != ESP_PARTITION_SUBTYPE_ANY && host->partition.subtype != subtype)) {
+        return nullptr;
+    }
+    return &host->partition;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t src_offset, void* dst, size_t size)
+{
+    const uint8_t* bytes = PartitionBytes(partition, src_offset, size);
+    if (bytes == nullptr) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(dst, bytes, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t dst_offset, const void* src, size_t size)
+{
+    uint8_t* bytes = PartitionBytes(partition, dst_offset, size);
+    if (bytes == nullptr) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    const uint8_t* source = static_cast<const uint8_t*>(src);
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] &= source[i]; // programming only clears bits
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size)
+{
+    if (offset % SPI_FLASH_SEC_SIZE != 0 || size % SPI_FLASH_SEC_SIZE != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint8_t* bytes = PartitionBytes(partition, offset, size);
+    if (bytes == nullptr) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(bytes, 0xFF, size);
+    return ESP_OK;
+}
+
+void esp_partition_host_create(const char* label, size_t size)
+{
+    HostPartition* host = FindPartition(label);
+    if (host == nullptr) {
+        s_partitions.emplace_back(new HostPartition());
+        host = s_partitions.back().get();
+    }
+    host->partition = {};
+    host->partition.type = ESP_PARTITION_TYPE_DATA;
+    host->partition.subtype = 0x40;
+    host->partition.size = (uint32_t)size;
+    host->partition.erase_size = SPI_FLASH_SEC_SIZE;
+    strncpy(host->partition.label, label, sizeof(host->partition.label) - 1);
+    host->data.assign(size, 0xFF);
+}
+
+uint8_t* esp_partition_host_data(const char* label)
+{
+    HostPartition* host = FindPartition(label);
+    return host != nullptr ? host->data.data() : nullptr;
+}
+
+void esp_partition_host_remove_all(void)
+{
+    s_partitions.clear();
+}
+
+// The ROM's CRCs: reflected, with the register and result inverted
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len)
+{
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+    }
+    return ~crc;
+}
+
+uint16_t esp_rom_crc16_le(uint16_t crc, const uint8_t* buf, uint32_t len)
+{
+    crc = (uint16_t)~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0x8408) : (uint16_t)(crc >> 1);
+        }
+    }
+    return (uint16_t)~crc;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+// Host stand-in for the generated sdkconfig.h: only the options the host
+// build compiles against. The allocation probe is on, so tests can count
+// heap allocations through it.
+
+#define CONFIG_ACQUISITION_ALLOCATION_CHECK 1
@@ -0,0 +1,188 @@
+#include "AcquisitionCycle.h"
+#include "TextRow.h"
+#include <algorithm>
+#include <esp_log.h>
+#include <esp_timer.h>
+
+static const char *TAG = "Acquisition";
+
+namespace {
+
+struct FastReportTrigger {
+    Sensor::MeasurementType type;
+    float jump;           // away from the last reported value; 0 = off
+    float slopePerMinute; // 0 = off
+};
+
+constexpr FastReportTrigger kFastReportTriggers[] = {
+    { Sensor::MeasurementType::CO2,    200.0f, 150.0f }, // ppm
+    { Sensor::MeasurementType::PM2p5,   15.0f,  10.0f }, // µg/m³
+    { Sensor::MeasurementType::PM10p0,  25.0f,  20.0f }, // µg/m³
+    { Sensor::MeasurementType::VOC,    100.0f,   0.0f }, // index
+    { Sensor::MeasurementType::NOx,     50.0f,   0.0f }, // index
+};
+
+// Every raw sample first goes through the filter, so the particle and CO2
+// spikes a single bad read produces are replaced by the recent median before
+// they can move a report, flip the LED or trip a fast report. Temperature and
+// humidity are smooth already; VOC/NOx come out of Sensirion's own algorithm.
+struct SampleFilterSetting {
+    Sensor::MeasurementType type;
+    SampleFilter::Config config; // Hampel window, sigma x10, floor; median window; EWMA shift
+};
+
+constexpr SampleFilterSetting kSampleFilters[] = {
+    { Sensor::MeasurementType::CO2,    { 5, 30, 30.0f, 0, 0 } }, // ppm
+    { Sensor::MeasurementType::PM1p0,  { 5, 30,  2.0f, 0, 0 } }, // µg/m³
+    { Sensor::MeasurementType::PM2p5,  { 5, 30,  2.0f, 0, 0 } },
+    { Sensor::MeasurementType::PM4p0,  { 5, 30,  2.0f, 0, 0 } },
+    { Sensor::MeasurementType::PM10p0, { 5, 30,  3.0f, 0, 0 } },
+};
+
+// Adaptive refresh: while readings are stable, the display is dark and no
+// controller is subscribed, the report period stretches from the refresh
+// setting up to AppSettings::idleRefreshSeconds, and snaps back as soon as
+// any of that changes. While stretched, oversampling reads the sensor every
+// kChangeWatchPeriodSec instead of every second, so the sensor, the I2C bus
+// and the radio all get quieter. Stable means no trend arrow would show.
+struct StableBand {
+    Sensor::MeasurementType type;
+    float band;
+};
+
+constexpr StableBand kStableBands[] = {
+    { Sensor::MeasurementType::Temperature,      0.2f },  // °C
+    { Sensor::MeasurementType::RelativeHumidity, 1.0f },  // %RH
+    { Sensor::MeasurementType::CO2,             25.0f },  // ppm
+    { Sensor::MeasurementType::PM2p5,            0.3f },  // µg/m³
+};
+
+} // namespace
+
+AcquisitionCycle::AcquisitionCycle(MeasurementStore& store, Sinks& sinks)
+    : m_store(store)
+    , m_sinks(sinks)
+{
+    for (const FastReportTrigger& t : kFastReportTriggers) {
+        m_changeWatch.SetThreshold(t.type, t.jump, t.slopePerMinute);
+    }
+    for (const StableBand& b : kStableBands) {
+        m_adaptive.SetStableBand(b.type, b.band);
+    }
+    for (const SampleFilterSetting& f : kSampleFilters) {
+        m_filter.Configure(f.type, f.config);
+    }
+}
+
+void AcquisitionCycle::Configure(bool oversample, uint32_t refreshSec, uint32_t idleRefreshSec, int64_t nowUs)
+{
+    m_oversample = oversample;
+    m_adaptive.SetBounds(refreshSec, idleRefreshSec);
+    m_accumulator.Reset();
+    m_filter.Reset(); // its windows assume the old sampling period
+    m_intervalStartUs = nowUs;
+}
+
+uint32_t AcquisitionCycle::SamplePeriodSec(bool oversample, uint32_t reportSec, bool stretched)
+{
+    if (oversample && !stretched) {
+        return kOversamplePeriodSec;
+    }
+    return std::min<uint32_t>(reportSec, kChangeWatchPeriodSec);
+}
+
+// Stores one report once, then tells every consumer; they all read it back
+// from the store, so all see the same values
+void AcquisitionCycle::PublishSnapshot(const MeasurementSnapshot& snapshot)
+{
+    m_store.Record(snapshot);
+    m_sinks.PersistHistory(snapshot);
+    m_sinks.Publish(snapshot);
+}
+
+// Publishes a sample ahead of the schedule when it differs sharply from what
+// consumers were last given. The scheduled cadence is left alone; the next
+// regular report still comes when the refresh interval ends.
+void AcquisitionCycle::CheckForFastReport(const MeasurementSnapshot& sample)
+{
+    Sensor::MeasurementType trigger;
+    if (!m_changeWatch.Check(sample, trigger)) {
+        return;
+    }
+    if (m_adaptive.Wake()) {
+        m_sinks.OnPeriodChanged(); // values are moving; no more stretched refresh
+    }
+    // Rate limited: the baseline stays put, so a change that persists is
+    // reported as soon as the limit allows
+    if (m_lastFastReportUs != 0 &&
+        sample.timestampUs - m_lastFastReportUs < (int64_t)kFastReportMinIntervalSec * 1000000) {
+        return;
+    }
+
+    char value[24];
+    ESP_LOGI(TAG, "Sharp %s change (%s); reporting out of cycle",
+             Sensor::MeasurementTypeToString(trigger),
+             TextRow(value).Reading(trigger, sample.GetNative(trigger)).CStr());
+    PublishSnapshot(sample);
+    m_changeWatch.SetBaseline(sample);
+    m_lastFastReportUs = sample.timestampUs;
+}
+
+bool AcquisitionCycle::Run(bool forceReport)
+{
+    MeasurementSnapshot sample;
+    bool haveSample = m_sinks.Acquire(sample);
+    if (haveSample) {
+        m_filter.Apply(sample);
+    }
+    if (haveSample && m_oversample) {
+        m_accumulator.Add(sample);
+    }
+
+    int64_t now = esp_timer_get_time();
+    if (now - m_lastSubscriptionPollUs >= kSubscriptionPollIntervalUs) {
+        m_lastSubscriptionPollUs = now;
+        m_sinks.PollSubscriptions();
+    }
+    // Display woken or a controller subscribed: back to the set refresh. An
+    // interval already past it reports right away.
+    if (m_adaptive.IsStretched() && !m_sinks.ConsumersIdle() && m_adaptive.Wake()) {
+        m_sinks.OnPeriodChanged();
+    }
+
+    // Half a sample of slack so timer jitter can't push a report a whole period late
+    int64_t dueUs = (int64_t)m_adaptive.GetPeriodSec() * 1000000 - 500000;
+    if (!forceReport && now - m_intervalStartUs < dueUs) {
+        if (haveSample) {
+            CheckForFastReport(sample);
+        }
+        return false;
+    }
+
+    MeasurementSnapshot report;
+    bool haveReport;
+    if (m_oversample) {
+        haveReport = m_accumulator.Decimate(now, report);
+        if (haveReport) {
+            ESP_LOGI(TAG, "Reporting the mean of %u sample(s)", (unsigned)report.sampleCount);
+        }
+    } else {
+        haveReport = haveSample;
+        report = sample;
+    }
+
+    if (haveReport) {
+        PublishSnapshot(report);
+        m_changeWatch.SetBaseline(report);
+        if (m_adaptive.OnReport(report, m_sinks.ConsumersIdle())) {
+            m_sinks.OnPeriodChanged();
+        }
+    } else if (m_sinks.IsSensorRecovering()) {
+        ESP_LOGW(TAG, "Sensor recovering; skipping this report");
+    } else {
+        ESP_LOGE(TAG, "No valid sensor sample in this interval; skipping this report");
+    }
+    m_accumulator.Reset();
+    m_intervalStartUs = now;
+    return true;
+}
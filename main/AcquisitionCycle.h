@@ -0,0 +1,102 @@
+#pragma once
+
+#include "AdaptiveScheduler.h"
+#include "ChangeWatch.h"
+#include "MeasurementSnapshot.h"
+#include "MeasurementStore.h"
+#include "SampleAccumulator.h"
+#include "SampleFilter.h"
+#include <stdint.h>
+
+// The acquisition task's cycle, run once per sensor timer tick: the sample
+// is filtered, accumulated when oversampling and, between reports, checked
+// for a sharp change; once the (adaptive) refresh interval has elapsed or a
+// report is forced, the report is recorded in the store and handed to the
+// consumers. The sensor, the flash history log, Matter and the display are
+// reached through Sinks, so the host tests run this same cycle against the
+// emulated sensor. Fixed size; nothing here touches the heap.
+class AcquisitionCycle
+{
+public:
+    // What the cycle drives; app_main implements it on the device
+    class Sinks
+    {
+    public:
+        virtual ~Sinks() = default;
+
+        // Reads the sensor once into sample; false when the read produced no
+        // data
+        virtual bool Acquire(MeasurementSnapshot& sample) = 0;
+        // A report was recorded in the store: append hours that closed to the
+        // flash history and log the hourly trends
+        virtual void PersistHistory(const MeasurementSnapshot& report) = 0;
+        // A report was recorded in the store: update the Matter endpoints and
+        // redraw the display
+        virtual void Publish(const MeasurementSnapshot& report) = 0;
+        // Starts a count of the Matter subscriptions, for ConsumersIdle()
+        virtual void PollSubscriptions() = 0;
+        // Neither the display nor a Matter controller wants fresh readings
+        virtual bool ConsumersIdle() = 0;
+        // GetReportPeriodSec() or GetSamplePeriodSec() may have changed
+        virtual void OnPeriodChanged() = 0;
+        // Whether a failed read is the sensor recovering, for the log
+        virtual bool IsSensorRecovering() = 0;
+    };
+
+    // The SEN66 produces a new sample every second. When oversampling the
+    // sensor timer runs at this period and every sample is accumulated; each
+    // report then carries the mean/min/max of the whole refresh interval
+    // instead of one instantaneous reading taken at an arbitrary phase.
+    static constexpr uint32_t kOversamplePeriodSec = 1;
+    // Between reports every sample is also checked for a sharp change
+    // (cooking smoke, a window opened), which is published at once instead of
+    // up to a whole refresh period late. Without oversampling the sensor is
+    // still read at least this often so the watch has samples to look at;
+    // reports keep the configured cadence either way.
+    static constexpr uint32_t kChangeWatchPeriodSec = 10;
+    // Out-of-cycle reports are at least this far apart, so a fluctuating
+    // reading can't flood subscribers
+    static constexpr int32_t kFastReportMinIntervalSec = 30;
+    // Matter subscriptions are counted at this cadence
+    static constexpr int64_t kSubscriptionPollIntervalUs = 10 * 1000000LL;
+
+    // Applies the firmware's filter, fast-report and stable-band tables
+    AcquisitionCycle(MeasurementStore& store, Sinks& sinks);
+
+    // Sets the sampling mode and the refresh bounds (see
+    // AdaptiveScheduler::SetBounds()); the interval restarts at nowUs
+    void Configure(bool oversample, uint32_t refreshSec, uint32_t idleRefreshSec, int64_t nowUs);
+
+    // Runs one cycle at esp_timer time. Returns true when the report interval
+    // ended (a report was published, or had no data and was skipped).
+    bool Run(bool forceReport);
+
+    // The sensor timer period for a sampling mode and report period
+    static uint32_t SamplePeriodSec(bool oversample, uint32_t reportSec, bool stretched);
+
+    uint32_t GetReportPeriodSec() const { return m_adaptive.GetPeriodSec(); }
+    uint32_t GetSamplePeriodSec() const
+    {
+        return SamplePeriodSec(m_oversample, m_adaptive.GetPeriodSec(), m_adaptive.IsStretched());
+    }
+    bool IsOversampling() const { return m_oversample; }
+
+    // Samples the filter replaced since boot
+    uint32_t GetRejectedCount() const { return m_filter.GetRejectedCount(); }
+
+private:
+    // Records a report in the store, then tells the sinks
+    void PublishSnapshot(const MeasurementSnapshot& snapshot);
+    void CheckForFastReport(const MeasurementSnapshot& sample);
+
+    MeasurementStore& m_store;
+    Sinks& m_sinks;
+    SampleFilter m_filter;
+    SampleAccumulator m_accumulator;
+    ChangeWatch m_changeWatch;
+    AdaptiveScheduler m_adaptive;
+    bool m_oversample = false;
+    int64_t m_intervalStartUs = 0;
+    int64_t m_lastFastReportUs = 0;
+    int64_t m_lastSubscriptionPollUs = 0;
+};
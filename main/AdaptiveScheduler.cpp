@@ -0,0 +1,62 @@
+#include "AdaptiveScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdlib.h>
+
+void AdaptiveScheduler::SetBounds(uint32_t minSec, uint32_t maxSec)
+{
+    m_minSec = minSec;
+    m_maxSec = std::max(minSec, maxSec);
+    m_periodSec = minSec;
+    m_stableReports = 0;
+}
+
+void AdaptiveScheduler::SetStableBand(Sensor::MeasurementType type, float band)
+{
+    m_band[static_cast<size_t>(type)] = (int32_t)lroundf(band * Sensor::NativeScale(type));
+}
+
+bool AdaptiveScheduler::IsStable(const MeasurementSnapshot& report) const
+{
+    for (size_t i = 0; i < Sensor::kMeasurementTypeCount; i++) {
+        auto type = static_cast<Sensor::MeasurementType>(i);
+        if (m_band[i] <= 0 || !report.Has(type)) {
+            continue;
+        }
+        // A value the previous report lacked is news, not stability
+        if (!(m_lastMask & MeasurementSnapshot::Bit(type)) || abs(report.values[i] - m_last[i]) > m_band[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AdaptiveScheduler::OnReport(const MeasurementSnapshot& report, bool consumersIdle)
+{
+    bool stable = IsStable(report);
+    for (size_t i = 0; i < Sensor::kMeasurementTypeCount; i++) {
+        m_last[i] = report.values[i];
+    }
+    m_lastMask = report.validMask;
+
+    if (!stable || !consumersIdle) {
+        return Wake();
+    }
+    if (m_periodSec >= m_maxSec || ++m_stableReports < kStableReportsPerStep) {
+        return false;
+    }
+    m_stableReports = 0;
+    m_periodSec = std::min(m_periodSec * 2, m_maxSec);
+    return true;
+}
+
+bool AdaptiveScheduler::Wake()
+{
+    m_stableReports = 0;
+    if (m_periodSec == m_minSec) {
+        return false;
+    }
+    m_periodSec = m_minSec;
+    return true;
+}
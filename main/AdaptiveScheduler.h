@@ -0,0 +1,45 @@
+#pragma once
+
+#include "MeasurementSnapshot.h"
+#include <stdint.h>
+
+// Picks the report period between a floor (the user's refresh setting) and a
+// ceiling. While nobody needs fresh readings (values stable, display dark, no
+// Matter subscription) the period doubles after every few stable reports, up
+// to the ceiling; any activity drops it straight back to the floor.
+class AdaptiveScheduler
+{
+public:
+    // Stable reports in a row before each doubling of the period
+    static constexpr uint8_t kStableReportsPerStep = 3;
+
+    // Sets the bounds and restarts at minSec. A ceiling at or below the floor
+    // disables the adaptation.
+    void SetBounds(uint32_t minSec, uint32_t maxSec);
+
+    // A report counts as stable when every value with a band stays within
+    // band (in units) of the previous report. Types without a band are
+    // ignored.
+    void SetStableBand(Sensor::MeasurementType type, float band);
+
+    // Feeds one scheduled report. Returns true if the period changed.
+    bool OnReport(const MeasurementSnapshot& report, bool consumersIdle);
+
+    // Something needs fresh readings; back to the floor. Returns true if the
+    // period changed.
+    bool Wake();
+
+    uint32_t GetPeriodSec() const { return m_periodSec; }
+    bool IsStretched() const { return m_periodSec > m_minSec; }
+
+private:
+    bool IsStable(const MeasurementSnapshot& report) const;
+
+    int32_t m_band[Sensor::kMeasurementTypeCount] = {}; // native steps
+    int32_t m_last[Sensor::kMeasurementTypeCount] = {};
+    uint32_t m_lastMask = 0;
+    uint32_t m_minSec = 0;
+    uint32_t m_maxSec = 0;
+    uint32_t m_periodSec = 0;
+    uint8_t m_stableReports = 0;
+};
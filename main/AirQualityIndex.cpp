@@ -0,0 +1,88 @@
+#include "AirQualityIndex.h"
+
+#include <algorithm>
+
+namespace AirQualityIndex {
+
+Level ByCO2(int32_t co2Ppm)
+{
+    if (co2Ppm == MeasurementStore::kNoValue || co2Ppm < 400) {
+        // Below outdoor levels or no reading; sensor error or uninitialized state.
+        return Level::Unknown;
+    }
+    if (co2Ppm <= 600) {
+        // Fresh air, no noticeable effects; matches outdoor levels.
+        return Level::Good;
+    } else if (co2Ppm <= 700) {
+        // Still very good, no perceptible impact; minor ventilation decline.
+        return Level::Fair;
+    } else if (co2Ppm <= 800) {
+        // Suboptimal; sensitive individuals might notice slight stuffiness.
+        return Level::Moderate;
+    } else if (co2Ppm <= 950) {
+        // Mild effects possible (e.g., reduced focus); ventilation clearly poor.
+        return Level::Poor;
+    } else if (co2Ppm <= 1200) {
+        // Discomfort likely (e.g., stuffiness, drowsiness); significant air quality decline.
+        return Level::VeryPoor;
+    } else {
+        // Potential health impacts (e.g., fatigue, headaches); unacceptable levels.
+        return Level::ExtremelyPoor;
+    }
+}
+
+Level ByPM10(int32_t latest, int32_t average)
+{
+    // Compared in native steps (0.1 µg/m³)
+    constexpr int32_t ugm3 = Sensor::NativeScale(Sensor::MeasurementType::PM10p0);
+
+    if (latest == MeasurementStore::kNoValue || average < 0) {
+        return Level::Unknown;
+    }
+    if (average <= 30 * ugm3) {
+        return Level::Good;
+    } else if (average <= 60 * ugm3) {
+        return Level::Fair;
+    } else if (average <= 120 * ugm3) {
+        return Level::Moderate;
+    } else if (average <= 260 * ugm3) {
+        return Level::Poor;
+    } else if (average <= 400 * ugm3) {
+        return Level::VeryPoor;
+    } else {
+        return Level::ExtremelyPoor;
+    }
+}
+
+Level ByPM25(int32_t latest, int32_t average)
+{
+    // Compared in native steps (0.1 µg/m³)
+    constexpr int32_t ugm3 = Sensor::NativeScale(Sensor::MeasurementType::PM2p5);
+
+    if (latest == MeasurementStore::kNoValue || average < 0) {
+        return Level::Unknown;
+    }
+    if (average <= 15 * ugm3) {
+        return Level::Good;
+    } else if (average <= 30 * ugm3) {
+        return Level::Fair;
+    } else if (average <= 50 * ugm3) {
+        return Level::Moderate;
+    } else if (average <= 100 * ugm3) {
+        return Level::Poor;
+    } else if (average <= 150 * ugm3) {
+        return Level::VeryPoor;
+    } else {
+        return Level::ExtremelyPoor;
+    }
+}
+
+Level Classify(const MeasurementStore::Published& published)
+{
+    using Type = Sensor::MeasurementType;
+    return std::max({ByCO2(published.GetLatest(Type::CO2)),
+                     ByPM25(published.GetLatest(Type::PM2p5), published.GetAverage(Type::PM2p5)),
+                     ByPM10(published.GetLatest(Type::PM10p0), published.GetAverage(Type::PM10p0))});
+}
+
+} // namespace AirQualityIndex
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "MeasurementStore.h"
+#include <stdint.h>
+
+// The overall air-quality level shown by the LED and reported in the Matter
+// AirQuality cluster, from the published CO2 and PM readings. Kept apart from
+// the Matter endpoint so the thresholds can be checked on the host.
+namespace AirQualityIndex {
+
+// Same order and values as Matter's AirQuality::AirQualityEnum, so worse is
+// greater and Unknown loses to any real level
+enum class Level : uint8_t {
+    Unknown,
+    Good,
+    Fair,
+    Moderate,
+    Poor,
+    VeryPoor,
+    ExtremelyPoor,
+};
+
+// CO2 in whole ppm (its native steps). Unknown for kNoValue and below the
+// 400 ppm outdoor floor, which only a faulty or uninitialised sensor reads.
+Level ByCO2(int32_t co2Ppm);
+
+// PM2.5/PM10 window averages in native steps (0.1 µg/m³). Unknown while the
+// type has never had a value (latest is kNoValue; the average is then 0).
+Level ByPM25(int32_t latest, int32_t average);
+Level ByPM10(int32_t latest, int32_t average);
+
+// The worst of the CO2, PM2.5 and PM10 levels; Unknown when none is known
+Level Classify(const MeasurementStore::Published& published);
+
+} // namespace AirQualityIndex
@@ -0,0 +1,54 @@
+#include "AllocationProbe.h"
+
+#if CONFIG_ACQUISITION_ALLOCATION_CHECK
+
+#include <atomic>
+#include <stddef.h>
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace {
+
+std::atomic<TaskHandle_t> s_task{nullptr};
+std::atomic<uint32_t> s_count{0};
+
+} // namespace
+
+// Called by heap_caps for every allocation, in the allocating task
+extern "C" void esp_heap_trace_alloc_hook(void* ptr, size_t, uint32_t)
+{
+    TaskHandle_t task = s_task.load(std::memory_order_relaxed);
+    if (ptr != nullptr && task != nullptr && task == xTaskGetCurrentTaskHandle()) {
+        s_count.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+extern "C" void esp_heap_trace_free_hook(void*)
+{
+}
+
+void AllocationProbe::Begin()
+{
+    s_count = 0;
+    s_task = xTaskGetCurrentTaskHandle();
+}
+
+uint32_t AllocationProbe::End()
+{
+    s_task = nullptr;
+    return s_count;
+}
+
+#else
+
+void AllocationProbe::Begin()
+{
+}
+
+uint32_t AllocationProbe::End()
+{
+    return 0;
+}
+
+#endif // CONFIG_ACQUISITION_ALLOCATION_CHECK
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <sdkconfig.h>
+#include <stdint.h>
+
+// Counts the heap allocations one task makes between Begin() and End(), via
+// ESP-IDF's allocation hooks, to check that the steady-state acquisition path
+// never touches the heap. Built in with CONFIG_ACQUISITION_ALLOCATION_CHECK,
+// which turns on CONFIG_HEAP_USE_HOOKS; otherwise nothing is counted and End()
+// returns 0. One probe at a time.
+namespace AllocationProbe {
+
+#if CONFIG_ACQUISITION_ALLOCATION_CHECK
+constexpr bool kEnabled = true;
+#else
+constexpr bool kEnabled = false;
+#endif
+
+// Starts counting the calling task's allocations.
+void Begin();
+
+// Stops counting; returns the allocations made since Begin().
+uint32_t End();
+
+} // namespace AllocationProbe
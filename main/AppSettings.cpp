@@ -18,6 +18,16 @@ static uint32_t ValidRefresh(uint32_t value)
     return 60;
 }
 
+static uint32_t ValidIdleRefresh(uint32_t value)
+{
+    for (uint32_t choice : AppSettings::kIdleRefreshChoices) {
+        if (value == choice) {
+            return value;
+        }
+    }
+    return 600;
+}
+
 void AppSettings::Load()
 {
     nvs_handle_t handle;
@@ -43,10 +53,17 @@ void AppSettings::Load()
     if (nvs_get_u8(handle, "netlog", &u8) == ESP_OK) {
         netlogEnabled = u8 != 0;
     }
+    if (nvs_get_u8(handle, "oversamp", &u8) == ESP_OK) {
+        oversample = u8 != 0;
+    }
+    if (nvs_get_u32(handle, "idlerefr", &u32) == ESP_OK) {
+        idleRefreshSeconds = ValidIdleRefresh(u32);
+    }
     nvs_close(handle);
 
-    ESP_LOGI(TAG, "Loaded: refresh %us, altitude %um, rotate %us (%s)",
-             (unsigned)refreshSeconds, altitudeMeters, rotateSeconds, autoRotate ? "on" : "off");
+    ESP_LOGI(TAG, "Loaded: refresh %us%s (idle %us), altitude %um, rotate %us (%s)",
+             (unsigned)refreshSeconds, oversample ? " (1 Hz averaged)" : "", (unsigned)idleRefreshSeconds,
+             altitudeMeters, rotateSeconds, autoRotate ? "on" : "off");
 }
 
 void AppSettings::Save() const
@@ -63,6 +80,8 @@ void AppSettings::Save() const
     nvs_set_u8(handle, "rotate", rotateSeconds);
     nvs_set_u8(handle, "autorot", autoRotate ? 1 : 0);
     nvs_set_u8(handle, "netlog", netlogEnabled ? 1 : 0);
+    nvs_set_u8(handle, "oversamp", oversample ? 1 : 0);
+    nvs_set_u32(handle, "idlerefr", idleRefreshSeconds);
 
     err = nvs_commit(handle);
     if (err != ESP_OK) {
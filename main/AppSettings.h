@@ -6,6 +6,8 @@
 // on the LCD settings page. A factory reset erases them like the rest of NVS.
 struct AppSettings {
     static constexpr uint32_t kRefreshChoices[] = {10, 30, 60, 120, 300};
+    // Ceilings for the adaptive refresh; 0 keeps the refresh fixed
+    static constexpr uint32_t kIdleRefreshChoices[] = {0, 300, 600, 1800};
     static constexpr uint16_t kAltitudeMaxMeters = 3000; // SEN66 valid range
     static constexpr uint16_t kAltitudeStepMeters = 25;
     static constexpr uint8_t kRotateMinSec = 3;
@@ -16,6 +18,8 @@ struct AppSettings {
     uint8_t rotateSeconds = 7;    // display auto-rotation period
     bool autoRotate = true;
     bool netlogEnabled = false;   // stream logs over Thread (debug), off by default
+    bool oversample = true;       // sample at 1 Hz and report the interval mean/min/max
+    uint32_t idleRefreshSeconds = 600; // longest refresh while nothing needs readings, one of kIdleRefreshChoices
 
     void Load();
     void Save() const;
@@ -0,0 +1,66 @@
+#include "ChangeWatch.h"
+#include <cmath>
+#include <stdlib.h>
+
+void ChangeWatch::SetThreshold(Sensor::MeasurementType type, float jump, float slopePerMinute)
+{
+    size_t i = static_cast<size_t>(type);
+    m_jump[i] = (int32_t)lroundf(jump * Sensor::NativeScale(type));
+    m_slope[i] = (int32_t)lroundf(slopePerMinute * Sensor::NativeScale(type));
+}
+
+void ChangeWatch::SetBaseline(const MeasurementSnapshot& reported)
+{
+    for (size_t i = 0; i < Sensor::kMeasurementTypeCount; i++) {
+        if (reported.Has(static_cast<Sensor::MeasurementType>(i))) {
+            m_baseline[i] = reported.values[i];
+        }
+    }
+    m_baselineMask |= reported.validMask;
+}
+
+bool ChangeWatch::Check(const MeasurementSnapshot& sample, Sensor::MeasurementType& trigger)
+{
+    bool tripped = false;
+
+    for (size_t i = 0; i < Sensor::kMeasurementTypeCount; i++) {
+        auto type = static_cast<Sensor::MeasurementType>(i);
+        uint32_t bit = MeasurementSnapshot::Bit(type);
+        if (!sample.Has(type) || (m_jump[i] <= 0 && m_slope[i] <= 0)) {
+            continue;
+        }
+        int32_t value = sample.values[i];
+        bool hit = false;
+
+        if (m_jump[i] > 0 && (m_baselineMask & bit) && abs(value - m_baseline[i]) >= m_jump[i]) {
+            hit = true;
+        }
+
+        // The slope reference moves once per window, whether or not it trips
+        if (!(m_slopeRefMask & bit)) {
+            m_slopeRef[i] = value;
+            m_slopeRefUs[i] = sample.timestampUs;
+            m_slopeRefMask |= bit;
+        } else if (sample.timestampUs - m_slopeRefUs[i] >= kSlopeWindowUs) {
+            // |change| / minutes >= slope, without dividing
+            int64_t elapsedUs = sample.timestampUs - m_slopeRefUs[i];
+            if (m_slope[i] > 0 && (int64_t)abs(value - m_slopeRef[i]) * 60000000 >= (int64_t)m_slope[i] * elapsedUs) {
+                hit = true;
+            }
+            m_slopeRef[i] = value;
+            m_slopeRefUs[i] = sample.timestampUs;
+        }
+
+        if (hit && !tripped) {
+            trigger = type;
+            tripped = true;
+        }
+    }
+    return tripped;
+}
+
+void ChangeWatch::Reset()
+{
+    m_baselineMask = 0;
+    m_slopeRefMask = 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "MeasurementSnapshot.h"
+#include <stdint.h>
+
+// Watches the samples taken between two scheduled reports for sudden changes
+// (a jump away from the last reported value, or a steep slope) so they can be
+// reported right away instead of at the next refresh. Fixed size: a baseline
+// and one slope reference per measurement type.
+class ChangeWatch
+{
+public:
+    // Trips when a value moves at least jump away from the last reported one,
+    // or changes by at least slopePerMinute per minute over the slope window.
+    // Zero disables either check; all types start disabled. Thresholds are in
+    // units and kept in native steps, so checking a sample is integer-only.
+    void SetThreshold(Sensor::MeasurementType type, float jump, float slopePerMinute);
+
+    // Remembers what consumers were last given; jumps are measured from it
+    void SetBaseline(const MeasurementSnapshot& reported);
+
+    // Feeds one sample. Returns true and the first type that tripped when the
+    // sample differs sharply enough from what was last reported.
+    bool Check(const MeasurementSnapshot& sample, Sensor::MeasurementType& trigger);
+
+    void Reset();
+
+    // Slopes are measured over at least this long, so one noisy 1 Hz sample
+    // can't fake a steep trend
+    static constexpr int64_t kSlopeWindowUs = 30 * 1000000LL;
+
+private:
+    int32_t m_jump[Sensor::kMeasurementTypeCount] = {};
+    int32_t m_slope[Sensor::kMeasurementTypeCount] = {}; // steps per minute
+    int32_t m_baseline[Sensor::kMeasurementTypeCount] = {};
+    int32_t m_slopeRef[Sensor::kMeasurementTypeCount] = {};
+    int64_t m_slopeRefUs[Sensor::kMeasurementTypeCount] = {};
+    uint32_t m_baselineMask = 0;
+    uint32_t m_slopeRefMask = 0;
+};
@@ -0,0 +1,158 @@
+#include "HistoryLog.h"
+#include <esp_log.h>
+#include <algorithm>
+#include <esp_rom_crc.h>
+#include <string.h>
+
+static const char *TAG = "HistoryLog";
+
+uint16_t HistoryLog::RecordCrc(const Record& record)
+{
+    return esp_rom_crc16_le(0, reinterpret_cast<const uint8_t*>(&record), offsetof(Record, crc));
+}
+
+uint16_t HistoryLog::EncodeValue(Sensor::MeasurementType type, int32_t value)
+{
+    if (Sensor::IsSigned(type)) {
+        return value == Sensor::kNoValue ? 0x8000 : (uint16_t)(int16_t)std::clamp<int32_t>(value, -32767, 32767);
+    }
+    return value == Sensor::kNoValue ? 0xFFFF : (uint16_t)std::clamp<int32_t>(value, 0, 65534);
+}
+
+int32_t HistoryLog::DecodeValue(Sensor::MeasurementType type, uint16_t code)
+{
+    if (Sensor::IsSigned(type)) {
+        return code == 0x8000 ? Sensor::kNoValue : (int16_t)code;
+    }
+    return code == 0xFFFF ? Sensor::kNoValue : code;
+}
+
+bool HistoryLog::ReadHeader(size_t sector, SectorHeader& header) const
+{
+    if (esp_partition_read(m_partition, sector * kSectorSize, &header, sizeof(header)) != ESP_OK) {
+        return false;
+    }
+    return header.magic == kMagic && header.version == kVersion && header.recordSize == sizeof(Record) &&
+           header.crc == esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(&header), offsetof(SectorHeader, crc));
+}
+
+bool HistoryLog::IsSlotErased(size_t sector, size_t slot) const
+{
+    uint32_t words[sizeof(Record) / 4];
+    if (esp_partition_read(m_partition, RecordOffset(sector, slot), words, sizeof(words)) != ESP_OK) {
+        return false;
+    }
+    for (uint32_t word : words) {
+        if (word != 0xFFFFFFFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool HistoryLog::StartSector(size_t sector, uint32_t sequence)
+{
+    if (esp_partition_erase_range(m_partition, sector * kSectorSize, kSectorSize) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to erase sector %u", (unsigned)sector);
+        return false;
+    }
+    m_sectorErases++;
+
+    SectorHeader header = {kMagic, sequence, kVersion, sizeof(Record), 0};
+    header.crc = esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(&header), offsetof(SectorHeader, crc));
+    if (esp_partition_write(m_partition, sector * kSectorSize, &header, sizeof(header)) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to write the header of sector %u", (unsigned)sector);
+        return false;
+    }
+    m_bytesWritten += sizeof(header);
+
+    m_headSector = sector;
+    m_headSlot = 0;
+    m_headSequence = sequence;
+    return true;
+}
+
+bool HistoryLog::Init(const char* partitionLabel)
+{
+    const esp_partition_t* partition =
+        esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, partitionLabel);
+    if (partition == nullptr || partition->size < 2 * kSectorSize) {
+        ESP_LOGW(TAG, "No '%s' partition; history will not survive a reboot", partitionLabel);
+        return false;
+    }
+    m_partition = partition;
+    m_sectorCount = partition->size / kSectorSize;
+
+    // The head is the valid sector with the highest sequence number
+    bool found = false;
+    for (size_t sector = 0; sector < m_sectorCount; sector++) {
+        SectorHeader header;
+        if (ReadHeader(sector, header) && (!found || (int32_t)(header.sequence - m_headSequence) > 0)) {
+            m_headSector = sector;
+            m_headSequence = header.sequence;
+            found = true;
+        }
+    }
+    if (!found) {
+        ESP_LOGI(TAG, "Formatting %u sectors", (unsigned)m_sectorCount);
+        if (!StartSector(0, 1)) {
+            m_partition = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    // Records fill a sector in order, so the written slots come first; a
+    // torn record is not erased and counts as written
+    size_t low = 0;
+    size_t high = kRecordsPerSector;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (IsSlotErased(m_headSector, mid)) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    m_headSlot = low;
+    ESP_LOGI(TAG, "Head at sector %u slot %u (sequence %u)", (unsigned)m_headSector, (unsigned)m_headSlot,
+             (unsigned)m_headSequence);
+    return true;
+}
+
+bool HistoryLog::Append(Record* records, size_t count)
+{
+    if (!IsReady()) {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        records[i].crc = RecordCrc(records[i]);
+    }
+
+    while (count > 0) {
+        if (m_headSlot == kRecordsPerSector &&
+            !StartSector((m_headSector + 1) % m_sectorCount, m_headSequence + 1)) {
+            return false;
+        }
+        size_t batch = kRecordsPerSector - m_headSlot;
+        if (batch > count) {
+            batch = count;
+        }
+        if (esp_partition_write(m_partition, RecordOffset(m_headSector, m_headSlot), records,
+                                batch * sizeof(Record)) != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to write %u record(s)", (unsigned)batch);
+            return false;
+        }
+        m_bytesWritten += batch * sizeof(Record);
+        m_headSlot += batch;
+        records += batch;
+        count -= batch;
+    }
+    return true;
+}
+
+size_t HistoryLog::GetCapacity() const
+{
+    // The head sector is erased whole once the ring wraps
+    return m_sectorCount > 0 ? (m_sectorCount - 1) * kRecordsPerSector : 0;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "sensors/Sensor.h"
+#include <esp_partition.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Append-only log of hourly rollup records in a dedicated flash partition,
+// so the long-term history survives reboots and OTA updates.
+//
+// The partition is a ring of erase sectors. Each sector starts with a header
+// carrying a sequence number that grows by one per sector written, followed
+// by fixed 16-byte records, each with its own CRC. Records are only ever
+// appended to the head sector; when it is full the next sector (the oldest)
+// is erased and becomes the head, so every sector is erased equally often.
+// At boot the head is found from the sector headers plus a binary search for
+// the first erased slot: O(sectors + log(records per sector)) small reads,
+// whatever the log holds. A record torn by a power cut fails its CRC and is
+// skipped.
+class HistoryLog
+{
+public:
+    // One hourly rollup cell of one measurement type, values at the type's
+    // Sensor::NativeScale() packed by EncodeValue()
+    struct Record {
+        uint32_t hour;   // hours since the history began
+        uint8_t type;    // Sensor::MeasurementType
+        uint8_t reserved;
+        uint16_t count;  // samples aggregated (saturates)
+        uint16_t mean;
+        uint16_t min;
+        uint16_t max;
+        uint16_t crc;    // over the bytes above
+    };
+    static_assert(sizeof(Record) == 16, "records are 16 bytes");
+
+    // Packs a value in native steps into a record field with the ranges
+    // MeasuredValues stores: 0-65534 for unsigned types, so CO2 keeps its
+    // 40000 ppm, and -32767..32767 as int16 for signed ones. kNoValue packs
+    // to 0xFFFF (unsigned) or 0x8000 (signed); other values are clamped.
+    static uint16_t EncodeValue(Sensor::MeasurementType type, int32_t value);
+    static int32_t DecodeValue(Sensor::MeasurementType type, uint16_t code);
+
+    // Finds the partition by label and recovers the write position. Returns
+    // false (and the log stays disabled) if there is no usable partition.
+    bool Init(const char* partitionLabel);
+
+    bool IsReady() const { return m_partition != nullptr; }
+
+    // Appends records in as few flash writes as possible; their crc is
+    // filled in here. Returns false on a flash error.
+    bool Append(Record* records, size_t count);
+
+    // Calls fn(const Record&) for every intact record, oldest first
+    template <typename Fn>
+    void ForEach(Fn fn) const;
+
+    // Records the log can hold before the oldest are overwritten
+    size_t GetCapacity() const;
+
+    // Flash traffic since boot, to check the wear budget
+    uint32_t GetBytesWritten() const { return m_bytesWritten; }
+    uint32_t GetSectorErases() const { return m_sectorErases; }
+
+private:
+    struct SectorHeader {
+        uint32_t magic;
+        uint32_t sequence;
+        uint16_t version;
+        uint16_t recordSize;
+        uint32_t crc; // over the bytes above
+    };
+    static_assert(sizeof(SectorHeader) == sizeof(Record), "the header takes one record slot");
+
+    static constexpr uint32_t kMagic = 0x474C5148; // "HQLG"
+    static constexpr uint16_t kVersion = 1;
+    static constexpr size_t kSectorSize = 4096;
+    static constexpr size_t kRecordsPerSector = kSectorSize / sizeof(Record) - 1;
+
+    bool ReadHeader(size_t sector, SectorHeader& header) const;
+    bool IsSlotErased(size_t sector, size_t slot) const;
+    bool StartSector(size_t sector, uint32_t sequence);
+    size_t RecordOffset(size_t sector, size_t slot) const
+    {
+        return sector * kSectorSize + (slot + 1) * sizeof(Record);
+    }
+    static uint16_t RecordCrc(const Record& record);
+
+    const esp_partition_t* m_partition = nullptr;
+    size_t m_sectorCount = 0;
+    size_t m_headSector = 0;
+    size_t m_headSlot = 0;     // next free record slot in the head sector
+    uint32_t m_headSequence = 0;
+    uint32_t m_bytesWritten = 0;
+    uint32_t m_sectorErases = 0;
+};
+
+template <typename Fn>
+void HistoryLog::ForEach(Fn fn) const
+{
+    if (!IsReady()) {
+        return;
+    }
+    // Oldest sector first: the one after the head, around the ring
+    for (size_t n = 1; n <= m_sectorCount; n++) {
+        size_t sector = (m_headSector + n) % m_sectorCount;
+        SectorHeader header;
+        if (!ReadHeader(sector, header)) {
+            continue;
+        }
+        size_t used = sector == m_headSector ? m_headSlot : kRecordsPerSector;
+        Record batch[16];
+        for (size_t slot = 0; slot < used; slot += 16) {
+            size_t count = used - slot < 16 ? used - slot : 16;
+            if (esp_partition_read(m_partition, RecordOffset(sector, slot), batch, count * sizeof(Record)) != ESP_OK) {
+                break;
+            }
+            for (size_t i = 0; i < count; i++) {
+                if (batch[i].crc == RecordCrc(batch[i])) {
+                    fn(batch[i]);
+                }
+            }
+        }
+    }
+}
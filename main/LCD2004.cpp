@@ -126,7 +126,7 @@ void LCD2004::Clear()
     vTaskDelay(pdMS_TO_TICKS(2)); // clear needs ~1.5 ms
 }
 
-void LCD2004::WriteLine(int row, const std::string& text)
+void LCD2004::WriteLine(int row, const char* text)
 {
     static constexpr uint8_t kRowOffsets[kRows] = {0x00, 0x40, 0x14, 0x54};
 
@@ -136,7 +136,7 @@ void LCD2004::WriteLine(int row, const std::string& text)
 
     Command(0x80 | kRowOffsets[row]);
     for (int i = 0; i < kColumns; i++) {
-        char c = i < static_cast<int>(text.size()) ? text[i] : ' ';
+        char c = *text != '\0' ? *text++ : ' ';
         WriteByte(static_cast<uint8_t>(c), true);
     }
 }
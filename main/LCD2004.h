@@ -1,7 +1,7 @@
 #pragma once
 
 #include <driver/i2c_master.h>
-#include <string>
+#include <stdint.h>
 
 // 2004A 20x4 character LCD (HD44780) behind a PCF8574 I2C backpack (HW-61)
 class LCD2004
@@ -15,7 +15,7 @@ public:
     static LCD2004* Create(i2c_master_bus_handle_t bus);
 
     // Writes text on the given row (0-3), padded/truncated to 20 columns
-    void WriteLine(int row, const std::string& text);
+    void WriteLine(int row, const char* text);
 
     void Clear();
 
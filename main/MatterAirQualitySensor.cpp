@@ -1,4 +1,7 @@
 #include "MatterAirQualitySensor.h"
+#include "AirQualityIndex.h"
+#include "MatterUnits.h"
+#include "TextRow.h"
 
 #include <esp_err.h>
 #include <esp_log.h>
@@ -13,26 +16,41 @@ using namespace chip::app::Clusters;
 
 static const char *TAG = "MatterAirQualitySensor";
 
-const std::unordered_map<AirQualitySensor::MeasurementType, uint32_t> MatterAirQualitySensor::measurementTypeToClusterId = {
-    {Sensor::MeasurementType::RelativeHumidity, RelativeHumidityMeasurement::Id},
-    {Sensor::MeasurementType::Temperature, TemperatureMeasurement::Id},
-    {Sensor::MeasurementType::CO2, CarbonDioxideConcentrationMeasurement::Id},
-    {Sensor::MeasurementType::NOx, NitrogenDioxideConcentrationMeasurement::Id},
-    {Sensor::MeasurementType::VOC, TotalVolatileOrganicCompoundsConcentrationMeasurement::Id},
-    {Sensor::MeasurementType::PM1p0, Pm1ConcentrationMeasurement::Id},
-    {Sensor::MeasurementType::PM2p5, Pm25ConcentrationMeasurement::Id},
-    {Sensor::MeasurementType::PM10p0, Pm10ConcentrationMeasurement::Id}
-};
-
-MatterAirQualitySensor::MatterAirQualitySensor(endpoint_t* endpoint, std::shared_ptr<AirQualitySensor> airQualitySensor, std::shared_ptr<MatterExtendedColorLight> lightEndpoint)
-        : MatterSensorBase(endpoint, "MatterAirQualitySensor"), m_airQualitySensor(airQualitySensor), m_lightEndpoint(lightEndpoint)
+static_assert(static_cast<uint8_t>(AirQualityIndex::Level::Unknown) == static_cast<uint8_t>(AirQualityEnum::kUnknown) &&
+              static_cast<uint8_t>(AirQualityIndex::Level::Good) == static_cast<uint8_t>(AirQualityEnum::kGood) &&
+              static_cast<uint8_t>(AirQualityIndex::Level::ExtremelyPoor) == static_cast<uint8_t>(AirQualityEnum::kExtremelyPoor),
+              "AirQualityIndex::Level must mirror AirQualityEnum");
+
+constexpr uint32_t MatterAirQualitySensor::ClusterIdFor(AirQualitySensor::MeasurementType type)
+{
+    switch (type) {
+    case Sensor::MeasurementType::RelativeHumidity: return RelativeHumidityMeasurement::Id;
+    case Sensor::MeasurementType::Temperature:      return TemperatureMeasurement::Id;
+    case Sensor::MeasurementType::CO2:              return CarbonDioxideConcentrationMeasurement::Id;
+    case Sensor::MeasurementType::NOx:              return NitrogenDioxideConcentrationMeasurement::Id;
+    case Sensor::MeasurementType::VOC:              return TotalVolatileOrganicCompoundsConcentrationMeasurement::Id;
+    case Sensor::MeasurementType::PM1p0:            return Pm1ConcentrationMeasurement::Id;
+    case Sensor::MeasurementType::PM2p5:            return Pm25ConcentrationMeasurement::Id;
+    case Sensor::MeasurementType::PM10p0:           return Pm10ConcentrationMeasurement::Id;
+    default:                                        return 0; // e.g. PM4: Matter has no cluster for it
+    }
+}
+
+bool MatterAirQualitySensor::IsReported(AirQualitySensor::MeasurementType type) const
+{
+    return (m_reportedMask & Sensor::MaskOf(type)) != 0;
+}
+
+MatterAirQualitySensor::MatterAirQualitySensor(endpoint_t* endpoint, std::shared_ptr<AirQualitySensor> airQualitySensor, std::shared_ptr<MatterExtendedColorLight> lightEndpoint, std::shared_ptr<MeasurementStore> store)
+        : MatterSensorBase(endpoint, "MatterAirQualitySensor"), m_airQualitySensor(airQualitySensor), m_lightEndpoint(lightEndpoint), m_store(store)
 {
 }
 
 std::shared_ptr<MatterAirQualitySensor> MatterAirQualitySensor::CreateEndpoint(
     std::shared_ptr<MatterNode> matterNode,
     std::shared_ptr<AirQualitySensor> airQualitySensor,
-    std::shared_ptr<MatterExtendedColorLight> lightEndpoint)
+    std::shared_ptr<MatterExtendedColorLight> lightEndpoint,
+    std::shared_ptr<MeasurementStore> store)
 {
     // Create Air Quality Endpoint
     esp_matter::endpoint::air_quality_sensor::config_t air_quality_config;
@@ -41,38 +59,33 @@ std::shared_ptr<MatterAirQualitySensor> MatterAirQualitySensor::CreateEndpoint(
     endpoint_t* endpoint = air_quality_sensor::create(matterNode->GetNode(), &air_quality_config, ENDPOINT_FLAG_NONE, NULL);
     ABORT_APP_ON_FAILURE(endpoint != nullptr, ESP_LOGE(TAG, "Failed to create air quality sensor endpoint"));
 
-    auto matterAirQulitySensor = std::shared_ptr<MatterAirQualitySensor>(new MatterAirQualitySensor(endpoint, airQualitySensor, lightEndpoint));
+    auto matterAirQulitySensor = std::shared_ptr<MatterAirQualitySensor>(new MatterAirQualitySensor(endpoint, airQualitySensor, lightEndpoint, store));
     matterNode->AddEndpoint(matterAirQulitySensor);
 
     matterAirQulitySensor->AddAirQualityClusterFeatures();
 
-    // Add Concentration Measurement Clusters
-    std::set<AirQualitySensor::MeasurementType> supportedMeasurements = airQualitySensor->GetSupportedMeasurements();
-
-    // Add Concentration Measurement Clusters based on supported measurements
-    if (supportedMeasurements.count(AirQualitySensor::MeasurementType::RelativeHumidity)) {
-        matterAirQulitySensor->AddRelativeHumidityMeasurementCluster();
-    }
-    if (supportedMeasurements.count(AirQualitySensor::MeasurementType::Temperature)) {
-        matterAirQulitySensor->AddTemperatureMeasurementCluster();
-    }
-    if (supportedMeasurements.count(AirQualitySensor::MeasurementType::CO2)) {
-        matterAirQulitySensor->AddCarbonDioxideConcentrationMeasurementCluster();
-    }
-    if (supportedMeasurements.count(AirQualitySensor::MeasurementType::PM1p0)) {
-        matterAirQulitySensor->AddPm1ConcentrationMeasurementCluster();
-    }
-    if (supportedMeasurements.count(AirQualitySensor::MeasurementType::PM2p5)) {
-        matterAirQulitySensor->AddPm25ConcentrationMeasurementCluster();
-    }
-    if (supportedMeasurements.count(AirQualitySensor::MeasurementType::PM10p0)) {
-        matterAirQulitySensor->AddPm10ConcentrationMeasurementCluster();
-    }
-    if (supportedMeasurements.count(AirQualitySensor::MeasurementType::NOx)) {
-        matterAirQulitySensor->AddNitrogenDioxideConcentrationMeasurementCluster();
-    }
-    if (supportedMeasurements.count(AirQualitySensor::MeasurementType::VOC)) {
-        matterAirQulitySensor->AddTotalVolatileOrganicCompoundsConcentrationMeasurementCluster();
+    // Add a measurement cluster for each type the sensor model supports
+    using Type = AirQualitySensor::MeasurementType;
+    struct ClusterAdder {
+        Type type;
+        void (MatterAirQualitySensor::*add)();
+    };
+    static constexpr ClusterAdder kClusterAdders[] = {
+        {Type::RelativeHumidity, &MatterAirQualitySensor::AddRelativeHumidityMeasurementCluster},
+        {Type::Temperature,      &MatterAirQualitySensor::AddTemperatureMeasurementCluster},
+        {Type::CO2,              &MatterAirQualitySensor::AddCarbonDioxideConcentrationMeasurementCluster},
+        {Type::PM1p0,            &MatterAirQualitySensor::AddPm1ConcentrationMeasurementCluster},
+        {Type::PM2p5,            &MatterAirQualitySensor::AddPm25ConcentrationMeasurementCluster},
+        {Type::PM10p0,           &MatterAirQualitySensor::AddPm10ConcentrationMeasurementCluster},
+        {Type::NOx,              &MatterAirQualitySensor::AddNitrogenDioxideConcentrationMeasurementCluster},
+        {Type::VOC,              &MatterAirQualitySensor::AddTotalVolatileOrganicCompoundsConcentrationMeasurementCluster},
+    };
+    const AirQualitySensor::Capabilities& capabilities = airQualitySensor->GetCapabilities();
+    for (const ClusterAdder& adder : kClusterAdders) {
+        if (capabilities.Supports(adder.type)) {
+            (matterAirQulitySensor.get()->*adder.add)();
+            matterAirQulitySensor->m_reportedMask |= Sensor::MaskOf(adder.type);
+        }
     }
 
     return matterAirQulitySensor;
@@ -80,7 +93,7 @@ std::shared_ptr<MatterAirQualitySensor> MatterAirQualitySensor::CreateEndpoint(
 
 void MatterAirQualitySensor::AddRelativeHumidityMeasurementCluster()
 {
-    m_measurements.AddId(RelativeHumidityMeasurement::Id, 60, 60);
+    m_store->TrackWindows(AirQualitySensor::MeasurementType::RelativeHumidity, 60, 60);
 
     esp_matter::cluster::relative_humidity_measurement::config_t relative_humidity_config;
     esp_matter::cluster::relative_humidity_measurement::create(m_endpoint, &relative_humidity_config, CLUSTER_FLAG_SERVER);
@@ -88,7 +101,7 @@ void MatterAirQualitySensor::AddRelativeHumidityMeasurementCluster()
 
 void MatterAirQualitySensor::AddTemperatureMeasurementCluster()
 {
-    m_measurements.AddId(TemperatureMeasurement::Id, 60, 60);
+    m_store->TrackWindows(AirQualitySensor::MeasurementType::Temperature, 60, 60);
 
     // Add TemperatureMeasurement cluster
     cluster::temperature_measurement::config_t cluster_config;
@@ -97,7 +110,7 @@ void MatterAirQualitySensor::AddTemperatureMeasurementCluster()
 
 void MatterAirQualitySensor::AddCarbonDioxideConcentrationMeasurementCluster()
 {
-    m_measurements.AddId(CarbonDioxideConcentrationMeasurement::Id, 3600, 3600);
+    m_store->TrackWindows(AirQualitySensor::MeasurementType::CO2, 3600, 3600);
 
     // Enable the NumericMeasurement (MEA), AverageMeasurement (AVG) and PeakMeasurement (PEA)
     // features; create() validates the flags and adds the features from the config
@@ -107,14 +120,14 @@ void MatterAirQualitySensor::AddCarbonDioxideConcentrationMeasurementCluster()
                                    cluster::carbon_dioxide_concentration_measurement::feature::average_measurement::get_id() |
                                    cluster::carbon_dioxide_concentration_measurement::feature::peak_measurement::get_id();
     cluster_config.features.numeric_measurement.measurement_unit = static_cast<uint8_t>(CarbonDioxideConcentrationMeasurement::MeasurementUnitEnum::kPpm);
-    cluster_config.features.average_measurement.average_measured_value_window = m_measurements.GetAverageWindowSizeSeconds(CarbonDioxideConcentrationMeasurement::Id);
-    cluster_config.features.peak_measurement.peak_measured_value_window = m_measurements.GetPeakWindowSizeSeconds(CarbonDioxideConcentrationMeasurement::Id);
+    cluster_config.features.average_measurement.average_measured_value_window = m_store->GetAverageWindowSizeSeconds(AirQualitySensor::MeasurementType::CO2);
+    cluster_config.features.peak_measurement.peak_measured_value_window = m_store->GetPeakWindowSizeSeconds(AirQualitySensor::MeasurementType::CO2);
     esp_matter::cluster::carbon_dioxide_concentration_measurement::create(m_endpoint, &cluster_config, CLUSTER_FLAG_SERVER);
 }
 
 void MatterAirQualitySensor::AddPm1ConcentrationMeasurementCluster()
 {
-    m_measurements.AddId(Pm1ConcentrationMeasurement::Id, 3600, 3600);
+    m_store->TrackWindows(AirQualitySensor::MeasurementType::PM1p0, 3600, 3600);
 
     // Enable the NumericMeasurement (MEA), AverageMeasurement (AVG) and PeakMeasurement (PEA)
     // features; create() validates the flags and adds the features from the config
@@ -124,14 +137,14 @@ void MatterAirQualitySensor::AddPm1ConcentrationMeasurementCluster()
                                    cluster::pm1_concentration_measurement::feature::average_measurement::get_id() |
                                    cluster::pm1_concentration_measurement::feature::peak_measurement::get_id();
     cluster_config.features.numeric_measurement.measurement_unit = static_cast<uint8_t>(Pm1ConcentrationMeasurement::MeasurementUnitEnum::kUgm3);
-    cluster_config.features.average_measurement.average_measured_value_window = m_measurements.GetAverageWindowSizeSeconds(Pm1ConcentrationMeasurement::Id);
-    cluster_config.features.peak_measurement.peak_measured_value_window = m_measurements.GetPeakWindowSizeSeconds(Pm1ConcentrationMeasurement::Id);
+    cluster_config.features.average_measurement.average_measured_value_window = m_store->GetAverageWindowSizeSeconds(AirQualitySensor::MeasurementType::PM1p0);
+    cluster_config.features.peak_measurement.peak_measured_value_window = m_store->GetPeakWindowSizeSeconds(AirQualitySensor::MeasurementType::PM1p0);
     esp_matter::cluster::pm1_concentration_measurement::create(m_endpoint, &cluster_config, CLUSTER_FLAG_SERVER);
 }
 
 void MatterAirQualitySensor::AddPm25ConcentrationMeasurementCluster()
 {
-    m_measurements.AddId(Pm25ConcentrationMeasurement::Id, 3600, 3600);
+    m_store->TrackWindows(AirQualitySensor::MeasurementType::PM2p5, 3600, 3600);
 
     // Enable the NumericMeasurement (MEA), AverageMeasurement (AVG) and PeakMeasurement (PEA)
     // features; create() validates the flags and adds the features from the config
@@ -141,14 +154,14 @@ void MatterAirQualitySensor::AddPm25ConcentrationMeasurementCluster()
                                    cluster::pm25_concentration_measurement::feature::average_measurement::get_id() |
                                    cluster::pm25_concentration_measurement::feature::peak_measurement::get_id();
     cluster_config.features.numeric_measurement.measurement_unit = static_cast<uint8_t>(Pm25ConcentrationMeasurement::MeasurementUnitEnum::kUgm3);
-    cluster_config.features.average_measurement.average_measured_value_window = m_measurements.GetAverageWindowSizeSeconds(Pm25ConcentrationMeasurement::Id);
-    cluster_config.features.peak_measurement.peak_measured_value_window = m_measurements.GetPeakWindowSizeSeconds(Pm25ConcentrationMeasurement::Id);
+    cluster_config.features.average_measurement.average_measured_value_window = m_store->GetAverageWindowSizeSeconds(AirQualitySensor::MeasurementType::PM2p5);
+    cluster_config.features.peak_measurement.peak_measured_value_window = m_store->GetPeakWindowSizeSeconds(AirQualitySensor::MeasurementType::PM2p5);
     esp_matter::cluster::pm25_concentration_measurement::create(m_endpoint, &cluster_config, CLUSTER_FLAG_SERVER);
 }
 
 void MatterAirQualitySensor::AddPm10ConcentrationMeasurementCluster()
 {
-    m_measurements.AddId(Pm10ConcentrationMeasurement::Id, 3600, 3600);
+    m_store->TrackWindows(AirQualitySensor::MeasurementType::PM10p0, 3600, 3600);
 
     // Enable the NumericMeasurement (MEA), AverageMeasurement (AVG) and PeakMeasurement (PEA)
     // features; create() validates the flags and adds the features from the config
@@ -158,14 +171,14 @@ void MatterAirQualitySensor::AddPm10ConcentrationMeasurementCluster()
                                    cluster::pm10_concentration_measurement::feature::average_measurement::get_id() |
                                    cluster::pm10_concentration_measurement::feature::peak_measurement::get_id();
     cluster_config.features.numeric_measurement.measurement_unit = static_cast<uint8_t>(Pm10ConcentrationMeasurement::MeasurementUnitEnum::kUgm3);
-    cluster_config.features.average_measurement.average_measured_value_window = m_measurements.GetAverageWindowSizeSeconds(Pm10ConcentrationMeasurement::Id);
-    cluster_config.features.peak_measurement.peak_measured_value_window = m_measurements.GetPeakWindowSizeSeconds(Pm10ConcentrationMeasurement::Id);
+    cluster_config.features.average_measurement.average_measured_value_window = m_store->GetAverageWindowSizeSeconds(AirQualitySensor::MeasurementType::PM10p0);
+    cluster_config.features.peak_measurement.peak_measured_value_window = m_store->GetPeakWindowSizeSeconds(AirQualitySensor::MeasurementType::PM10p0);
     esp_matter::cluster::pm10_concentration_measurement::create(m_endpoint, &cluster_config, CLUSTER_FLAG_SERVER);
 }
 
 void MatterAirQualitySensor::AddNitrogenDioxideConcentrationMeasurementCluster()
 {
-    m_measurements.AddId(NitrogenDioxideConcentrationMeasurement::Id, 3600.0, 3600);
+    m_store->TrackWindows(AirQualitySensor::MeasurementType::NOx, 3600, 3600);
 
     // Enable the NumericMeasurement (MEA), AverageMeasurement (AVG) and PeakMeasurement (PEA)
     // features; create() validates the flags and adds the features from the config
@@ -175,14 +188,14 @@ void MatterAirQualitySensor::AddNitrogenDioxideConcentrationMeasurementCluster()
                                    cluster::nitrogen_dioxide_concentration_measurement::feature::average_measurement::get_id() |
                                    cluster::nitrogen_dioxide_concentration_measurement::feature::peak_measurement::get_id();
     cluster_config.features.numeric_measurement.measurement_unit = static_cast<uint8_t>(NitrogenDioxideConcentrationMeasurement::MeasurementUnitEnum::kPpm);
-    cluster_config.features.average_measurement.average_measured_value_window = m_measurements.GetAverageWindowSizeSeconds(NitrogenDioxideConcentrationMeasurement::Id);
-    cluster_config.features.peak_measurement.peak_measured_value_window = m_measurements.GetPeakWindowSizeSeconds(NitrogenDioxideConcentrationMeasurement::Id);
+    cluster_config.features.average_measurement.average_measured_value_window = m_store->GetAverageWindowSizeSeconds(AirQualitySensor::MeasurementType::NOx);
+    cluster_config.features.peak_measurement.peak_measured_value_window = m_store->GetPeakWindowSizeSeconds(AirQualitySensor::MeasurementType::NOx);
     esp_matter::cluster::nitrogen_dioxide_concentration_measurement::create(m_endpoint, &cluster_config, CLUSTER_FLAG_SERVER);
 }
 
 void MatterAirQualitySensor::AddTotalVolatileOrganicCompoundsConcentrationMeasurementCluster()
 {
-    m_measurements.AddId(TotalVolatileOrganicCompoundsConcentrationMeasurement::Id, 3600, 3600);
+    m_store->TrackWindows(AirQualitySensor::MeasurementType::VOC, 3600, 3600);
 
     // Enable the NumericMeasurement (MEA), AverageMeasurement (AVG) and PeakMeasurement (PEA)
     // features; create() validates the flags and adds the features from the config
@@ -192,8 +205,8 @@ void MatterAirQualitySensor::AddTotalVolatileOrganicCompoundsConcentrationMeasur
                                    cluster::total_volatile_organic_compounds_concentration_measurement::feature::average_measurement::get_id() |
                                    cluster::total_volatile_organic_compounds_concentration_measurement::feature::peak_measurement::get_id();
     cluster_config.features.numeric_measurement.measurement_unit = static_cast<uint8_t>(TotalVolatileOrganicCompoundsConcentrationMeasurement::MeasurementUnitEnum::kPpm);
-    cluster_config.features.average_measurement.average_measured_value_window = m_measurements.GetAverageWindowSizeSeconds(TotalVolatileOrganicCompoundsConcentrationMeasurement::Id);
-    cluster_config.features.peak_measurement.peak_measured_value_window = m_measurements.GetPeakWindowSizeSeconds(TotalVolatileOrganicCompoundsConcentrationMeasurement::Id);
+    cluster_config.features.average_measurement.average_measured_value_window = m_store->GetAverageWindowSizeSeconds(AirQualitySensor::MeasurementType::VOC);
+    cluster_config.features.peak_measurement.peak_measured_value_window = m_store->GetPeakWindowSizeSeconds(AirQualitySensor::MeasurementType::VOC);
     esp_matter::cluster::total_volatile_organic_compounds_concentration_measurement::create(m_endpoint, &cluster_config, CLUSTER_FLAG_SERVER);
 }
 
@@ -267,160 +280,94 @@ void MatterAirQualitySensor::SetLightByAirQuality(AirQualityEnum airQuality)
     m_lightEndpoint->SetLightLevelPercent(lightLevelPercent);
 }
 
-AirQualityEnum MatterAirQualitySensor::ClassifyAirQualityByCO2()
-{
-    uint16_t co2_ppm = m_measurements.GetLatest(CarbonDioxideConcentrationMeasurement::Id);
-
-    if (co2_ppm >= 400 && co2_ppm <= 600) {
-        // Fresh air, no noticeable effects; matches outdoor levels.
-        return AirQualityEnum::kGood;
-    } else if (co2_ppm <= 700) {
-        // Still very good, no perceptible impact; minor ventilation decline.
-        return AirQualityEnum::kFair;
-    } else if (co2_ppm <= 800) {
-        // Suboptimal; sensitive individuals might notice slight stuffiness.
-        return AirQualityEnum::kModerate;
-    } else if (co2_ppm <= 950) {
-        // Mild effects possible (e.g., reduced focus); ventilation clearly poor.
-        return AirQualityEnum::kPoor;
-    } else if (co2_ppm <= 1200) {
-        // Discomfort likely (e.g., stuffiness, drowsiness); significant air quality decline.
-        return AirQualityEnum::kVeryPoor;
-    } else if (co2_ppm > 1200) {
-        // Potential health impacts (e.g., fatigue, headaches); unacceptable levels.
-        return AirQualityEnum::kExtremelyPoor;
-    }
-    // Below 400 ppm or invalid readings; sensor error or uninitialized state.
-    return AirQualityEnum::kUnknown;
-}
-
-AirQualityEnum MatterAirQualitySensor::ClassifyAirQualityByPM10()
-{
-    uint16_t pm10 = m_measurements.GetAverage(Pm10ConcentrationMeasurement::Id);
-
-    if (pm10 <= 30.0) {
-        return AirQualityEnum::kGood;
-    } else if (pm10 <= 60.0) {
-        return AirQualityEnum::kFair;
-    } else if (pm10 <= 120.0) {
-        return AirQualityEnum::kModerate;
-    } else if (pm10 <= 260.0) {
-        return AirQualityEnum::kPoor;
-    } else if (pm10 <= 400) {
-        return AirQualityEnum::kVeryPoor;
-    } else {
-        return AirQualityEnum::kExtremelyPoor;
-    }
-}
-
-AirQualityEnum MatterAirQualitySensor::ClassifyAirQualityByPM25()
+void MatterAirQualitySensor::UpdateMeasurements(const MeasurementSnapshot& snapshot)
 {
-    uint16_t pm25 = m_measurements.GetAverage(Pm25ConcentrationMeasurement::Id);
-
-    if (pm25 <= 15.0) {
-        return AirQualityEnum::kGood;
-    } else if (pm25 <= 30.0) {
-        return AirQualityEnum::kFair;
-    } else if (pm25 <= 50.0) {
-        return AirQualityEnum::kModerate;
-    } else if (pm25 <= 100.0) {
-        return AirQualityEnum::kPoor;
-    } else if (pm25 <= 150.0) {
-        return AirQualityEnum::kVeryPoor;
-    } else {
-        return AirQualityEnum::kExtremelyPoor;
-    }
-}
-
-float getElapsedSeconds()
-{
-    return static_cast<float>(esp_timer_get_time()) / 1000000.0f;
-}
-
-void MatterAirQualitySensor::UpdateMeasurements()
-{
-   // Read all measurements from the sensor
-    std::vector<AirQualitySensor::Measurement> measurements = m_airQualitySensor->ReadAllMeasurements();
-
-    // Check if measurements are empty (indicating an error)
-    if (measurements.empty()) {
-        ESP_LOGE(TAG, "MeasureAirQuality: sensor->ReadAllMeasurements failed or returned no data");
+    // Check if the snapshot is empty (indicating a failed read)
+    if (snapshot.IsEmpty()) {
+        ESP_LOGE(TAG, "MeasureAirQuality: snapshot holds no data");
         return;
     }
 
-    // Process each measurement
-    for (const auto& measurement : measurements) {
 
-        // Look up the cluster ID for the measurement type
-        auto it = measurementTypeToClusterId.find(measurement.type);
+    // Process each measurement
+    for (size_t i = 0; i < Sensor::kMeasurementTypeCount; i++) {
+        Sensor::Measurement measurement = {static_cast<Sensor::MeasurementType>(i), snapshot.values[i]};
+        if (!snapshot.Has(measurement.type)) {
+            continue;
+        }
 
-            // Check if the cluster ID was found
-        if (it == measurementTypeToClusterId.end()) {
-            // Log an error and skip this measurement
+        // Skip measurements that no cluster reports
+        if (!IsReported(measurement.type)) {
             ESP_LOGW(TAG, "MeasureAirQuality: No cluster ID found for measurement type %s",
-                    AirQualitySensor::MeasurementTypeToString(measurement.type).c_str());
+                    AirQualitySensor::MeasurementTypeToString(measurement.type));
             continue; // Skip to the next measurement
         }
 
-        uint32_t clusterId = it->second;
-
-        // Log the measurement
-        ESP_LOGI(TAG, "MeasureAirQuality: %s: %f",
-                    AirQualitySensor::MeasurementTypeToString(measurement.type).c_str(),
-                    measurement.value);
-
-        float elapsedSeconds = getElapsedSeconds();
-
-        // Add the measurement to the measurements store
-        m_measurements.AddMeasurement(clusterId, measurement.value, elapsedSeconds);
+        // The store already holds the snapshot; log the measurement and how
+        // full its preallocated window is
+        char value[24];
+        ESP_LOGI(TAG, "MeasureAirQuality: %s: %s (window %u%% full)",
+                    AirQualitySensor::MeasurementTypeToString(measurement.type),
+                    TextRow(value).Reading(measurement.type, measurement.value).CStr(),
+                    m_store->GetFillPercent(measurement.type));
     }
 
-    // Schedule the update of the attributes on the Matter thread
-    // This is necessary for thread safety, as the measurements may be updated from a different thread.
+    // Schedule the update of the attributes on the Matter thread, which reads
+    // them back from the store
     ScheduleAttributeUpdate(&UpdateAirQualityAttributes, this);
 }
 
 void MatterAirQualitySensor::UpdateAirQualityAttributes(MatterAirQualitySensor* matterAirQuality)
 {
-    std::vector<uint32_t> clusterIds = matterAirQuality->m_measurements.GetIds();
-    for (uint32_t clusterId : clusterIds) {
-        if (clusterId == RelativeHumidityMeasurement::Id)
+    // One lock-free copy, so every attribute below comes from the same report.
+    // GetPublished() only fills it with a complete set (a copy that raced a
+    // report is retried); before the first report it stays empty, with no
+    // values, and classifies as Unknown below.
+    MeasurementStore::Published published;
+    bool havePublished = matterAirQuality->m_store->GetPublished(published) != 0;
+    for (size_t i = 0; havePublished && i < Sensor::kMeasurementTypeCount; i++) {
+        auto type = static_cast<AirQualitySensor::MeasurementType>(i);
+        if (!matterAirQuality->IsReported(type)) {
+            continue;
+        }
+        uint32_t clusterId = ClusterIdFor(type);
+        int32_t latest = published.GetLatest(type);
+        if (latest == MeasurementStore::kNoValue) {
+            continue;
+        }
+        if (type == AirQualitySensor::MeasurementType::RelativeHumidity)
         {
-            matterAirQuality->UpdateRelativeHumidityMeasurementAttributes(
-                matterAirQuality->m_measurements.GetLatest(clusterId));
+            matterAirQuality->UpdateRelativeHumidityMeasurementAttributes(latest);
         }
-        else if (clusterId == TemperatureMeasurement::Id)
+        else if (type == AirQualitySensor::MeasurementType::Temperature)
         {
-            matterAirQuality->UpdateTemperatureMeasurementAttributes(
-                matterAirQuality->m_measurements.GetLatest(clusterId));      
+            matterAirQuality->UpdateTemperatureMeasurementAttributes(latest);
         }
         else
         {
+            // The concentration attributes are floats; each is made once
+            // here from native steps. The window statistics are 0, never
+            // kNoValue, before a type's first value.
             matterAirQuality->UpdateAttributeValueFloat(
                 clusterId,
                 0x00000000, // MeasuredValue
-                matterAirQuality->m_measurements.GetLatest(clusterId));
-    
+                *MatterUnits::Concentration(type, latest));
+
             matterAirQuality->UpdateAttributeValueFloat(
                 clusterId,
                 0x00000005, // AverageMeasured Value
-                matterAirQuality->m_measurements.GetAverage(clusterId));
+                MatterUnits::Concentration(type, published.GetAverage(type)).value_or(0.0f));
 
             matterAirQuality->UpdateAttributeValueFloat(
                 clusterId,
                 0x00000003, // PeakMeasured Value
-                matterAirQuality->m_measurements.GetPeak(clusterId));
+                MatterUnits::Concentration(type, published.GetPeak(type)).value_or(0.0f));
         }
     }
 
-    AirQualityEnum airQualityCO2 = matterAirQuality->ClassifyAirQualityByCO2();
-    AirQualityEnum airQualityPM25 = matterAirQuality->ClassifyAirQualityByPM25();
-    AirQualityEnum airQualityPM10 = matterAirQuality->ClassifyAirQualityByPM10();
-
-    // Use the worst air quality from CO2, PM2.5, and PM10
-    AirQualityEnum airQuality = std::max({airQualityCO2, airQualityPM25, airQualityPM10});
-    matterAirQuality->m_lastAirQuality = airQuality;
-
+    // The worst air quality from CO2, PM2.5 and PM10
+    AirQualityEnum airQuality = static_cast<AirQualityEnum>(AirQualityIndex::Classify(published));
+    matterAirQuality->m_lastAirQuality.store(airQuality, std::memory_order_relaxed);
 
     matterAirQuality->UpdateAirQuality(airQuality);
 
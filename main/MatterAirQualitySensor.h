@@ -4,8 +4,9 @@
 
 #include "sensors/AirQualitySensor.h"
 #include "MatterExtendedColorLight.h"
-#include "Measurements.h"
+#include "MeasurementStore.h"
 #include "MatterSensorBase.h"
+#include <atomic>
 
 using namespace esp_matter;
 using namespace esp_matter::endpoint;
@@ -24,24 +25,31 @@ class MatterAirQualitySensor : public MatterSensorBase
         static std::shared_ptr<MatterAirQualitySensor> CreateEndpoint(
             std::shared_ptr<MatterNode> matterNode,
             std::shared_ptr<AirQualitySensor> airQualitySensor,
-            std::shared_ptr<MatterExtendedColorLight> lightEndpoint);
+            std::shared_ptr<MatterExtendedColorLight> lightEndpoint,
+            std::shared_ptr<MeasurementStore> store);
 
-        void UpdateMeasurements() override;
+        void UpdateMeasurements(const MeasurementSnapshot& snapshot) override;
 
-        // Last computed overall air quality (updated on the Matter thread)
-        AirQualityEnum GetLastAirQuality() const { return m_lastAirQuality; }
+        // Last computed overall air quality (updated on the Matter thread,
+        // read by the display)
+        AirQualityEnum GetLastAirQuality() const { return m_lastAirQuality.load(std::memory_order_relaxed); }
 
     private:
 
-        MatterAirQualitySensor(node_t* node, std::shared_ptr<AirQualitySensor> airQualitySensor, std::shared_ptr<MatterExtendedColorLight> lightEndpoint);
+        MatterAirQualitySensor(node_t* node, std::shared_ptr<AirQualitySensor> airQualitySensor, std::shared_ptr<MatterExtendedColorLight> lightEndpoint, std::shared_ptr<MeasurementStore> store);
 
-        // Map from MeasurementType to Matter cluster ID
-        static const std::unordered_map<AirQualitySensor::MeasurementType, uint32_t> measurementTypeToClusterId;
+        // Matter cluster reporting each measurement type, or 0 if there is none
+        static constexpr uint32_t ClusterIdFor(AirQualitySensor::MeasurementType type);
+
+        // Whether this endpoint has a cluster for the type and it was set up;
+        // fixed once the endpoint is created, so any thread may ask
+        bool IsReported(AirQualitySensor::MeasurementType type) const;
 
         std::shared_ptr<AirQualitySensor> m_airQualitySensor;
         std::shared_ptr<MatterExtendedColorLight> m_lightEndpoint;
-        Measurements m_measurements;
-        AirQualityEnum m_lastAirQuality = AirQualityEnum::kUnknown;
+        std::shared_ptr<MeasurementStore> m_store; // shared with the display
+        std::atomic<AirQualityEnum> m_lastAirQuality{AirQualityEnum::kUnknown};
+        Sensor::MeasurementMask m_reportedMask = 0; // types with a cluster, see IsReported()
 
         void AddRelativeHumidityMeasurementCluster();
 
@@ -65,12 +73,6 @@ class MatterAirQualitySensor : public MatterSensorBase
 
         void UpdateAirQuality(AirQualityEnum airQuality);
 
-        AirQualityEnum ClassifyAirQualityByCO2();
-
-        AirQualityEnum ClassifyAirQualityByPM10();
-
-        AirQualityEnum ClassifyAirQualityByPM25();
-
         static void UpdateAirQualityAttributes(MatterAirQualitySensor* airQuality);
 
 };
\ No newline at end of file
@@ -72,7 +72,7 @@ uint16_t MatterEndpoint::GetAttributeValueUInt16(uint32_t cluster_id, uint32_t a
 
 void MatterEndpoint::UpdateAttributeValueBool(uint32_t cluster_id, uint32_t attribute_id, bool value)
 {
-    UpdateAttributeValueScalar(cluster_id, attribute_id, value ? 1.0 : 0.0);
+    UpdateAttributeValueScalar(cluster_id, attribute_id, value ? 1 : 0);
 }
 
 void MatterEndpoint::UpdateAttributeValueUInt8(uint32_t cluster_id, uint32_t attribute_id, uint8_t value)
@@ -90,7 +90,8 @@ void MatterEndpoint::UpdateAttributeValueFloat(uint32_t cluster_id, uint32_t att
     UpdateAttributeValueScalar(cluster_id, attribute_id, value);
 }
 
-void MatterEndpoint::UpdateAttributeValueScalar(uint32_t cluster_id, uint32_t attribute_id, double value)
+template <typename T>
+void MatterEndpoint::UpdateAttributeValueScalar(uint32_t cluster_id, uint32_t attribute_id, T value)
 {
     if (!m_endpoint) {
         ESP_LOGE(TAG, "Endpoint not initialized.");
@@ -113,7 +114,7 @@ void MatterEndpoint::UpdateAttributeValueScalar(uint32_t cluster_id, uint32_t at
     switch (val.type) {
     case ESP_MATTER_VAL_TYPE_BOOLEAN:
     case ESP_MATTER_VAL_TYPE_NULLABLE_BOOLEAN:
-        val.val.b = (value != 0.0);
+        val.val.b = (value != 0);
         break;
     case ESP_MATTER_VAL_TYPE_INT8:
     case ESP_MATTER_VAL_TYPE_NULLABLE_INT8:
@@ -51,7 +51,10 @@ class MatterEndpoint
     private:
 
         // Updates a numeric attribute using the value type the attribute was
-        // registered with (plain, nullable, enum or bitmap variants)
-        void UpdateAttributeValueScalar(uint32_t cluster_id, uint32_t attribute_id, double value);
+        // registered with (plain, nullable, enum or bitmap variants). Takes
+        // the caller's type so a float never goes through double: the C6
+        // has no FPU.
+        template <typename T>
+        void UpdateAttributeValueScalar(uint32_t cluster_id, uint32_t attribute_id, T value);
 
 };
\ No newline at end of file
@@ -1,23 +1,23 @@
 #include "MatterHumiditySensor.h"
+#include "TextRow.h"
 
 #include <esp_err.h>
 #include <esp_log.h>
 #include <common_macros.h>
-#include <cmath>
 
 using namespace esp_matter::attribute;
 using namespace chip::app::Clusters;
 
 static const char *TAG = "MatterHumiditySensor";
 
-MatterHumiditySensor::MatterHumiditySensor(endpoint_t* endpoint, std::shared_ptr<RelativeHumiditySensor> humiditySensor)
-        : MatterSensorBase(endpoint, "MatterHumiditySensor"), m_humiditySensor(humiditySensor)
+MatterHumiditySensor::MatterHumiditySensor(endpoint_t* endpoint, std::shared_ptr<MeasurementStore> store)
+        : MatterSensorBase(endpoint, "MatterHumiditySensor"), m_store(store)
 {    
 }
 
 std::shared_ptr<MatterHumiditySensor> MatterHumiditySensor::CreateEndpoint(
     std::shared_ptr<MatterNode> matterNode,
-    std::shared_ptr<RelativeHumiditySensor> humiditySensor)
+    std::shared_ptr<MeasurementStore> store)
 {
     // Create Humidity Endpoint
     esp_matter::endpoint::humidity_sensor::config_t humidity_config;
@@ -25,24 +25,24 @@ std::shared_ptr<MatterHumiditySensor> MatterHumiditySensor::CreateEndpoint(
     endpoint_t* endpoint = esp_matter::endpoint::humidity_sensor::create(matterNode->GetNode(), &humidity_config, ENDPOINT_FLAG_NONE, NULL);
     ABORT_APP_ON_FAILURE(endpoint != nullptr, ESP_LOGE(TAG, "Failed to create humidity sensor endpoint."));
     
-    auto matterHumiditySensor = std::shared_ptr<MatterHumiditySensor>(new MatterHumiditySensor(endpoint, humiditySensor));
+    auto matterHumiditySensor = std::shared_ptr<MatterHumiditySensor>(new MatterHumiditySensor(endpoint, store));
     matterNode->AddEndpoint(matterHumiditySensor);
 
     return matterHumiditySensor; 
 }
 
-void MatterHumiditySensor::UpdateMeasurements()
+void MatterHumiditySensor::UpdateMeasurements(const MeasurementSnapshot& snapshot)
 {
-    auto relativeHumidity = m_humiditySensor->MeasureRelativeHumidity();
     // Check if the measurement is valid
-    if (!relativeHumidity.has_value())
+    if (!snapshot.Has(Sensor::MeasurementType::RelativeHumidity))
     {
-        ESP_LOGE(TAG, "MeasureRelativeHumidity: Failed to read humidity");
+        ESP_LOGE(TAG, "MeasureRelativeHumidity: No humidity in this cycle");
         return;
     }
 
-    m_humidityMeasurement = relativeHumidity.value();
-    ESP_LOGI(TAG, "MeasureRelativeHumidity: %f", m_humidityMeasurement.value());
+    char value[24];
+    ESP_LOGI(TAG, "MeasureRelativeHumidity: %s", TextRow(value).Reading(Sensor::MeasurementType::RelativeHumidity,
+        snapshot.GetNative(Sensor::MeasurementType::RelativeHumidity)).CStr());
 
     // Need to use ScheduleLambda to execute the updates to the clusters on the Matter thread for thread safety
     ScheduleAttributeUpdate(&UpdateAttributes, this);
@@ -50,5 +50,8 @@ void MatterHumiditySensor::UpdateMeasurements()
 
 void MatterHumiditySensor::UpdateAttributes(MatterHumiditySensor* matterHumidity)
 {
-    matterHumidity->UpdateRelativeHumidityMeasurementAttributes(matterHumidity->m_humidityMeasurement);
+    MeasurementStore::Published published;
+    if (matterHumidity->m_store->GetPublished(published) != 0) {
+        matterHumidity->UpdateRelativeHumidityMeasurementAttributes(published.GetLatest(Sensor::MeasurementType::RelativeHumidity));
+    }
 }
\ No newline at end of file
@@ -1,41 +1,38 @@
 #pragma once
 
 #include <esp_matter.h>
-#include "sensors/RelativeHumiditySensor.h"
 #include "MatterNode.h"
 #include "MatterSensorBase.h"
+#include "MeasurementStore.h"
 
 using namespace esp_matter;
 using namespace esp_matter::endpoint;
 using namespace chip::app::Clusters::RelativeHumidityMeasurement;
 
 // Represents a Matter Humidity Sensor device type, compliant with the Matter protocol.
-// This class interfaces with a physical humidity sensor to read relative humidity measurements
-// and updates the corresponding Matter Relative Humidity Measurement cluster (0x0405) attributes
+// This class takes the relative humidity from each acquisition snapshot and updates the
+// corresponding Matter Relative Humidity Measurement cluster (0x0405) attributes
 // for a specified endpoint on a Matter node.
 class MatterHumiditySensor : public MatterSensorBase
 {
 
 public:
 
-    // Constructs a MatterHumiditySensor instance, associating it with a Matter node
-    // and a physical humidity sensor.
-    // @param node The Matter node to which this sensor's endpoint will be attached.
-    // @param humiditySensor Pointer to the physical humidity sensor providing measurements.
-    MatterHumiditySensor(endpoint_t* endpoint, std::shared_ptr<RelativeHumiditySensor> humiditySensor);
+    // Constructs a MatterHumiditySensor instance for an already created endpoint.
+    // @param endpoint The humidity sensor endpoint on the Matter node.
+    MatterHumiditySensor(endpoint_t* endpoint, std::shared_ptr<MeasurementStore> store);
 
     static std::shared_ptr<MatterHumiditySensor> CreateEndpoint(
         std::shared_ptr<MatterNode> matterNode,
-        std::shared_ptr<RelativeHumiditySensor> humiditySensor);
+        std::shared_ptr<MeasurementStore> store);
 
-    // Reads the latest humidity measurement from the physical sensor and updates
-    // the Matter Relative Humidity Measurement cluster's MeasuredValue attribute.
-    void UpdateMeasurements() override;
+    // Takes the humidity from the cycle's snapshot and updates the Matter
+    // Relative Humidity Measurement cluster's MeasuredValue attribute.
+    void UpdateMeasurements(const MeasurementSnapshot& snapshot) override;
 
 private:
     
-    std::shared_ptr<RelativeHumiditySensor> m_humiditySensor;
-    std::optional<float> m_humidityMeasurement;
+    std::shared_ptr<MeasurementStore> m_store; // holds the reported humidity
 
     // Updates the Relative Humidity Measurement cluster's attributes (e.g., MeasuredValue)
     // with the latest humidity reading for the specified MatterHumiditySensor instance.
@@ -1,5 +1,5 @@
-#include <cmath>
 #include "MatterSensorBase.h"
+#include "MatterUnits.h"
 
 #include <app/clusters/relative-humidity-measurement-server/RelativeHumidityMeasurementCluster.h>
 #include <app/clusters/temperature-measurement-server/TemperatureMeasurementCluster.h>
@@ -9,14 +9,15 @@
 // cluster instances, not by the esp-matter attribute store, so they must be
 // set through the cluster registered in the data model provider.
 
-void MatterSensorBase::UpdateRelativeHumidityMeasurementAttributes(std::optional<float> relativeHumidity)
+void MatterSensorBase::UpdateRelativeHumidityMeasurementAttributes(int32_t relativeHumidity)
 {
-    if (!relativeHumidity.has_value()) {
+    std::optional<uint16_t> converted = MatterUnits::RelativeHumidity(relativeHumidity);
+    if (!converted) {
         ESP_LOGE(m_tag, "Relative humidity measurement invalid.");
         return;
     }
-    ESP_LOGI(m_tag, "Relative Humidity: %f", relativeHumidity.value());
-    uint16_t reportedHumidity = static_cast<uint16_t>(std::round(relativeHumidity.value() * 100));
+    uint16_t reportedHumidity = *converted;
+    ESP_LOGI(m_tag, "Relative Humidity: %u (0.01 %%)", reportedHumidity);
 
     auto* cluster = static_cast<chip::app::Clusters::RelativeHumidityMeasurementCluster*>(
         esp_matter::data_model::provider::get_instance().registry().Get(
@@ -32,14 +33,15 @@ void MatterSensorBase::UpdateRelativeHumidityMeasurementAttributes(std::optional
     }
 }
 
-void MatterSensorBase::UpdateTemperatureMeasurementAttributes(std::optional<float> temperature)
+void MatterSensorBase::UpdateTemperatureMeasurementAttributes(int32_t temperature)
 {
-    if (!temperature.has_value()) {
+    std::optional<int16_t> converted = MatterUnits::Temperature(temperature);
+    if (!converted) {
         ESP_LOGE(m_tag, "Temperature measurement invalid.");
         return;
     }
-    ESP_LOGI(m_tag, "Temperature: %f", temperature.value());
-    int16_t reportedTemperature = static_cast<int16_t>(std::round(temperature.value() * 100));
+    int16_t reportedTemperature = *converted;
+    ESP_LOGI(m_tag, "Temperature: %d (0.01 °C)", reportedTemperature);
 
     auto* cluster = static_cast<chip::app::Clusters::TemperatureMeasurementCluster*>(
         esp_matter::data_model::provider::get_instance().registry().Get(
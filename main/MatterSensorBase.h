@@ -1,6 +1,8 @@
 #pragma once
 
 #include "MatterEndpoint.h"
+#include "MeasurementSnapshot.h"
+#include "MeasurementStore.h"
 #include <esp_matter.h>
 #include <esp_err.h>
 #include <esp_log.h>
@@ -19,16 +21,18 @@ public:
 
     virtual ~MatterSensorBase() = default;
 
-    // Pure virtual function for updating measurements
-    virtual void UpdateMeasurements() = 0;
+    // Publishes the readings of one acquisition cycle on this endpoint
+    virtual void UpdateMeasurements(const MeasurementSnapshot& snapshot) = 0;
 
 protected:
 
-    // Updates the RelativeHumidityMeasurement cluster's MeasuredValue attribute with a scaled value (0.01% units)
-    void UpdateRelativeHumidityMeasurementAttributes(std::optional<float> relativeHumidity);
+    // Updates the RelativeHumidityMeasurement cluster's MeasuredValue attribute (0.01% units) from a
+    // store value in native steps; MeasurementStore::kNoValue is logged and skipped
+    void UpdateRelativeHumidityMeasurementAttributes(int32_t relativeHumidity);
 
-    // Updates the TemperatureMeasurement cluster's MeasuredValue attribute with a scaled value (0.01°C units)
-    void UpdateTemperatureMeasurementAttributes(std::optional<float> temperature);
+    // Updates the TemperatureMeasurement cluster's MeasuredValue attribute (0.01°C units) from a
+    // store value in native steps; MeasurementStore::kNoValue is logged and skipped
+    void UpdateTemperatureMeasurementAttributes(int32_t temperature);
 
     // Template method to schedule attribute updates on the Matter thread
     template <typename T>
@@ -1,23 +1,23 @@
 #include "MatterTemperatureSensor.h"
+#include "TextRow.h"
 
 #include <esp_err.h>
 #include <esp_log.h>
 #include <common_macros.h>
-#include <cmath>
 
 using namespace esp_matter::attribute;
 using namespace chip::app::Clusters;
 
 static const char *TAG = "MatterTemperatureSensor";
 
-MatterTemperatureSensor::MatterTemperatureSensor(node_t* node, std::shared_ptr<TemperatureSensor> temperatureSensor)
-        : MatterSensorBase(node, "MatterTemperatureSensor"), m_temperatureSensor(temperatureSensor)
+MatterTemperatureSensor::MatterTemperatureSensor(endpoint_t* endpoint, std::shared_ptr<MeasurementStore> store)
+        : MatterSensorBase(endpoint, "MatterTemperatureSensor"), m_store(store)
 {
 }
 
 std::shared_ptr<MatterTemperatureSensor> MatterTemperatureSensor::CreateEndpoint(
     std::shared_ptr<MatterNode> matterNode,
-    std::shared_ptr<TemperatureSensor> temperatureSensor)
+    std::shared_ptr<MeasurementStore> store)
 {
     // Create Temperature Endpoint
     esp_matter::endpoint::temperature_sensor::config_t temperature_config;
@@ -25,24 +25,24 @@ std::shared_ptr<MatterTemperatureSensor> MatterTemperatureSensor::CreateEndpoint
     endpoint_t* endpoint = esp_matter::endpoint::temperature_sensor::create(matterNode->GetNode(), &temperature_config, ENDPOINT_FLAG_NONE, NULL);
     ABORT_APP_ON_FAILURE(endpoint != nullptr, ESP_LOGE(TAG, "Failed to create temperature sensor endpoint"));
     
-    auto matterTemperatureSensor = std::shared_ptr<MatterTemperatureSensor>(new MatterTemperatureSensor(endpoint, temperatureSensor));
+    auto matterTemperatureSensor = std::shared_ptr<MatterTemperatureSensor>(new MatterTemperatureSensor(endpoint, store));
     matterNode->AddEndpoint(matterTemperatureSensor);
 
     return matterTemperatureSensor;   
 }
 
-void MatterTemperatureSensor::UpdateMeasurements()
+void MatterTemperatureSensor::UpdateMeasurements(const MeasurementSnapshot& snapshot)
 {
-    auto temperature = m_temperatureSensor->MeasureTemperature();
     // Check if the measurement is valid
-    if (!temperature.has_value())
+    if (!snapshot.Has(Sensor::MeasurementType::Temperature))
     {
-        ESP_LOGE(TAG, "MeasureTemperature: Failed to read temperature");
+        ESP_LOGE(TAG, "MeasureTemperature: No temperature in this cycle");
         return;
     }
-    
-    m_temperatureMeasurement = temperature.value();
-    ESP_LOGI(TAG, "MeasureTemperature: %f", m_temperatureMeasurement.value());
+
+    char value[24];
+    ESP_LOGI(TAG, "MeasureTemperature: %s", TextRow(value).Reading(Sensor::MeasurementType::Temperature,
+        snapshot.GetNative(Sensor::MeasurementType::Temperature)).CStr());
 
     // Need to use ScheduleLambda to execute the updates to the clusters on the Matter thread for thread safety
     ScheduleAttributeUpdate(&UpdateAttributes, this);
@@ -50,5 +50,8 @@ void MatterTemperatureSensor::UpdateMeasurements()
 
 void MatterTemperatureSensor::UpdateAttributes(MatterTemperatureSensor* matterTemperature)
 {
-    matterTemperature->UpdateTemperatureMeasurementAttributes(matterTemperature->m_temperatureMeasurement);  
+    MeasurementStore::Published published;
+    if (matterTemperature->m_store->GetPublished(published) != 0) {
+        matterTemperature->UpdateTemperatureMeasurementAttributes(published.GetLatest(Sensor::MeasurementType::Temperature));
+    }
 }
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "sensors/Sensor.h"
+#include <stdint.h>
+#include <optional>
+
+// Converts store values in native steps (Sensor::NativeScale()) to the units
+// of the Matter attributes the endpoints report. Each returns nullopt for
+// Sensor::kNoValue, which the endpoints leave unreported. Kept apart from the
+// endpoints so the conversions can be checked on the host.
+namespace MatterUnits {
+
+// RelativeHumidityMeasurement MeasuredValue, in 0.01 %
+inline std::optional<uint16_t> RelativeHumidity(int32_t native)
+{
+    if (native == Sensor::kNoValue) {
+        return std::nullopt;
+    }
+    return static_cast<uint16_t>(Sensor::Rescale(Sensor::MeasurementType::RelativeHumidity, native, 100));
+}
+
+// TemperatureMeasurement MeasuredValue, in 0.01 °C
+inline std::optional<int16_t> Temperature(int32_t native)
+{
+    if (native == Sensor::kNoValue) {
+        return std::nullopt;
+    }
+    return static_cast<int16_t>(Sensor::Rescale(Sensor::MeasurementType::Temperature, native, 100));
+}
+
+// The concentration clusters' float values, in the type's unit: ppm for CO2,
+// µg/m³ for PM, the index for VOC and NOx
+inline std::optional<float> Concentration(Sensor::MeasurementType type, int32_t native)
+{
+    if (native == Sensor::kNoValue) {
+        return std::nullopt;
+    }
+    return static_cast<float>(native) / Sensor::NativeScale(type);
+}
+
+} // namespace MatterUnits
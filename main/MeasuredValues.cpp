@@ -1,80 +1,129 @@
 #include "MeasuredValues.h"
-#include <deque>
 #include <algorithm>
-#include <stdexcept>
 
-MeasuredValues::MeasuredValues(uint32_t id, uint32_t averageWindowSizeSeconds, uint32_t peakWindowSizeSeconds)
+MeasuredValues::MeasuredValues(uint32_t id, bool isSigned, uint32_t averageWindowSizeSeconds,
+                               uint32_t peakWindowSizeSeconds, uint32_t minSamplePeriodSeconds)
     : m_id(id)
+    , m_base(isSigned ? -32767 : 0)
     , m_averageWindowSizeSeconds(averageWindowSizeSeconds)
-    , m_peakWindowSizeSeconds(peakWindowSizeSeconds)
-    , m_latestValue(0.0f)
+    , m_latestValue(0)
+    , m_extremes(peakWindowSizeSeconds, std::max(minSamplePeriodSeconds, peakWindowSizeSeconds / kPeakResolutionSteps))
 {
+    uint32_t slotSeconds = std::max({minSamplePeriodSeconds, averageWindowSizeSeconds / kMaxSlots, 1u});
+    m_slotTicks = slotSeconds * (1000000 / kTickUs);
+    // One record per slot in the window, plus the partial slots at each end
+    m_samples.SetCapacity(averageWindowSizeSeconds / slotSeconds + 2);
 }
 
-void MeasuredValues::Add(float value, float elapsedTimeSeconds)
+uint16_t MeasuredValues::Quantise(int32_t value) const
 {
-    // Store the new measurement with its timestamp
-    m_measurements.emplace_back(value, elapsedTimeSeconds);
-    m_latestValue = value;
+    int64_t code = (int64_t)value - m_base;
+    return (uint16_t)std::min<int64_t>(std::max<int64_t>(code, 0), kGap - 1); // kGap stays reserved
+}
 
-    // Remove measurements outside the larger of the two windows
-    float oldestRelevantTime = elapsedTimeSeconds - std::max(m_averageWindowSizeSeconds, m_peakWindowSizeSeconds);
-    while (!m_measurements.empty() && m_measurements.front().second < oldestRelevantTime) {
-        m_measurements.pop_front();
+void MeasuredValues::PushRecord(uint32_t tick, uint16_t code)
+{
+    if (m_samples.IsFull()) {
+        PopRecord(); // can't happen with slot merging; keeps the sums honest if it does
+    }
+    uint32_t delta = m_samples.IsEmpty() ? 0 : tick - m_backTick;
+    if (m_samples.IsEmpty()) {
+        m_frontTick = tick;
+    }
+    m_samples.PushBack({(uint16_t)delta, code});
+    m_backTick = tick;
+    if (code != kGap) {
+        m_sum += code;
+        m_count++;
     }
 }
 
-float MeasuredValues::GetLatest()
+void MeasuredValues::PopRecord()
 {
-    return m_latestValue;
+    if (m_samples.Front().code != kGap) {
+        m_sum -= m_samples.Front().code;
+        m_count--;
+    }
+    m_samples.PopFront();
+    if (!m_samples.IsEmpty()) {
+        m_frontTick += m_samples.Front().deltaTicks;
+    }
 }
 
-float MeasuredValues::GetAverage()
+void MeasuredValues::Add(int32_t value, int64_t timestampUs)
 {
-    if (m_measurements.empty()) {
-        return 0.0f;
-    }
+    Add(value, value, value, timestampUs);
+}
 
-    float sum = 0.0f;
-    size_t count = 0;
-    float minTime = m_measurements.back().second - m_averageWindowSizeSeconds;
+void MeasuredValues::Add(int32_t value, int32_t lowValue, int32_t peakValue, int64_t timestampUs)
+{
+    uint32_t tick = (uint32_t)(timestampUs / kTickUs);
+    uint16_t quantised = Quantise(value);
+    m_latestValue = value;
+    m_extremes.Add(lowValue, peakValue, timestampUs);
 
-    // Sum values within the average window
-    for (const auto& measurement : m_measurements) {
-        if (measurement.second >= minTime) {
-            sum += measurement.first;
-            count++;
+    if (!m_samples.IsEmpty() && m_samples.Back().code != kGap &&
+        tick / m_slotTicks == m_backTick / m_slotTicks) {
+        // Same slot as the newest record: fold the sample into its mean
+        m_slotSum += quantised;
+        m_slotSamples++;
+        uint16_t mean = (uint16_t)((m_slotSum + m_slotSamples / 2u) / m_slotSamples);
+        m_sum += mean - m_samples.Back().code;
+        m_samples.Back().code = mean;
+    } else {
+        // Bridge pauses too long for one delta with filler records
+        while (!m_samples.IsEmpty() && tick - m_backTick > UINT16_MAX) {
+            PushRecord(m_backTick + UINT16_MAX, kGap);
         }
+        PushRecord(tick, quantised);
+        m_slotSum = quantised;
+        m_slotSamples = 1;
     }
 
-    return count > 0 ? sum / count : 0.0f;
+    // Slide the average window. The record just added always stays, so the
+    // buffer never runs empty.
+    uint32_t windowTicks = m_averageWindowSizeSeconds * (1000000 / kTickUs);
+    while (tick - m_frontTick > windowTicks) {
+        PopRecord();
+    }
 }
 
-uint32_t MeasuredValues::GetAverageWindowSizeSeconds()
+int32_t MeasuredValues::GetLatest()
 {
-    return m_averageWindowSizeSeconds;
+    return m_latestValue;
 }
 
-float MeasuredValues::GetPeak()
+int32_t MeasuredValues::GetAverage()
 {
-    if (m_measurements.empty()) {
-        return 0.0f;
+    if (m_count == 0) {
+        return 0;
     }
+    return m_base + (int32_t)((m_sum + m_count / 2) / m_count);
+}
 
-    float peak = m_measurements.back().first;
-    float minTime = m_measurements.back().second - m_peakWindowSizeSeconds;
+uint32_t MeasuredValues::GetAverageWindowSizeSeconds()
+{
+    return m_averageWindowSizeSeconds;
+}
 
-    // Find max value within the peak window
-    for (const auto& measurement : m_measurements) {
-        if (measurement.second >= minTime) {
-            peak = std::max(peak, measurement.first);
-        }
-    }
+int32_t MeasuredValues::GetPeak()
+{
+    return m_extremes.GetMax();
+}
 
-    return peak;
+int32_t MeasuredValues::GetMin()
+{
+    return m_extremes.GetMin();
 }
 
 uint32_t MeasuredValues::GetPeakWindowSizeSeconds()
 {
-    return m_peakWindowSizeSeconds;
-}
\ No newline at end of file
+    return m_extremes.GetWindowSizeSeconds();
+}
+
+uint8_t MeasuredValues::GetFillPercent() const
+{
+    size_t samples = m_samples.Size() * 100 / m_samples.Capacity();
+    size_t extremes = m_extremes.GetSize() * 100 / m_extremes.GetCapacity();
+    return (uint8_t)std::max(samples, extremes);
+}
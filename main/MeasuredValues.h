@@ -1,31 +1,94 @@
 #pragma once
+#include "RingBuffer.h"
+#include "SlidingExtremes.h"
+#include <stddef.h>
 #include <stdint.h>
-#include <deque>
 
+// Latest value, window average and window extremes of one measurement.
+//
+// Values are integers in the type's native steps (Sensor::NativeScale()), in
+// and out, so nothing here needs floating point. The average window is stored
+// compactly: each record is 4 bytes, the time since the previous record in
+// 100 ms ticks and the value as a 16-bit offset from the type's lowest
+// storable value: 0 to 65534 steps for unsigned types, so CO2 keeps its full
+// 40000 ppm range, and -32767 to 32767 for signed ones. Times are integer ticks,
+// exact for 13 years of uptime. Samples closer together than the slot period
+// (minSamplePeriodSeconds, or longer for long windows so a window never needs
+// more than kMaxSlots records) are merged into one record holding their mean,
+// so all storage is allocated by the constructor and adding samples never
+// touches the heap, however fast they come. A 24 h window takes under 6 kB.
 class MeasuredValues
 {
 public:
-    MeasuredValues(uint32_t id, uint32_t averageWindowSizeSeconds, uint32_t peakWindowSizeSeconds);
+    // isSigned: whether values can be negative (Sensor::IsSigned())
+    MeasuredValues(uint32_t id, bool isSigned, uint32_t averageWindowSizeSeconds, uint32_t peakWindowSizeSeconds,
+                   uint32_t minSamplePeriodSeconds);
 
-    void Add(float value, float elapsedTimeSeconds);
+    void Add(int32_t value, int64_t timestampUs);
 
-    // Return the most recent measurement as a single-precision floating-point number.
-    float GetLatest();
+    // Adds a value that stands for an interval (e.g. the mean of oversampled
+    // readings) together with the lowest and highest reading seen in that
+    // interval, which are what GetMin() and GetPeak() report.
+    void Add(int32_t value, int32_t lowValue, int32_t peakValue, int64_t timestampUs);
 
-    // Return the average value of MeasuredValue that has been measured during the averageWindowSizeSeconds.
-    float GetAverage();
+    // Return the most recent measurement.
+    int32_t GetLatest();
+
+    // Return the average value of MeasuredValue that has been measured during the averageWindowSizeSeconds,
+    // rounded to a whole step. Constant time: an exact integer sum over the window is kept up to date by
+    // Add(). Each slot counts once, so the average is time-weighted at slot resolution.
+    int32_t GetAverage();
 
     uint32_t GetAverageWindowSizeSeconds();
 
     // Return the maximum value of MeasuredValue that has been measured during the peakWindowSizeSeconds.
-    float GetPeak();
+    // Constant time, from the sliding-window extremes.
+    int32_t GetPeak();
+
+    // Return the minimum value over the same window as GetPeak().
+    int32_t GetMin();
 
     uint32_t GetPeakWindowSizeSeconds();
 
+    // How full the preallocated sample storage is, in percent
+    uint8_t GetFillPercent() const;
+
 private:
+    static constexpr int64_t kTickUs = 100000;     // 100 ms
+    static constexpr uint32_t kMaxSlots = 1440;    // 1 min slots for a 24 h window
+    static constexpr uint16_t kGap = UINT16_MAX;   // filler record bridging a long pause
+
+    struct Sample {
+        uint16_t deltaTicks; // since the previous record
+        uint16_t code;       // value - m_base, clamped; kGap for a filler
+    };
+
+    uint16_t Quantise(int32_t value) const;
+    void PushRecord(uint32_t tick, uint16_t code);
+    void PopRecord();
+
     uint32_t m_id;
+    int32_t m_base; // value stored as code 0
     uint32_t m_averageWindowSizeSeconds;
-    uint32_t m_peakWindowSizeSeconds;
-    float m_latestValue;
-    std::deque<std::pair<float, float>> m_measurements; // Stores (value, elapsedTimeSeconds)
-};
\ No newline at end of file
+    int32_t m_latestValue;
+    uint32_t m_slotTicks;
+
+    RingBuffer<Sample> m_samples; // records inside the average window
+    uint32_t m_frontTick = 0;     // tick of m_samples.Front()
+    uint32_t m_backTick = 0;      // tick of m_samples.Back()
+
+    // Exact sum and count of the (non-filler) codes in the window; at most
+    // kMaxSlots + 2 records of 16 bits, so 32 bits hold the sum
+    uint32_t m_sum = 0;
+    uint32_t m_count = 0;
+
+    // The newest record is the running mean of the samples in its slot;
+    // 65535 codes below kGap still fit the unsigned sum
+    uint32_t m_slotSum = 0;
+    uint16_t m_slotSamples = 0;
+
+    // The peak window is tracked to 1/kPeakResolutionSteps of its length (1 min
+    // for an hour), which keeps the extremes small whatever the sample rate
+    static constexpr uint32_t kPeakResolutionSteps = 60;
+    SlidingExtremes m_extremes; // over the peak window
+};
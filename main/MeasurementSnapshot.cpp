@@ -0,0 +1,14 @@
+#include "MeasurementSnapshot.h"
+
+MeasurementSnapshot MeasurementSnapshot::FromRecord(const Sensor::MeasurementRecord& record, int64_t timestampUs)
+{
+    MeasurementSnapshot snapshot;
+    snapshot.timestampUs = timestampUs;
+    snapshot.validMask = record.validMask;
+    for (size_t i = 0; i < Sensor::kMeasurementTypeCount; i++) {
+        snapshot.values[i] = record.values[i];
+        snapshot.minValues[i] = record.values[i];
+        snapshot.maxValues[i] = record.values[i];
+    }
+    return snapshot;
+}
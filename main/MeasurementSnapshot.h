@@ -0,0 +1,67 @@
+#pragma once
+
+#include "sensors/Sensor.h"
+#include <stdint.h>
+#include <cmath>
+
+// The readings of one acquisition cycle, timestamped and recorded once in the
+// MeasurementStore that the Matter endpoints and the LCD all read, so they
+// report values from the same instant. Either a single sensor read
+// or, when oversampling, the decimation of all 1 Hz samples of the interval:
+// values then hold the interval means and minValues/maxValues its extremes.
+// Values are integers in the type's Sensor::NativeScale() steps, as the
+// sensor sent them; Get() and friends convert to units for display.
+struct MeasurementSnapshot
+{
+    int64_t timestampUs = 0;  // esp_timer time of the (last) read
+    uint32_t validMask = 0;   // bit n set when values[n] holds a reading
+    uint16_t sampleCount = 1; // sensor reads folded into this snapshot
+    int32_t values[Sensor::kMeasurementTypeCount] = {};
+    int32_t minValues[Sensor::kMeasurementTypeCount] = {};
+    int32_t maxValues[Sensor::kMeasurementTypeCount] = {};
+
+    // Builds a snapshot from one Sensor::ReadMeasurements() record
+    static MeasurementSnapshot FromRecord(const Sensor::MeasurementRecord& record, int64_t timestampUs);
+
+    bool IsEmpty() const { return validMask == 0; }
+
+    bool Has(Sensor::MeasurementType type) const
+    {
+        return (validMask & Bit(type)) != 0;
+    }
+
+    // The reading for a type in native steps; only meaningful if Has(type)
+    int32_t GetNative(Sensor::MeasurementType type) const
+    {
+        return values[static_cast<size_t>(type)];
+    }
+
+    // The reading for a type in units, or NAN when the sensor did not
+    // provide it
+    float Get(Sensor::MeasurementType type) const
+    {
+        return ToUnits(type, values);
+    }
+
+    // Lowest/highest reading over the snapshot's interval, or NAN
+    float GetMin(Sensor::MeasurementType type) const
+    {
+        return ToUnits(type, minValues);
+    }
+
+    float GetMax(Sensor::MeasurementType type) const
+    {
+        return ToUnits(type, maxValues);
+    }
+
+    static constexpr uint32_t Bit(Sensor::MeasurementType type)
+    {
+        return Sensor::MaskOf(type);
+    }
+
+private:
+    float ToUnits(Sensor::MeasurementType type, const int32_t* steps) const
+    {
+        return Has(type) ? (float)steps[static_cast<size_t>(type)] / Sensor::NativeScale(type) : NAN;
+    }
+};
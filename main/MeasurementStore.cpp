@@ -0,0 +1,202 @@
+#include "MeasurementStore.h"
+#include <cmath>
+
+MeasurementStore::MeasurementStore()
+    : m_mutex(xSemaphoreCreateMutexStatic(&m_mutexBuffer))
+{
+    for (int32_t& value : m_latestValues) {
+        value = kNoValue;
+    }
+}
+
+void MeasurementStore::TrackWindows(MeasurementType type, uint32_t averageWindowSizeSeconds,
+                                    uint32_t peakWindowSizeSeconds)
+{
+    Lock lock(m_mutex);
+    m_windows.AddType(type, averageWindowSizeSeconds, peakWindowSizeSeconds);
+}
+
+void MeasurementStore::TrackRollups(MeasurementType type)
+{
+    Lock lock(m_mutex);
+    m_rollups[SlotOf(type)].emplace();
+}
+
+void MeasurementStore::TrackPercentiles(MeasurementType type, float minValue, float maxValue, float relativeError,
+                                        uint32_t maxWindowSeconds)
+{
+    int32_t scale = Sensor::NativeScale(type);
+    Lock lock(m_mutex);
+    m_percentiles[SlotOf(type)].emplace((int32_t)lroundf(minValue * scale), (int32_t)lroundf(maxValue * scale),
+                                        relativeError, maxWindowSeconds);
+}
+
+void MeasurementStore::TrackHistory(MeasurementType type, size_t reports)
+{
+    Lock lock(m_mutex);
+    m_history[SlotOf(type)].SetCapacity(reports);
+}
+
+void MeasurementStore::SetRollupOffsetSeconds(uint32_t seconds)
+{
+    Lock lock(m_mutex);
+    m_rollupOffsetUs = (int64_t)seconds * 1000000;
+}
+
+void MeasurementStore::RestoreHour(MeasurementType type, uint32_t startSeconds, const RollupSeries::Summary& summary)
+{
+    Lock lock(m_mutex);
+    auto& rollup = m_rollups[SlotOf(type)];
+    if (rollup) {
+        rollup->AddCell(RollupSeries::kHour, startSeconds, summary);
+    }
+}
+
+void MeasurementStore::Record(const MeasurementSnapshot& report)
+{
+    Lock lock(m_mutex);
+    m_previous = m_latest;
+    m_latest = report;
+
+    for (size_t i = 0; i < Sensor::kMeasurementTypeCount; i++) {
+        auto type = static_cast<MeasurementType>(i);
+        if (!report.Has(type)) {
+            continue;
+        }
+        int32_t value = report.values[i];
+        m_latestValues[i] = value;
+        m_windows.AddMeasurement(type, value, report.minValues[i], report.maxValues[i], report.timestampUs);
+        if (m_rollups[i]) {
+            m_rollups[i]->Add(value, report.minValues[i], report.maxValues[i], report.timestampUs + m_rollupOffsetUs);
+        }
+        if (m_percentiles[i]) {
+            m_percentiles[i]->Add(value, report.timestampUs);
+        }
+        if (m_history[i].Capacity() > 0) {
+            m_history[i].PushBack({report.timestampUs, value});
+        }
+    }
+
+    Published published;
+    for (size_t i = 0; i < Sensor::kMeasurementTypeCount; i++) {
+        auto type = static_cast<MeasurementType>(i);
+        published.latest[i] = m_latestValues[i];
+        published.averages[i] = m_windows.GetAverage(type);
+        published.peaks[i] = m_windows.GetPeak(type);
+    }
+    m_published.Publish(published);
+}
+
+MeasurementSnapshot MeasurementStore::GetLatest() const
+{
+    Lock lock(m_mutex);
+    return m_latest;
+}
+
+MeasurementSnapshot MeasurementStore::GetPrevious() const
+{
+    Lock lock(m_mutex);
+    return m_previous;
+}
+
+int32_t MeasurementStore::GetLatest(MeasurementType type) const
+{
+    Lock lock(m_mutex);
+    return m_latestValues[SlotOf(type)];
+}
+
+uint32_t MeasurementStore::GetPublished(Published& published) const
+{
+    return m_published.Read(published);
+}
+
+uint32_t MeasurementStore::GetTornReads() const
+{
+    return m_published.TornReads();
+}
+
+bool MeasurementStore::HasWindows(MeasurementType type) const
+{
+    Lock lock(m_mutex);
+    return m_windows.Has(type);
+}
+
+int32_t MeasurementStore::GetAverage(MeasurementType type) const
+{
+    Lock lock(m_mutex);
+    return m_windows.GetAverage(type);
+}
+
+int32_t MeasurementStore::GetPeak(MeasurementType type) const
+{
+    Lock lock(m_mutex);
+    return m_windows.GetPeak(type);
+}
+
+int32_t MeasurementStore::GetMin(MeasurementType type) const
+{
+    Lock lock(m_mutex);
+    return m_windows.GetMin(type);
+}
+
+uint32_t MeasurementStore::GetAverageWindowSizeSeconds(MeasurementType type) const
+{
+    Lock lock(m_mutex);
+    return m_windows.GetAverageWindowSizeSeconds(type);
+}
+
+uint32_t MeasurementStore::GetPeakWindowSizeSeconds(MeasurementType type) const
+{
+    Lock lock(m_mutex);
+    return m_windows.GetPeakWindowSizeSeconds(type);
+}
+
+uint8_t MeasurementStore::GetFillPercent(MeasurementType type) const
+{
+    Lock lock(m_mutex);
+    return m_windows.GetFillPercent(type);
+}
+
+RollupSeries::Summary MeasurementStore::GetRollup(MeasurementType type, uint32_t windowSeconds) const
+{
+    Lock lock(m_mutex);
+    const auto& rollup = m_rollups[SlotOf(type)];
+    return rollup ? rollup->Query(windowSeconds) : RollupSeries::Summary{kNoValue, kNoValue, kNoValue, 0};
+}
+
+bool MeasurementStore::GetNewestClosedHour(MeasurementType type, uint32_t& startSeconds,
+                                           RollupSeries::Summary& summary) const
+{
+    Lock lock(m_mutex);
+    const auto& rollup = m_rollups[SlotOf(type)];
+    return rollup && rollup->GetNewestClosed(RollupSeries::kHour, startSeconds, summary);
+}
+
+QuantileSketch::Percentiles MeasurementStore::GetPercentiles(MeasurementType type, uint32_t windowSeconds) const
+{
+    QuantileSketch::Percentiles percentiles = {NAN, NAN, NAN, 0};
+    {
+        Lock lock(m_mutex);
+        const auto& sketch = m_percentiles[SlotOf(type)];
+        if (sketch) {
+            percentiles = sketch->GetPercentiles(windowSeconds);
+        }
+    }
+    // The sketch counts native steps
+    float scale = (float)Sensor::NativeScale(type);
+    return {percentiles.p50 / scale, percentiles.p95 / scale, percentiles.p99 / scale, percentiles.count};
+}
+
+size_t MeasurementStore::GetHistory(MeasurementType type, int32_t* values, size_t capacity,
+                                    uint32_t& spanSeconds) const
+{
+    Lock lock(m_mutex);
+    const RingBuffer<HistoryEntry>& history = m_history[SlotOf(type)];
+    size_t count = history.Size() < capacity ? history.Size() : capacity;
+    size_t first = history.Size() - count;
+    for (size_t i = 0; i < count; i++) {
+        values[i] = history[first + i].value;
+    }
+    spanSeconds = count == 0 ? 0 : (uint32_t)((history.Back().timestampUs - history[first].timestampUs) / 1000000);
+    return count;
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "MeasurementSnapshot.h"
+#include "Measurements.h"
+#include "QuantileSketch.h"
+#include "RingBuffer.h"
+#include "RollupSeries.h"
+#include "SeqLock.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <optional>
+
+// The one home of every published report. The acquisition task records each
+// report once; the Matter endpoints and the display only query it, so both
+// views always agree and nothing is stored or aggregated twice. Per type it
+// keeps whatever was set up before the first report: the window statistics
+// Matter reports (see Measurements), minute/hour/day rollups, exposure
+// percentiles and a short history of recent reports. Every call takes the
+// store's mutex, so any task may use it, except GetPublished(): that is how
+// the Matter thread reads, lock-free and always a consistent set.
+//
+// Everything is kept in integer native steps (see Sensor::NativeScale()), so
+// Record() runs no floating point, which the C6 does in software: the window
+// statistics Matter reports, the rollups the display and the flash history
+// read, the percentile histograms and the chart history. The only floats are
+// the percentiles GetPercentiles() works out for the display when asked.
+class MeasurementStore
+{
+public:
+    using MeasurementType = Sensor::MeasurementType;
+
+    MeasurementStore();
+
+    MeasurementStore(const MeasurementStore&) = delete;
+    MeasurementStore& operator=(const MeasurementStore&) = delete;
+
+    // Setup; allocates the type's storage once
+    void TrackWindows(MeasurementType type, uint32_t averageWindowSizeSeconds, uint32_t peakWindowSizeSeconds);
+    void TrackRollups(MeasurementType type);
+    // minValue and maxValue in units, converted to native steps once here
+    void TrackPercentiles(MeasurementType type, float minValue, float maxValue, float relativeError,
+                          uint32_t maxWindowSeconds);
+    void TrackHistory(MeasurementType type, size_t reports);
+
+    // Shifts the rollups' clock, so hours restored from flash stay in the
+    // past of the reports that follow them
+    void SetRollupOffsetSeconds(uint32_t seconds);
+    // Adds one hour saved before a reboot to the type's rollups; hours must
+    // come oldest first and before any report
+    void RestoreHour(MeasurementType type, uint32_t startSeconds, const RollupSeries::Summary& summary);
+
+    // Stores one published report in everything tracked for its types
+    void Record(const MeasurementSnapshot& report);
+
+    // The last report and the one before; empty snapshots until there are any
+    MeasurementSnapshot GetLatest() const;
+    MeasurementSnapshot GetPrevious() const;
+
+    // GetLatest(type) before any value of the type was recorded
+    static constexpr int32_t kNoValue = Sensor::kNoValue;
+
+    // The newest value recorded for a type, in native steps, or kNoValue
+    int32_t GetLatest(MeasurementType type) const;
+
+    // What the Matter endpoints report, as of one Record(): per type the
+    // newest value (kNoValue if none) and window statistics, in native steps.
+    // Constructed empty: no values and zero statistics, as before any report.
+    struct Published {
+        int32_t latest[Sensor::kMeasurementTypeCount];
+        int32_t averages[Sensor::kMeasurementTypeCount] = {};
+        int32_t peaks[Sensor::kMeasurementTypeCount] = {};
+
+        Published()
+        {
+            for (int32_t& value : latest) {
+                value = kNoValue;
+            }
+        }
+
+        int32_t GetLatest(MeasurementType type) const { return latest[SlotOf(type)]; }
+        int32_t GetAverage(MeasurementType type) const { return averages[SlotOf(type)]; }
+        int32_t GetPeak(MeasurementType type) const { return peaks[SlotOf(type)]; }
+    };
+
+    // Copies the set published by the newest Record() without taking the
+    // mutex, so a reader never waits for a report being recorded. Returns
+    // the report's sequence number (1 for the first), or 0 and leaves
+    // published alone before any report.
+    uint32_t GetPublished(Published& published) const;
+
+    // GetPublished() copies that raced a Record() and were retried
+    uint32_t GetTornReads() const;
+
+    // Window statistics in native steps; 0 for a type without windows
+    bool HasWindows(MeasurementType type) const;
+    int32_t GetAverage(MeasurementType type) const;
+    int32_t GetPeak(MeasurementType type) const;
+    int32_t GetMin(MeasurementType type) const;
+    uint32_t GetAverageWindowSizeSeconds(MeasurementType type) const;
+    uint32_t GetPeakWindowSizeSeconds(MeasurementType type) const;
+    uint8_t GetFillPercent(MeasurementType type) const;
+
+    // Rollup summary (native steps) and percentiles (units) over the last
+    // windowSeconds; empty (a count of 0) for a type that doesn't keep them
+    RollupSeries::Summary GetRollup(MeasurementType type, uint32_t windowSeconds) const;
+    QuantileSketch::Percentiles GetPercentiles(MeasurementType type, uint32_t windowSeconds) const;
+
+    // The type's newest complete hour and its start (rollup clock). Returns
+    // false if there is none yet.
+    bool GetNewestClosedHour(MeasurementType type, uint32_t& startSeconds, RollupSeries::Summary& summary) const;
+
+    // Copies up to capacity of the type's most recent reported values (native
+    // steps) into values, oldest first, and the time from the oldest copied
+    // report to the newest into spanSeconds: reports come at the adaptive
+    // period or out of cycle, so their count alone says little about it.
+    // Returns how many were copied.
+    size_t GetHistory(MeasurementType type, int32_t* values, size_t capacity, uint32_t& spanSeconds) const;
+
+private:
+    // Holds the mutex for its lifetime
+    class Lock
+    {
+    public:
+        explicit Lock(SemaphoreHandle_t mutex) : m_mutex(mutex) { xSemaphoreTake(m_mutex, portMAX_DELAY); }
+        ~Lock() { xSemaphoreGive(m_mutex); }
+
+    private:
+        SemaphoreHandle_t m_mutex;
+    };
+
+    static constexpr size_t SlotOf(MeasurementType type) { return static_cast<size_t>(type); }
+
+    struct HistoryEntry {
+        int64_t timestampUs;
+        int32_t value;
+    };
+
+    StaticSemaphore_t m_mutexBuffer;
+    SemaphoreHandle_t m_mutex;
+
+    mutable Measurements m_windows; // its getters update nothing but aren't const
+    MeasurementSnapshot m_latest;
+    MeasurementSnapshot m_previous;
+    int32_t m_latestValues[Sensor::kMeasurementTypeCount];
+    std::optional<RollupSeries> m_rollups[Sensor::kMeasurementTypeCount];
+    int64_t m_rollupOffsetUs = 0;
+    std::optional<QuantileSketch> m_percentiles[Sensor::kMeasurementTypeCount];
+    RingBuffer<HistoryEntry> m_history[Sensor::kMeasurementTypeCount];
+    SeqLock<Published> m_published; // written by Record() only
+};
@@ -1,54 +1,67 @@
 #include "Measurements.h"
-#include "esp_timer.h"
-#include <stdexcept>
 
-void Measurements::AddId(uint32_t id, uint32_t averageWindowSizeSeconds, uint32_t peakWindowSizeSeconds)
+void Measurements::AddType(MeasurementType type, uint32_t averageWindowSizeSeconds, uint32_t peakWindowSizeSeconds,
+                           uint32_t minSamplePeriodSeconds)
 {
-    m_measurements.emplace(id, MeasuredValues(id, averageWindowSizeSeconds, peakWindowSizeSeconds));
+    m_slots[SlotOf(type)].emplace(static_cast<uint32_t>(type), Sensor::IsSigned(type), averageWindowSizeSeconds,
+                                  peakWindowSizeSeconds, minSamplePeriodSeconds);
 }
 
-void Measurements::AddMeasurement(uint32_t id, float value, float elapsedTimeSeconds)
+void Measurements::AddMeasurement(MeasurementType type, int32_t value, int64_t timestampUs)
 {
-    auto it = m_measurements.find(id);
-    it->second.Add(value, elapsedTimeSeconds);
+    auto& slot = m_slots[SlotOf(type)];
+    if (slot) {
+        slot->Add(value, timestampUs);
+    }
 }
 
-float Measurements::GetLatest(uint32_t id)
+void Measurements::AddMeasurement(MeasurementType type, int32_t value, int32_t lowValue, int32_t peakValue,
+                                  int64_t timestampUs)
 {
-    auto it = m_measurements.find(id);
-    return it->second.GetLatest();
+    auto& slot = m_slots[SlotOf(type)];
+    if (slot) {
+        slot->Add(value, lowValue, peakValue, timestampUs);
+    }
 }
 
-float Measurements::GetAverage(uint32_t id)
+int32_t Measurements::GetLatest(MeasurementType type)
 {
-    auto it = m_measurements.find(id);
-    return it->second.GetAverage();
+    auto& slot = m_slots[SlotOf(type)];
+    return slot ? slot->GetLatest() : 0;
 }
 
-uint32_t Measurements::GetAverageWindowSizeSeconds(uint32_t id)
+int32_t Measurements::GetAverage(MeasurementType type)
 {
-    auto it = m_measurements.find(id);
-    return it->second.GetAverageWindowSizeSeconds();
+    auto& slot = m_slots[SlotOf(type)];
+    return slot ? slot->GetAverage() : 0;
 }
 
-float Measurements::GetPeak(uint32_t id)
+uint32_t Measurements::GetAverageWindowSizeSeconds(MeasurementType type)
 {
-    auto it = m_measurements.find(id);
-    return it->second.GetPeak();
+    auto& slot = m_slots[SlotOf(type)];
+    return slot ? slot->GetAverageWindowSizeSeconds() : 0;
 }
 
-uint32_t Measurements::GetPeakWindowSizeSeconds(uint32_t id)
+int32_t Measurements::GetPeak(MeasurementType type)
 {
-    auto it = m_measurements.find(id);
-    return it->second.GetPeakWindowSizeSeconds();
+    auto& slot = m_slots[SlotOf(type)];
+    return slot ? slot->GetPeak() : 0;
 }
 
-std::vector<uint32_t> Measurements::GetIds() const
+int32_t Measurements::GetMin(MeasurementType type)
 {
-    std::vector<uint32_t> ids;
-    ids.reserve(m_measurements.size()); // Optimize allocation
-    for (const auto& pair : m_measurements) {
-        ids.push_back(pair.first);
-    }
-    return ids;
-}
\ No newline at end of file
+    auto& slot = m_slots[SlotOf(type)];
+    return slot ? slot->GetMin() : 0;
+}
+
+uint32_t Measurements::GetPeakWindowSizeSeconds(MeasurementType type)
+{
+    auto& slot = m_slots[SlotOf(type)];
+    return slot ? slot->GetPeakWindowSizeSeconds() : 0;
+}
+
+uint8_t Measurements::GetFillPercent(MeasurementType type)
+{
+    auto& slot = m_slots[SlotOf(type)];
+    return slot ? slot->GetFillPercent() : 0;
+}
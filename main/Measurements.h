@@ -1,38 +1,74 @@
 #pragma once
 #include "MeasuredValues.h"
+#include "sensors/Sensor.h"
+#include <stddef.h>
 #include <stdint.h>
-#include <map>
-#include <vector>
+#include <optional>
 
+// Per-metric statistics in a flat array with one slot per
+// Sensor::MeasurementType, so every access is an index instead of a lookup.
+// Only the types added with AddType() hold a window; the others read as 0.
 class Measurements
 {
 public:
+    using MeasurementType = Sensor::MeasurementType;
+
     // Constructor (default, no initialization needed)
     Measurements() = default;
 
-    // Add an ID with its window sizes
-    void AddId(uint32_t id, uint32_t averageWindowSizeSeconds, uint32_t peakWindowSizeSeconds);
+    static constexpr size_t SlotOf(MeasurementType type) { return static_cast<size_t>(type); }
+
+    // Samples closer together than this (the shortest refresh period) share
+    // one slot of the stored window
+    static constexpr uint32_t kMinSamplePeriodSeconds = 10;
+
+    // Start tracking a type with its window sizes. Its storage is allocated
+    // here, once. All values in and out are in the type's native steps
+    // (Sensor::NativeScale()).
+    void AddType(MeasurementType type, uint32_t averageWindowSizeSeconds, uint32_t peakWindowSizeSeconds,
+                 uint32_t minSamplePeriodSeconds = kMinSamplePeriodSeconds);
+
+    bool Has(MeasurementType type) const { return m_slots[SlotOf(type)].has_value(); }
+
+    // Add a measurement for a type, taken at timestampUs (esp_timer time);
+    // ignored for a type that isn't tracked
+    void AddMeasurement(MeasurementType type, int32_t value, int64_t timestampUs);
+
+    // Add an interval measurement (mean) with the interval's lowest and highest reading
+    void AddMeasurement(MeasurementType type, int32_t value, int32_t lowValue, int32_t peakValue, int64_t timestampUs);
+
+    // Get the latest measurement for a type
+    int32_t GetLatest(MeasurementType type);
 
-    // Add a measurement for a specific ID
-    void AddMeasurement(uint32_t id, float value, float elapsedTimeSeconds);
+    // Get the average measurement for a type over its window
+    int32_t GetAverage(MeasurementType type);
 
-    // Get the latest measurement for an ID
-    float GetLatest(uint32_t id);
+    // Get the average window size for a type
+    uint32_t GetAverageWindowSizeSeconds(MeasurementType type);
 
-    // Get the average measurement for an ID over its window
-    float GetAverage(uint32_t id);
+    // Get the peak measurement for a type over its window
+    int32_t GetPeak(MeasurementType type);
 
-    // Get the average window size for an ID
-    uint32_t GetAverageWindowSizeSeconds(uint32_t id);
+    // Get the minimum measurement for a type over its peak window
+    int32_t GetMin(MeasurementType type);
 
-    // Get the peak measurement for an ID over its window
-    float GetPeak(uint32_t id);
+    // Get the peak window size for a type
+    uint32_t GetPeakWindowSizeSeconds(MeasurementType type);
 
-    // Get the peak window size for an ID
-    uint32_t GetPeakWindowSizeSeconds(uint32_t id);
+    // How full the type's preallocated window storage is, in percent
+    uint8_t GetFillPercent(MeasurementType type);
 
-    std::vector<uint32_t> GetIds() const;
+    // Calls fn(type) for every tracked type, in MeasurementType order
+    template <typename Fn>
+    void ForEachType(Fn fn) const
+    {
+        for (size_t i = 0; i < Sensor::kMeasurementTypeCount; i++) {
+            if (m_slots[i].has_value()) {
+                fn(static_cast<MeasurementType>(i));
+            }
+        }
+    }
 
 private:
-    std::map<uint32_t, MeasuredValues> m_measurements; // Maps ID to its MeasuredValues
-};
\ No newline at end of file
+    std::optional<MeasuredValues> m_slots[Sensor::kMeasurementTypeCount];
+};
@@ -0,0 +1,106 @@
+#include "QuantileSketch.h"
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+QuantileSketch::QuantileSketch(int32_t minValue, int32_t maxValue, float relativeError, uint32_t maxWindowSeconds,
+                               uint32_t slotSeconds)
+    : m_minValue((float)minValue)
+    , m_maxValue((float)maxValue)
+    , m_slotSeconds(std::max<uint32_t>(slotSeconds, 1))
+{
+    float gamma = (1.0f + relativeError) / (1.0f - relativeError);
+    m_logGamma = logf(gamma);
+    m_midpointFactor = 2.0f * gamma / (1.0f + gamma);
+    // Bin 0 is below minValue, the last one starts at or above maxValue
+    m_binCount = (uint16_t)(ceilf(logf(m_maxValue / m_minValue) / m_logGamma) + 2);
+
+    // Bin b >= 1 holds the integers in [minValue * gamma^(b - 1), minValue *
+    // gamma^b): its lowest is the ceiling of its lower edge
+    m_edges.reset(new int32_t[m_binCount - 1]);
+    for (uint16_t bin = 1; bin < m_binCount; bin++) {
+        m_edges[bin - 1] = (int32_t)ceil(minValue * exp((bin - 1) * (double)m_logGamma));
+    }
+
+    // The slots of the window plus the one it cuts at its start
+    m_slotCount = (uint16_t)((maxWindowSeconds + m_slotSeconds - 1) / m_slotSeconds + 1);
+    m_slotPeriods.reset(new uint32_t[m_slotCount]);
+    m_counts.reset(new uint16_t[(size_t)m_slotCount * m_binCount]);
+    for (uint16_t i = 0; i < m_slotCount; i++) {
+        m_slotPeriods[i] = UINT32_MAX;
+    }
+    memset(m_counts.get(), 0, (size_t)m_slotCount * m_binCount * sizeof(uint16_t));
+}
+
+uint16_t QuantileSketch::BinOf(int32_t value) const
+{
+    // Bins whose lowest value is at most value; bin 0 has none
+    const int32_t* edges = m_edges.get();
+    return (uint16_t)(std::upper_bound(edges, edges + m_binCount - 1, value) - edges);
+}
+
+float QuantileSketch::ValueOf(uint16_t bin) const
+{
+    if (bin == 0) {
+        return m_minValue / 2.0f;
+    }
+    // The bin holding maxValue may report past it: clamped, so a value never
+    // reports above a larger one
+    return std::min(m_minValue * expf((bin - 1) * m_logGamma) * m_midpointFactor, m_maxValue);
+}
+
+void QuantileSketch::Add(int32_t value, int64_t timestampUs)
+{
+    uint32_t slot = (uint32_t)(timestampUs / 1000000 / m_slotSeconds);
+    uint16_t row = slot % m_slotCount;
+    uint16_t* counts = &m_counts[(size_t)row * m_binCount];
+    if (m_slotPeriods[row] != slot) {
+        m_slotPeriods[row] = slot;
+        memset(counts, 0, m_binCount * sizeof(uint16_t));
+    }
+
+    uint16_t bin = BinOf(value);
+    if (counts[bin] < UINT16_MAX) {
+        counts[bin]++;
+    }
+    m_newestSlot = std::max(m_newestSlot, slot);
+}
+
+QuantileSketch::Percentiles QuantileSketch::GetPercentiles(uint32_t windowSeconds) const
+{
+    // Slots overlapping (newest - windowSeconds, newest]
+    uint32_t windowSlots = std::min<uint32_t>((windowSeconds + m_slotSeconds - 1) / m_slotSeconds + 1, m_slotCount);
+    auto inWindow = [&](uint16_t row) {
+        return m_slotPeriods[row] != UINT32_MAX && m_newestSlot - m_slotPeriods[row] < windowSlots;
+    };
+
+    uint32_t total = 0;
+    for (uint16_t row = 0; row < m_slotCount; row++) {
+        if (inWindow(row)) {
+            const uint16_t* counts = &m_counts[(size_t)row * m_binCount];
+            for (uint16_t bin = 0; bin < m_binCount; bin++) {
+                total += counts[bin];
+            }
+        }
+    }
+    if (total == 0) {
+        return {NAN, NAN, NAN, 0};
+    }
+
+    // Nearest-rank percentiles, all three in one pass over the bins
+    const float kQuantiles[] = {0.50f, 0.95f, 0.99f};
+    float results[3];
+    int next = 0;
+    uint32_t cumulative = 0;
+    for (uint16_t bin = 0; bin < m_binCount && next < 3; bin++) {
+        for (uint16_t row = 0; row < m_slotCount; row++) {
+            if (inWindow(row)) {
+                cumulative += m_counts[(size_t)row * m_binCount + bin];
+            }
+        }
+        while (next < 3 && cumulative >= (uint32_t)ceilf(kQuantiles[next] * total)) {
+            results[next++] = ValueOf(bin);
+        }
+    }
+    return {results[0], results[1], results[2], total};
+}
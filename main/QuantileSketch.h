@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+
+// Streaming percentiles of one measurement over sliding windows, without
+// keeping raw samples. Values are integers (a type's native steps) counted in
+// a fixed log-spaced histogram: bin edges grow by gamma = (1 + relativeError)
+// / (1 - relativeError) from minValue up to maxValue, and a bin reports
+// 2 * lower * gamma / (1 + gamma), which is within relativeError of both its
+// edges, so any percentile in [minValue, maxValue] is within relativeError of
+// the true sample percentile. Values below minValue share one bin reported as
+// minValue / 2 (absolute error at most minValue / 2); values at or above
+// maxValue are reported as maxValue, and no bin reports more.
+//
+// The edges are worked out once by the constructor into a table of the lowest
+// integer in each bin, so Add() is a binary search over it: no floating
+// point, which the C6 would run in software. Only the constructor and
+// GetPercentiles() use floats.
+//
+// Time is cut into slots (one hour by default), each with its own histogram in
+// a preallocated ring, so the window is accurate to one slot. A query sums the
+// histograms of the slots in its window.
+class QuantileSketch
+{
+public:
+    // In the same steps as the values added
+    struct Percentiles {
+        float p50;
+        float p95;
+        float p99;
+        uint32_t count; // samples in the window; 0 (and NAN values) if none
+    };
+
+    // minValue > 0
+    QuantileSketch(int32_t minValue, int32_t maxValue, float relativeError, uint32_t maxWindowSeconds,
+                   uint32_t slotSeconds = 3600);
+
+    // Adds one sample taken at timestampUs (esp_timer time)
+    void Add(int32_t value, int64_t timestampUs);
+
+    // Percentiles over the windowSeconds before the newest sample (at most
+    // the maxWindowSeconds given to the constructor)
+    Percentiles GetPercentiles(uint32_t windowSeconds) const;
+
+    // Preallocated histogram and edge storage, in bytes
+    size_t GetMemorySize() const
+    {
+        return (size_t)m_slotCount * m_binCount * sizeof(uint16_t) + (m_binCount - 1) * sizeof(int32_t);
+    }
+
+private:
+    uint16_t BinOf(int32_t value) const;
+    float ValueOf(uint16_t bin) const;
+
+    float m_minValue;
+    float m_maxValue;
+    float m_logGamma;
+    float m_midpointFactor; // reported value over the bin's lower edge
+    uint16_t m_binCount;
+    uint32_t m_slotSeconds;
+    uint16_t m_slotCount;
+    uint32_t m_newestSlot = 0;
+    std::unique_ptr<int32_t[]> m_edges;        // lowest value of bins 1 .. m_binCount - 1
+    std::unique_ptr<uint32_t[]> m_slotPeriods; // slot number each ring entry holds
+    std::unique_ptr<uint16_t[]> m_counts;      // m_slotCount rows of m_binCount bins
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stddef.h>
+#include <memory>
+
+// Fixed-capacity double-ended queue over a single allocation made when the
+// capacity is set; nothing touches the heap afterwards, so a long-running
+// window can't churn or fragment it. Index 0 is the oldest element. Pushing
+// onto a full buffer drops the oldest element.
+template <typename T>
+class RingBuffer
+{
+public:
+    RingBuffer() = default;
+
+    explicit RingBuffer(size_t capacity) { SetCapacity(capacity); }
+
+    // Allocates room for capacity elements and empties the buffer
+    void SetCapacity(size_t capacity)
+    {
+        m_data.reset(capacity > 0 ? new T[capacity] : nullptr);
+        m_capacity = capacity;
+        Clear();
+    }
+
+    size_t Size() const { return m_size; }
+    size_t Capacity() const { return m_capacity; }
+    bool IsEmpty() const { return m_size == 0; }
+    bool IsFull() const { return m_size == m_capacity; }
+
+    T& Front() { return m_data[m_head]; }
+    const T& Front() const { return m_data[m_head]; }
+    T& Back() { return m_data[Wrap(m_head + m_size - 1)]; }
+    const T& Back() const { return m_data[Wrap(m_head + m_size - 1)]; }
+    T& operator[](size_t index) { return m_data[Wrap(m_head + index)]; }
+    const T& operator[](size_t index) const { return m_data[Wrap(m_head + index)]; }
+
+    // Returns false when the buffer was full and the oldest element was dropped
+    bool PushBack(const T& value)
+    {
+        if (m_capacity == 0) {
+            return false;
+        }
+        bool dropped = IsFull();
+        if (dropped) {
+            PopFront();
+        }
+        m_data[Wrap(m_head + m_size)] = value;
+        m_size++;
+        return !dropped;
+    }
+
+    void PopFront()
+    {
+        m_head = Wrap(m_head + 1);
+        m_size--;
+    }
+
+    void PopBack() { m_size--; }
+
+    void Clear()
+    {
+        m_head = 0;
+        m_size = 0;
+    }
+
+private:
+    size_t Wrap(size_t index) const { return index >= m_capacity ? index - m_capacity : index; }
+
+    std::unique_ptr<T[]> m_data;
+    size_t m_capacity = 0;
+    size_t m_head = 0;
+    size_t m_size = 0;
+};
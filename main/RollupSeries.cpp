@@ -0,0 +1,118 @@
+#include "RollupSeries.h"
+#include <algorithm>
+
+RollupSeries::RollupSeries()
+{
+    for (int tier = 0; tier < kTierCount; tier++) {
+        // One more cell than the span, for the one cut by the window's start
+        m_closed[tier].SetCapacity(kSpanSeconds[tier] / kPeriodSeconds[tier] + 1);
+    }
+}
+
+void RollupSeries::Merge(Cell& into, const Cell& from)
+{
+    if (from.count == 0) {
+        return;
+    }
+    if (into.count == 0) {
+        into.min = from.min;
+        into.max = from.max;
+    } else {
+        into.min = std::min(into.min, from.min);
+        into.max = std::max(into.max, from.max);
+    }
+    into.sum += from.sum;
+    into.count += from.count;
+}
+
+RollupSeries::Summary RollupSeries::SummaryOf(const Cell& cell)
+{
+    if (cell.count == 0) {
+        return {Sensor::kNoValue, Sensor::kNoValue, Sensor::kNoValue, 0};
+    }
+    // Half away from zero
+    int64_t half = cell.count / 2;
+    int64_t mean = (cell.sum + (cell.sum >= 0 ? half : -half)) / (int64_t)cell.count;
+    return {(int32_t)mean, cell.min, cell.max, cell.count};
+}
+
+void RollupSeries::Roll(int tier, uint32_t seconds)
+{
+    uint32_t start = seconds - seconds % kPeriodSeconds[tier];
+    Cell& open = m_open[tier];
+    if (open.count == 0 || open.start == start) {
+        open.start = start;
+        return;
+    }
+
+    m_closed[tier].PushBack(open);
+    if (tier + 1 < kTierCount) {
+        Roll(tier + 1, open.start);
+        Merge(m_open[tier + 1], open);
+    }
+    open = Cell{start, 0, 0, 0, 0};
+}
+
+void RollupSeries::Add(int32_t value, int32_t low, int32_t high, int64_t timestampUs)
+{
+    uint32_t seconds = (uint32_t)(timestampUs / 1000000);
+    Roll(kMinute, seconds);
+    Merge(m_open[kMinute], Cell{0, 1, value, low, high});
+    m_newestSeconds = seconds;
+}
+
+RollupSeries::Summary RollupSeries::Query(uint32_t windowSeconds) const
+{
+    int tier = kMinute;
+    while (tier + 1 < kTierCount && kSpanSeconds[tier] < windowSeconds) {
+        tier++;
+    }
+    uint32_t cutoff = m_newestSeconds > windowSeconds ? m_newestSeconds - windowSeconds : 0;
+
+    // The tier's closed cells plus the open cells of it and every finer tier
+    // cover the window without overlap: an open cell only holds closed cells
+    // of the tier below, never their open one
+    Cell total = {};
+    const RingBuffer<Cell>& closed = m_closed[tier];
+    for (size_t i = closed.Size(); i-- > 0;) {
+        if (closed[i].start + kPeriodSeconds[tier] <= cutoff) {
+            break;
+        }
+        Merge(total, closed[i]);
+    }
+    for (int t = kMinute; t <= tier; t++) {
+        if (m_open[t].start + kPeriodSeconds[t] > cutoff) {
+            Merge(total, m_open[t]);
+        }
+    }
+
+    return SummaryOf(total);
+}
+
+bool RollupSeries::GetNewestClosed(Tier tier, uint32_t& startSeconds, Summary& summary) const
+{
+    const RingBuffer<Cell>& closed = m_closed[tier];
+    if (closed.IsEmpty()) {
+        return false;
+    }
+    const Cell& cell = closed.Back();
+    startSeconds = cell.start;
+    summary = SummaryOf(cell);
+    return true;
+}
+
+void RollupSeries::AddCell(Tier tier, uint32_t startSeconds, const Summary& summary)
+{
+    Roll(tier, startSeconds);
+    Merge(m_open[tier], Cell{0, summary.count, (int64_t)summary.mean * summary.count, summary.min, summary.max});
+    m_newestSeconds = std::max(m_newestSeconds, startSeconds);
+}
+
+size_t RollupSeries::GetCellCount() const
+{
+    size_t count = 0;
+    for (int tier = 0; tier < kTierCount; tier++) {
+        count += m_closed[tier].Size();
+    }
+    return count;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "RingBuffer.h"
+#include "sensors/Sensor.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Long-term history of one measurement, cascaded into fixed-size rollups:
+// samples are aggregated into per-minute cells, each closed minute into the
+// current hour's cell and each closed hour into the current day's cell. A cell
+// holds the mean, minimum, maximum and sample count of its period, so a query
+// for the last 24 h or 7 days reads a few dozen cells of the coarsest tier
+// that spans it instead of every raw sample. Values are integers in the type's
+// native steps (Sensor::NativeScale()) and each cell keeps an exact 64-bit
+// sum, so adding a sample and merging cells take no floating point. All cells
+// are preallocated by the constructor (about 3.4 kB); periods are aligned to
+// esp_timer time.
+class RollupSeries
+{
+public:
+    enum Tier { kMinute = 0, kHour, kDay, kTierCount };
+
+    // In native steps; the mean is rounded to a whole step
+    struct Summary {
+        int32_t mean;
+        int32_t min;
+        int32_t max;
+        uint32_t count; // samples aggregated; 0 (and Sensor::kNoValue values) if none
+    };
+
+    // Longest window Query() can answer
+    static constexpr uint32_t kMaxWindowSeconds = 31 * 86400;
+
+    RollupSeries();
+
+    // Adds one sample taken at timestampUs (esp_timer time); an interval
+    // sample brings its own lowest and highest reading
+    void Add(int32_t value, int32_t low, int32_t high, int64_t timestampUs);
+
+    void Add(int32_t value, int64_t timestampUs) { Add(value, value, value, timestampUs); }
+
+    // Aggregate over the windowSeconds before the newest sample. Cells are
+    // taken whole, so the window is accurate to one period of the tier used.
+    Summary Query(uint32_t windowSeconds) const;
+
+    // Closed cells currently held across all tiers
+    size_t GetCellCount() const;
+
+    // The newest closed cell of a tier and its start. Returns false if the
+    // tier has none yet.
+    bool GetNewestClosed(Tier tier, uint32_t& startSeconds, Summary& summary) const;
+
+    // Adds a whole cell, e.g. one saved before a reboot, as if its samples had
+    // just been added; cells must come in time order and before any sample
+    // of a later period
+    void AddCell(Tier tier, uint32_t startSeconds, const Summary& summary);
+
+private:
+    struct Cell {
+        uint32_t start; // seconds, a multiple of the tier's period
+        uint32_t count;
+        int64_t sum;
+        int32_t min;
+        int32_t max;
+    };
+
+    static constexpr uint32_t kPeriodSeconds[kTierCount] = {60, 3600, 86400};
+    static constexpr uint32_t kSpanSeconds[kTierCount] = {3600, 48 * 3600, kMaxWindowSeconds};
+
+    // Closes the tier's open cell if seconds falls in a later period, merging
+    // it into the next tier up
+    void Roll(int tier, uint32_t seconds);
+    static void Merge(Cell& into, const Cell& from);
+    static Summary SummaryOf(const Cell& cell);
+
+    RingBuffer<Cell> m_closed[kTierCount]; // oldest first
+    Cell m_open[kTierCount] = {};          // the period in progress
+    uint32_t m_newestSeconds = 0;
+};
@@ -0,0 +1,45 @@
+#include "SampleAccumulator.h"
+
+void SampleAccumulator::Add(const MeasurementSnapshot& sample)
+{
+    for (size_t i = 0; i < Sensor::kMeasurementTypeCount; i++) {
+        if (!sample.Has(static_cast<Sensor::MeasurementType>(i))) {
+            continue;
+        }
+        int32_t value = sample.values[i];
+        if (m_count[i] == 0) {
+            m_min[i] = value;
+            m_max[i] = value;
+        } else {
+            if (value < m_min[i]) m_min[i] = value;
+            if (value > m_max[i]) m_max[i] = value;
+        }
+        m_sum[i] += value;
+        m_count[i]++;
+    }
+    m_samples++;
+}
+
+bool SampleAccumulator::Decimate(int64_t timestampUs, MeasurementSnapshot& snapshot) const
+{
+    snapshot = MeasurementSnapshot();
+    snapshot.timestampUs = timestampUs;
+    snapshot.sampleCount = m_samples;
+
+    for (size_t i = 0; i < Sensor::kMeasurementTypeCount; i++) {
+        if (m_count[i] == 0) {
+            continue;
+        }
+        int64_t half = m_count[i] / 2;
+        snapshot.values[i] = (int32_t)((m_sum[i] + (m_sum[i] >= 0 ? half : -half)) / m_count[i]);
+        snapshot.minValues[i] = m_min[i];
+        snapshot.maxValues[i] = m_max[i];
+        snapshot.validMask |= MeasurementSnapshot::Bit(static_cast<Sensor::MeasurementType>(i));
+    }
+    return !snapshot.IsEmpty();
+}
+
+void SampleAccumulator::Reset()
+{
+    *this = SampleAccumulator();
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "MeasurementSnapshot.h"
+#include <stdint.h>
+
+// Collects the 1 Hz sensor samples taken between two reports and decimates
+// them into one snapshot holding the mean, minimum and maximum of each value
+// over the whole interval. Fixed size: a running integer sum, min, max and
+// count per measurement type (native steps), no per-sample storage.
+class SampleAccumulator
+{
+public:
+    // Adds one sample; values missing from it are simply not counted
+    void Add(const MeasurementSnapshot& sample);
+
+    // Number of samples added since the last Reset()
+    uint16_t GetSampleCount() const { return m_samples; }
+
+    // Writes the interval's mean/min/max into snapshot, stamped with
+    // timestampUs. Returns false if no sample was added.
+    bool Decimate(int64_t timestampUs, MeasurementSnapshot& snapshot) const;
+
+    void Reset();
+
+private:
+    int64_t m_sum[Sensor::kMeasurementTypeCount] = {}; // 65535 samples of 40000 ppm CO2 overflow 32 bits
+    int32_t m_min[Sensor::kMeasurementTypeCount] = {};
+    int32_t m_max[Sensor::kMeasurementTypeCount] = {};
+    uint16_t m_count[Sensor::kMeasurementTypeCount] = {};
+    uint16_t m_samples = 0;
+};
@@ -0,0 +1,114 @@
+#include "SampleFilter.h"
+#include <algorithm>
+#include <cmath>
+#include <stdlib.h>
+
+void SampleFilter::Configure(Sensor::MeasurementType type, const Config& config)
+{
+    size_t i = static_cast<size_t>(type);
+    State& state = m_state[i];
+    state = {};
+    state.config = config;
+    state.hampelFloor = (int32_t)lroundf(config.hampelFloor * Sensor::NativeScale(type));
+    state.hampel.size = std::min(config.hampelWindow, kMaxWindow);
+    state.median.size = std::min(config.medianWindow, kMaxWindow);
+    m_configuredMask |= MeasurementSnapshot::Bit(type);
+}
+
+void SampleFilter::Window::Push(int32_t value)
+{
+    values[next] = value;
+    next = (uint8_t)((next + 1) % size);
+    if (count < size) {
+        count++;
+    }
+}
+
+int32_t SampleFilter::Window::Median() const
+{
+    int32_t sorted[kMaxWindow];
+    std::copy(values, values + count, sorted);
+    return MedianOf(sorted, count);
+}
+
+int32_t SampleFilter::MedianOf(int32_t* values, uint8_t count)
+{
+    // Insertion sort: at most kMaxWindow elements
+    for (uint8_t i = 1; i < count; i++) {
+        int32_t v = values[i];
+        uint8_t j = i;
+        for (; j > 0 && values[j - 1] > v; j--) {
+            values[j] = values[j - 1];
+        }
+        values[j] = v;
+    }
+    int32_t upper = values[count / 2];
+    return count % 2 ? upper : values[count / 2 - 1] + (upper - values[count / 2 - 1]) / 2;
+}
+
+uint32_t SampleFilter::Apply(MeasurementSnapshot& sample)
+{
+    uint32_t rejectedMask = 0;
+
+    for (size_t i = 0; i < Sensor::kMeasurementTypeCount; i++) {
+        auto type = static_cast<Sensor::MeasurementType>(i);
+        if (!(m_configuredMask & MeasurementSnapshot::Bit(type)) || !sample.Has(type)) {
+            continue;
+        }
+        State& state = m_state[i];
+        int32_t x = sample.values[i];
+
+        if (state.hampel.size >= 3) {
+            state.hampel.Push(x);
+            if (state.hampel.count >= 3) {
+                int32_t median = state.hampel.Median();
+                int32_t deviations[kMaxWindow];
+                for (uint8_t k = 0; k < state.hampel.count; k++) {
+                    deviations[k] = abs(state.hampel.values[k] - median);
+                }
+                int32_t mad = MedianOf(deviations, state.hampel.count);
+                int32_t deviation = abs(x - median);
+                // sigma ~ 1.4826 * MAD; compared in units of 1/10000
+                if (deviation > state.hampelFloor &&
+                    (int64_t)deviation * 10000 > (int64_t)state.config.hampelSigmaX10 * 1483 * mad) {
+                    x = median;
+                    rejectedMask |= MeasurementSnapshot::Bit(type);
+                    m_rejected++;
+                }
+            }
+        }
+
+        if (state.median.size >= 2) {
+            state.median.Push(x);
+            x = state.median.Median();
+        }
+
+        if (state.config.ewmaShift > 0) {
+            int32_t fixed = x * (1 << kEwmaFractionBits);
+            if (!state.ewmaPrimed) {
+                state.ewma = fixed;
+                state.ewmaPrimed = true;
+            } else {
+                state.ewma += (fixed - state.ewma) / (1 << state.config.ewmaShift);
+            }
+            x = (state.ewma + (1 << (kEwmaFractionBits - 1))) >> kEwmaFractionBits;
+        }
+
+        // A raw sample's interval extremes are the sample itself
+        sample.values[i] = x;
+        sample.minValues[i] = x;
+        sample.maxValues[i] = x;
+    }
+    return rejectedMask;
+}
+
+void SampleFilter::Reset()
+{
+    for (State& state : m_state) {
+        state.hampel.count = 0;
+        state.hampel.next = 0;
+        state.median.count = 0;
+        state.median.next = 0;
+        state.ewmaPrimed = false;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "MeasurementSnapshot.h"
+#include <stdint.h>
+
+// Per-measurement streaming filter run on every raw sensor sample before
+// anything else sees it (the accumulator, the change watch, the reports and
+// so the air-quality classification and the LED). Each type passes through
+// up to three stages, in order:
+//
+//   Hampel  replaces a sample that lies more than a few sigmas (estimated
+//           from the median absolute deviation) from the median of the last
+//           hampelWindow raw samples with that median, so one-off spikes
+//           are dropped while real steps get through after half a window
+//   median  the median of the last medianWindow stage outputs
+//   EWMA    y += (x - y) / 2^ewmaShift
+//
+// All stages work on integers in the sensor's native units (see
+// Sensor::NativeScale()) with fixed-size state per type; no stage is enabled
+// until Configure() is called for a type.
+class SampleFilter
+{
+public:
+    static constexpr uint8_t kMaxWindow = 7;
+
+    struct Config {
+        uint8_t hampelWindow = 0;     // 3..kMaxWindow samples, 0 disables
+        uint8_t hampelSigmaX10 = 30;  // rejection threshold in tenths of a sigma
+        float hampelFloor = 0.0f;     // deviations up to this are never outliers
+        uint8_t medianWindow = 0;     // 2..kMaxWindow samples, 0 disables
+        uint8_t ewmaShift = 0;        // alpha = 1 / 2^ewmaShift, 0 disables
+    };
+
+    void Configure(Sensor::MeasurementType type, const Config& config);
+
+    // Filters one raw sample in place. Returns the types whose value the
+    // Hampel stage rejected, as snapshot bits.
+    uint32_t Apply(MeasurementSnapshot& sample);
+
+    // Forgets all history, e.g. when the sampling period changes
+    void Reset();
+
+    // Samples rejected as outliers since boot
+    uint32_t GetRejectedCount() const { return m_rejected; }
+
+private:
+    // Last samples of one stage, newest overwriting the oldest
+    struct Window {
+        int32_t values[kMaxWindow];
+        uint8_t size;
+        uint8_t count;
+        uint8_t next;
+
+        void Push(int32_t value);
+        int32_t Median() const;
+    };
+
+    struct State {
+        Config config;
+        int32_t hampelFloor; // native units
+        Window hampel;
+        Window median;
+        int32_t ewma;        // native units << kEwmaFractionBits
+        bool ewmaPrimed;
+    };
+
+    static constexpr int kEwmaFractionBits = 8;
+
+    static int32_t MedianOf(int32_t* values, uint8_t count); // sorts values
+
+    State m_state[Sensor::kMeasurementTypeCount] = {};
+    uint32_t m_configuredMask = 0;
+    uint32_t m_rejected = 0;
+};
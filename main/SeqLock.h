@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+// Hands a small value from one writer task to any number of readers without
+// a lock: readers never block the writer or each other, and never wait for a
+// writer that a higher-priority reader has preempted.
+//
+// Each publication gets the next sequence number and goes into the slot the
+// newest one is not in, so a reader copies a complete value while the next is
+// being written. A slot's own sequence is 0 while it's being written; a
+// reader that sees it change across its copy (the writer lapped it) retries
+// and counts the torn read. The payload is copied as relaxed atomic words, so
+// a racing copy is well defined, just discarded.
+//
+// Only one task may call Publish().
+template <typename T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "payload is copied word by word");
+    static_assert(sizeof(T) % sizeof(uint32_t) == 0, "payload must be whole 32-bit words");
+
+public:
+    // Publishes value; returns its sequence number (1 for the first)
+    uint32_t Publish(const T& value)
+    {
+        uint32_t sequence = m_published.load(std::memory_order_relaxed) + 1;
+        Slot& slot = m_slots[sequence & 1];
+
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+        for (size_t i = 0; i < kWords; i++) {
+            uint32_t word;
+            memcpy(&word, bytes + i * sizeof(word), sizeof(word));
+            slot.words[i].store(word, std::memory_order_relaxed);
+        }
+        slot.sequence.store(sequence, std::memory_order_release);
+        m_published.store(sequence, std::memory_order_release);
+        return sequence;
+    }
+
+    // Copies the newest publication into value and returns its sequence
+    // number; returns 0 and leaves value alone before the first Publish()
+    uint32_t Read(T& value) const
+    {
+        unsigned char* bytes = reinterpret_cast<unsigned char*>(&value);
+        for (;;) {
+            uint32_t sequence = m_published.load(std::memory_order_acquire);
+            if (sequence == 0) {
+                return 0;
+            }
+            const Slot& slot = m_slots[sequence & 1];
+
+            uint32_t before = slot.sequence.load(std::memory_order_acquire);
+            uint32_t words[kWords];
+            for (size_t i = 0; i < kWords; i++) {
+                words[i] = slot.words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint32_t after = slot.sequence.load(std::memory_order_relaxed);
+
+            if (before == sequence && after == sequence) {
+                memcpy(bytes, words, sizeof(words));
+                return sequence;
+            }
+            m_tornReads.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Sequence number of the newest publication, 0 before the first
+    uint32_t Sequence() const { return m_published.load(std::memory_order_acquire); }
+
+    // Reads that raced a write and were retried, since boot
+    uint32_t TornReads() const { return m_tornReads.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t kWords = sizeof(T) / sizeof(uint32_t);
+
+    struct Slot {
+        std::atomic<uint32_t> sequence{0}; // of the value in words, 0 while written
+        std::atomic<uint32_t> words[kWords] = {};
+    };
+
+    // A 32-bit sequence lasts 136 years at one publication per second
+    std::atomic<uint32_t> m_published{0};
+    Slot m_slots[2];
+    mutable std::atomic<uint32_t> m_tornReads{0};
+};
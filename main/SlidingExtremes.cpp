@@ -0,0 +1,58 @@
+#include "SlidingExtremes.h"
+#include <algorithm>
+
+SlidingExtremes::SlidingExtremes(uint32_t windowSizeSeconds, uint32_t resolutionSeconds)
+    : m_windowSizeSeconds(windowSizeSeconds)
+    , m_resolutionSeconds(std::max<uint32_t>(resolutionSeconds, 1))
+{
+    // One entry per bucket in the window, plus the partial buckets at each end
+    size_t capacity = m_windowSizeSeconds / m_resolutionSeconds + 2;
+    m_maxima.SetCapacity(capacity);
+    m_minima.SetCapacity(capacity);
+}
+
+template <typename Keep>
+void SlidingExtremes::Push(RingBuffer<Entry>& wedge, int32_t value, uint32_t seconds, Keep keep)
+{
+    while (!wedge.IsEmpty() && !keep(wedge.Back().value, value)) {
+        wedge.PopBack();
+    }
+
+    // A sample that doesn't beat the newest entry of its own bucket is merged
+    // into it by moving that entry's time forward
+    if (!wedge.IsEmpty() && wedge.Back().seconds / m_resolutionSeconds == seconds / m_resolutionSeconds) {
+        wedge.Back().seconds = seconds;
+        return;
+    }
+    wedge.PushBack({value, seconds});
+}
+
+void SlidingExtremes::Add(int32_t low, int32_t high, int64_t timestampUs)
+{
+    uint32_t seconds = (uint32_t)(timestampUs / 1000000);
+    Push(m_maxima, high, seconds, [](int32_t kept, int32_t added) { return kept > added; });
+    Push(m_minima, low, seconds, [](int32_t kept, int32_t added) { return kept < added; });
+
+    // The newest entry is never evicted, so neither wedge runs empty
+    while (seconds - m_maxima.Front().seconds > m_windowSizeSeconds) {
+        m_maxima.PopFront();
+    }
+    while (seconds - m_minima.Front().seconds > m_windowSizeSeconds) {
+        m_minima.PopFront();
+    }
+}
+
+int32_t SlidingExtremes::GetMin() const
+{
+    return m_minima.IsEmpty() ? 0 : m_minima.Front().value;
+}
+
+int32_t SlidingExtremes::GetMax() const
+{
+    return m_maxima.IsEmpty() ? 0 : m_maxima.Front().value;
+}
+
+size_t SlidingExtremes::GetSize() const
+{
+    return std::max(m_maxima.Size(), m_minima.Size());
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "RingBuffer.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Lowest and highest value over a sliding time window, in amortised O(1) per
+// sample. Each side is a monotonic deque ("wedge") holding only the samples
+// that can still become the window's extreme: a new maximum discards every
+// older, smaller entry, since those expire first and can never win again.
+//
+// Samples are merged into buckets of resolutionSeconds, at most one entry per
+// bucket and side, so both wedges are preallocated once for the window and
+// never grow however fast samples arrive. The window is thus accurate to one
+// resolution step. Times are whole seconds, exact for over a century.
+class SlidingExtremes
+{
+public:
+    SlidingExtremes(uint32_t windowSizeSeconds, uint32_t resolutionSeconds);
+
+    // Adds one sample taken at timestampUs (esp_timer time); an interval
+    // sample brings its own lowest and highest reading. The window ends at
+    // the newest sample's time.
+    void Add(int32_t low, int32_t high, int64_t timestampUs);
+
+    void Add(int32_t value, int64_t timestampUs) { Add(value, value, timestampUs); }
+
+    bool IsEmpty() const { return m_maxima.IsEmpty(); }
+
+    // Extremes over the window; only meaningful when not IsEmpty()
+    int32_t GetMin() const;
+    int32_t GetMax() const;
+
+    uint32_t GetWindowSizeSeconds() const { return m_windowSizeSeconds; }
+
+    // Entries held by the fuller wedge, and the room preallocated for each
+    size_t GetSize() const;
+    size_t GetCapacity() const { return m_maxima.Capacity(); }
+
+private:
+    struct Entry {
+        int32_t value;
+        uint32_t seconds;
+    };
+
+    // Pushes onto one wedge; keep(a, b) is true when a stays ahead of b
+    template <typename Keep>
+    void Push(RingBuffer<Entry>& wedge, int32_t value, uint32_t seconds, Keep keep);
+
+    uint32_t m_windowSizeSeconds;
+    uint32_t m_resolutionSeconds;
+    RingBuffer<Entry> m_maxima; // values strictly decreasing front to back
+    RingBuffer<Entry> m_minima; // values strictly increasing front to back
+};
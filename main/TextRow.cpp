@@ -0,0 +1,85 @@
+#include "TextRow.h"
+
+TextWriter::TextWriter(char* buffer, size_t size)
+    : m_buffer(buffer), m_size(size)
+{
+    m_buffer[0] = '\0';
+}
+
+void TextWriter::AppendChar(char c)
+{
+    if (m_length + 1 < m_size) {
+        m_buffer[m_length++] = c;
+        m_buffer[m_length] = '\0';
+    }
+}
+
+void TextWriter::AppendText(const char* text, int width)
+{
+    size_t length = 0;
+    while (text[length] != '\0') {
+        length++;
+    }
+    for (size_t i = length; i < (size_t)width; i++) {
+        AppendChar(' ');
+    }
+    for (size_t i = 0; i < length; i++) {
+        AppendChar(text[i]);
+    }
+}
+
+void TextWriter::AppendFixed(int32_t value, int decimals, int width, char fill)
+{
+    if (value == kMissing) {
+        AppendText("-", width);
+        return;
+    }
+
+    // Digits are produced right to left; 10 digits, a point and a sign fit
+    char digits[12];
+    int start = sizeof(digits);
+    uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+    for (int i = 0; i <= decimals || magnitude != 0; i++) {
+        if (i == decimals && decimals > 0) {
+            digits[--start] = '.';
+        }
+        digits[--start] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    }
+    if (value < 0) {
+        digits[--start] = '-';
+    }
+
+    for (int i = sizeof(digits) - start; i < width; i++) {
+        AppendChar(fill);
+    }
+    for (int i = start; i < (int)sizeof(digits); i++) {
+        AppendChar(digits[i]);
+    }
+}
+
+void TextWriter::AppendFloat(float value, int decimals, int width)
+{
+    // NAN fails both comparisons; out of range can't be printed as int32 steps
+    const float limit = 2e9f / Pow10(decimals);
+    if (!(value < limit && value > -limit)) {
+        AppendFixed(kMissing, decimals, width);
+        return;
+    }
+    float scaled = value * Pow10(decimals);
+    AppendFixed((int32_t)(scaled + (scaled >= 0.0f ? 0.5f : -0.5f)), decimals, width);
+}
+
+void TextWriter::AppendReading(Sensor::MeasurementType type, int32_t value)
+{
+    const Sensor::MeasurementInfo& info = Sensor::InfoOf(type);
+    AppendFixed(value == kMissing ? kMissing : Sensor::Rescale(type, value, Pow10(info.decimals)), info.decimals, 0);
+    AppendText(info.unit, 0);
+}
+
+void TextWriter::PadTo(size_t column)
+{
+    while (m_length < column && m_length + 1 < m_size) {
+        AppendChar(' ');
+    }
+}
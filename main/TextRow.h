@@ -0,0 +1,160 @@
+#pragma once
+
+#include "sensors/Sensor.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// HD44780 (A00 ROM) glyphs and the units the LCD shows with them
+namespace LcdGlyph {
+constexpr char kDegree = '\xDF';
+constexpr char kMicro = '\xE4';
+constexpr char kFullBlock = '\xFF';
+}
+
+namespace LcdUnit {
+constexpr const char kCelsius[] = "\xDF" "C";
+constexpr const char kPercentRH[] = "%RH";
+constexpr const char kMicrogramsPerM3[] = "\xE4g/m3";
+constexpr const char kPpm[] = "ppm";
+}
+
+// Appends text and fixed-point numbers to a caller's char buffer, always
+// NUL-terminated and silently truncated at its end. Numbers are printed from
+// integers (no printf, no float arithmetic), so an LCD row or a log value
+// costs a few integer divisions on the FPU-less C6 and never touches the heap.
+// Field widths and decimals are template arguments, checked at compile time
+// against the buffer. INT32_MIN (MeasurementStore::kNoValue) and NAN print
+// as "-".
+class TextWriter
+{
+public:
+    static constexpr int32_t kMissing = INT32_MIN;
+    static constexpr int kMaxDecimals = 4;
+
+    const char* CStr() const { return m_buffer; }
+    size_t Length() const { return m_length; }
+
+protected:
+    TextWriter(char* buffer, size_t size);
+
+    void AppendText(const char* text, int width);
+    void AppendChar(char c);
+    void AppendFixed(int32_t value, int decimals, int width, char fill = ' ');
+    void AppendFloat(float value, int decimals, int width);
+    void AppendReading(Sensor::MeasurementType type, int32_t value);
+    void PadTo(size_t column);
+
+    static constexpr int32_t Pow10(int decimals)
+    {
+        return decimals == 0 ? 1 : 10 * Pow10(decimals - 1);
+    }
+
+private:
+    char* m_buffer;
+    size_t m_size;
+    size_t m_length = 0;
+};
+
+// A TextWriter over a char array whose size is known at compile time:
+//
+//   char line[LCD2004::kColumns + 1];
+//   lcd->WriteLine(0, TextRow(line).Text("CO2 ").Int<4>(co2).Text(LcdUnit::kPpm).CStr());
+//
+// Width is the minimum field width (right-aligned, 0 for none) and Decimals
+// the digits after the point; a value is given in 10^-Decimals steps, or in
+// a type's native steps via Native().
+template <size_t N>
+class TextRow : public TextWriter
+{
+    static_assert(N > 1, "a row needs room for at least one character");
+
+public:
+    explicit TextRow(char (&buffer)[N]) : TextWriter(buffer, N) {}
+
+    template <int Width = 0>
+    TextRow& Text(const char* text)
+    {
+        CheckWidth<Width>();
+        AppendText(text, Width);
+        return *this;
+    }
+
+    TextRow& Char(char c)
+    {
+        AppendChar(c);
+        return *this;
+    }
+
+    template <int Width = 0>
+    TextRow& Int(int32_t value)
+    {
+        return Fixed<0, Width>(value);
+    }
+
+    // Non-negative integer, zero-filled to Width (clock fields)
+    template <int Width>
+    TextRow& ZeroPadded(int32_t value)
+    {
+        CheckWidth<Width>();
+        AppendFixed(value, 0, Width, '0');
+        return *this;
+    }
+
+    template <int Decimals, int Width = 0>
+    TextRow& Fixed(int32_t value)
+    {
+        CheckField<Decimals, Width>();
+        AppendFixed(value, Decimals, Width);
+        return *this;
+    }
+
+    // A reading in its type's Sensor::NativeScale() steps
+    template <int Decimals, int Width = 0>
+    TextRow& Native(Sensor::MeasurementType type, int32_t value)
+    {
+        CheckField<Decimals, Width>();
+        AppendFixed(value == kMissing ? kMissing : Sensor::Rescale(type, value, Pow10(Decimals)), Decimals, Width);
+        return *this;
+    }
+
+    // For the float statistics (percentiles): one conversion, then printed
+    // like Fixed()
+    template <int Decimals, int Width = 0>
+    TextRow& Float(float value)
+    {
+        CheckField<Decimals, Width>();
+        AppendFloat(value, Decimals, Width);
+        return *this;
+    }
+
+    // A reading in native steps at its type's logged resolution, followed by
+    // its UTF-8 unit (both from Sensor::kMeasurementInfo); for the log
+    TextRow& Reading(Sensor::MeasurementType type, int32_t value)
+    {
+        AppendReading(type, value);
+        return *this;
+    }
+
+    // Spaces up to the given column (left-aligns what came before)
+    template <size_t Column>
+    TextRow& Pad()
+    {
+        static_assert(Column < N, "column is past the end of the buffer");
+        PadTo(Column);
+        return *this;
+    }
+
+private:
+    template <int Width>
+    static constexpr void CheckWidth()
+    {
+        static_assert(Width >= 0 && (size_t)Width < N, "field is wider than the buffer");
+    }
+
+    template <int Decimals, int Width>
+    static constexpr void CheckField()
+    {
+        CheckWidth<Width>();
+        static_assert(Decimals >= 0 && Decimals <= kMaxDecimals, "unsupported number of decimals");
+    }
+};
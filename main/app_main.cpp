@@ -24,6 +24,7 @@
 
 #include <app/server/CommissioningWindowManager.h>
 #include <app/server/Server.h>
+#include <app/InteractionModelEngine.h>
 
 #ifdef CONFIG_ENABLE_SET_CERT_DECLARATION_API
 #include <esp_matter_providers.h>
@@ -41,14 +42,27 @@ using namespace chip::DeviceLayer;
 #include "MatterExtendedColorLight.h"
 #include "MatterHumiditySensor.h"
 #include "MatterTemperatureSensor.h"
+#include "AcquisitionCycle.h"
+#include "AllocationProbe.h"
+#include "MeasurementSnapshot.h"
+#include "MeasurementStore.h"
+#include "HistoryLog.h"
 #include "SensirionSEN66.h"
 #include "LCD2004.h"
+#include "TextRow.h"
 #include "AppSettings.h"
 #include "NetLog.h"
+#include "SeqLock.h"
+#include "sensirion_i2c_hal.h"
 
 #include <driver/i2c_master.h>
-#include <cmath>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <iterator>
+#include <optional>
 #include <esp_app_desc.h>
 #include <iot_button.h>
 #include <button_gpio.h>
@@ -60,6 +74,8 @@ std::shared_ptr<MatterTemperatureSensor> matterTemperatureSensor;
 std::shared_ptr<MatterHumiditySensor> matterHumiditySensor;
 esp_timer_handle_t sensor_timer_handle;
 static std::shared_ptr<AirQualitySensor> airQualitySensor;
+// Every published report, for the Matter endpoints and the display alike
+static std::shared_ptr<MeasurementStore> measurementStore;
 static LCD2004* lcd = nullptr;
 static AppSettings s_settings;
 
@@ -88,35 +104,55 @@ static const char *s_decryption_key = decryption_key_start;
 static const uint16_t s_decryption_key_len = decryption_key_end - decryption_key_start;
 #endif // CONFIG_ENABLE_ENCRYPTED_OTA
 
+// One frame's view of a report from the store, in native sensor steps;
+// MeasurementStore::kNoValue where the sensor gave no reading
 struct DisplayReadings {
+    static constexpr int32_t kNone = MeasurementStore::kNoValue;
     bool valid = false;
-    float temperature = NAN, humidity = NAN, co2 = NAN, voc = NAN, nox = NAN;
-    float pm1 = NAN, pm25 = NAN, pm4 = NAN, pm10 = NAN;
+    int32_t temperature = kNone, humidity = kNone, co2 = kNone, voc = kNone, nox = kNone;
+    int32_t pm1 = kNone, pm25 = kNone, pm4 = kNone, pm10 = kNone;
 };
 
 enum DisplayPage {
     kPageLive = 0,
     kPageParticles,
     kPageMinMax,
+    kPageWeek,
+    kPageCo2Exposure,
+    kPagePm25Exposure,
     kPageCo2Chart,
     kPageCo2Big,
     kPageSystem,
     kDisplayPageCount,
 };
 
-static DisplayReadings s_readings;
-static DisplayReadings s_prevReadings;
-static DisplayReadings s_minReadings;
-static DisplayReadings s_maxReadings;
+// Set by the acquisition task while the sensor is being reset/reconfigured
+static std::atomic<bool> s_sensorRecovering{false};
+// Backlight state for the acquisition task's adaptive refresh
+static std::atomic<bool> s_displayAwake{true};
+// Report period the acquisition task currently runs at (adaptive refresh)
+static std::atomic<uint32_t> s_effectiveRefreshSec{0};
+// The store keeps minute/hour/day rollups of T, RH and CO2 for the MIN/MAX
+// and 7-day pages; with oversampling they see each interval's sample
+// extremes, not just its mean
+static constexpr uint32_t kMinMaxWindowSec = 24 * 3600;
+static constexpr uint32_t kWeekWindowSec = 7 * 86400;
+static int32_t s_lastTrendLogHour = 0;
+// and exposure percentiles of CO2 and PM2.5, at 3 % and 5 % resolution in
+// hourly slots (about 4 kB each)
+static constexpr uint32_t kExposureShortWindowSec = 8 * 3600;
+static constexpr uint32_t kExposureLongWindowSec = 24 * 3600;
 static int s_displayPage = kPageLive;
 
 static constexpr int32_t kBacklightTimeoutSec = 300; // backlight auto-off after idle
 static constexpr int32_t kSettingsTimeoutSec = 30;   // settings page saves and closes after idle
 
-// Written from the Matter thread when the commissioning window opens
-static volatile int32_t s_pairingCloseAtSec = 0;
-// Written from the Matter thread while the Identify cluster is active
-static volatile int32_t s_identifyEndSec = 0;
+// Written from the Matter thread when the commissioning window opens, read
+// by the display ticker
+static std::atomic<int32_t> s_pairingCloseAtSec{0};
+// Written from the Matter thread while the Identify cluster is active, read
+// by the display ticker
+static std::atomic<int32_t> s_identifyEndSec{0};
 static esp_timer_handle_t s_identifyBlinkTimer = nullptr;
 static bool s_identifyLedOn = false;
 static bool s_identifyPageDrawn = false;
@@ -133,6 +169,8 @@ static bool s_messageDrawn = false;
 // Settings editor state; s_editSettings is the working copy until saved
 enum SettingsField {
     kFieldRefresh = 0,
+    kFieldOversample,
+    kFieldIdleRefresh,
     kFieldAltitude,
     kFieldRotatePeriod,
     kFieldAutoRotate,
@@ -143,10 +181,6 @@ static bool s_settingsOpen = false;
 static int s_settingsField = 0;
 static AppSettings s_editSettings;
 
-// CO2 history for the bar chart page, one sample per sensor cycle
-static float s_co2History[LCD2004::kColumns];
-static int s_co2HistoryCount = 0;
-
 // Custom character sets; only one can live in the HD44780's CGRAM at a time
 enum class LcdCharset { None, Trend, Bars, BigDigits };
 static LcdCharset s_loadedCharset = LcdCharset::None;
@@ -213,24 +247,14 @@ static void EnsureCharset(LcdCharset charset)
     s_loadedCharset = charset;
 }
 
-static void TrackMinMax(float value, float& minValue, float& maxValue)
+// Trend arrow for a reading against the previous report; deadband in tenths
+// of a unit
+static char TrendChar(Sensor::MeasurementType type, int32_t current, int32_t previous, int32_t deadbandTenths)
 {
-    if (std::isnan(value)) {
-        return;
-    }
-    if (std::isnan(minValue) || value < minValue) {
-        minValue = value;
-    }
-    if (std::isnan(maxValue) || value > maxValue) {
-        maxValue = value;
-    }
-}
-
-static char TrendChar(float current, float previous, float deadband)
-{
-    if (std::isnan(current) || std::isnan(previous)) {
+    if (current == MeasurementStore::kNoValue || previous == MeasurementStore::kNoValue) {
         return ' ';
     }
+    int32_t deadband = Sensor::NativeScale(type) * deadbandTenths / 10;
     if (current - previous > deadband) {
         return '\x08';
     }
@@ -251,7 +275,7 @@ static void BigDigitCells(int digit, char* top, char* bottom)
         char* out[2] = {&top[i], &bottom[i]};
         for (int j = 0; j < 2; j++) {
             switch (cells[j]) {
-            case 'F': *out[j] = '\xFF'; break; // ROM full block
+            case 'F': *out[j] = LcdGlyph::kFullBlock; break;
             case 'U': *out[j] = '\x08'; break;
             case 'L': *out[j] = '\x09'; break;
             case 'T': *out[j] = '\x0A'; break;
@@ -261,29 +285,62 @@ static void BigDigitCells(int digit, char* top, char* bottom)
     }
 }
 
-static bool RenderWaitingIfNoData()
+static DisplayReadings ReadingsOf(const MeasurementSnapshot& report)
+{
+    auto native = [&report](Sensor::MeasurementType type) {
+        return report.Has(type) ? report.GetNative(type) : MeasurementStore::kNoValue;
+    };
+    DisplayReadings readings;
+    readings.temperature = native(Sensor::MeasurementType::Temperature);
+    readings.humidity = native(Sensor::MeasurementType::RelativeHumidity);
+    readings.co2 = native(Sensor::MeasurementType::CO2);
+    readings.voc = native(Sensor::MeasurementType::VOC);
+    readings.nox = native(Sensor::MeasurementType::NOx);
+    readings.pm1 = native(Sensor::MeasurementType::PM1p0);
+    readings.pm25 = native(Sensor::MeasurementType::PM2p5);
+    readings.pm4 = native(Sensor::MeasurementType::PM4p0);
+    readings.pm10 = native(Sensor::MeasurementType::PM10p0);
+    readings.valid = !report.IsEmpty();
+    return readings;
+}
+
+static bool RenderWaitingIfNoData(const DisplayReadings& readings)
 {
-    if (s_readings.valid) {
+    if (readings.valid) {
         return false;
     }
     lcd->Clear();
-    lcd->WriteLine(1, "  Waiting for data");
+    lcd->WriteLine(1, s_sensorRecovering ? " Sensor recovering" : "  Waiting for data");
     return true;
 }
 
-static void FormatRefreshValue(char* out, size_t size, uint32_t seconds)
+template <size_t N>
+static void FormatRefreshValue(TextRow<N>& out, uint32_t seconds)
 {
     if (seconds < 60) {
-        snprintf(out, size, "%us", (unsigned)seconds);
+        out.Int(seconds).Char('s');
     } else {
-        snprintf(out, size, "%umin", (unsigned)(seconds / 60));
+        out.Int(seconds / 60).Text("min");
+    }
+}
+
+// Rounded to the nearest unit; hours from two on
+template <size_t N>
+static void FormatSpan(TextRow<N>& out, uint32_t seconds)
+{
+    if (seconds < 60) {
+        out.Int(seconds).Char('s');
+    } else if (seconds < 2 * 3600) {
+        out.Int((seconds + 30) / 60).Text("min");
+    } else {
+        out.Int((seconds + 1800) / 3600).Char('h');
     }
 }
 
 static void RenderSettingsPage()
 {
     static const char* const kLabels[kSettingsFieldCount] = {
-        "Refresh", "Altitude", "Rotate every", "Auto-rotate", "Debug log"
+        "Refresh", "1s averaging", "Idle refresh", "Altitude", "Rotate every", "Auto-rotate", "Debug log"
     };
 
     lcd->WriteLine(0, "Settings");
@@ -292,38 +349,71 @@ static void RenderSettingsPage()
     int firstField = s_settingsField <= 2 ? 0 : s_settingsField - 2;
     for (int row = 0; row < 3; row++) {
         int field = firstField + row;
-        char value[16] = "";
+        char value[7];
+        TextRow valueText(value);
         switch (field) {
         case kFieldRefresh:
-            FormatRefreshValue(value, sizeof(value), s_editSettings.refreshSeconds);
+            FormatRefreshValue(valueText, s_editSettings.refreshSeconds);
+            break;
+        case kFieldOversample:
+            valueText.Text(s_editSettings.oversample ? "ON" : "OFF");
+            break;
+        case kFieldIdleRefresh:
+            if (s_editSettings.idleRefreshSeconds == 0) {
+                valueText.Text("OFF");
+            } else {
+                FormatRefreshValue(valueText, s_editSettings.idleRefreshSeconds);
+            }
             break;
         case kFieldAltitude:
-            snprintf(value, sizeof(value), "%um", s_editSettings.altitudeMeters);
+            valueText.Int(s_editSettings.altitudeMeters).Char('m');
             break;
         case kFieldRotatePeriod:
-            snprintf(value, sizeof(value), "%us", s_editSettings.rotateSeconds);
+            valueText.Int(s_editSettings.rotateSeconds).Char('s');
             break;
         case kFieldAutoRotate:
-            snprintf(value, sizeof(value), "%s", s_editSettings.autoRotate ? "ON" : "OFF");
+            valueText.Text(s_editSettings.autoRotate ? "ON" : "OFF");
             break;
         case kFieldDebugLog:
-            snprintf(value, sizeof(value), "%s", s_editSettings.netlogEnabled ? "ON" : "OFF");
+            valueText.Text(s_editSettings.netlogEnabled ? "ON" : "OFF");
             break;
         }
-        char line[36]; // WriteLine truncates to the 20 columns
-        snprintf(line, sizeof(line), "%c%-13s%6s", field == s_settingsField ? '>' : ' ', kLabels[field], value);
-        lcd->WriteLine(row + 1, line);
+        char line[LCD2004::kColumns + 1];
+        lcd->WriteLine(row + 1, TextRow(line)
+            .Char(field == s_settingsField ? '>' : ' ').Text(kLabels[field]).Pad<14>()
+            .Text<6>(value).CStr());
     }
 }
 
-static void RenderDisplay()
+// Percentile table of one metric: a row per window, p50/p95/p99 across
+template <int Decimals>
+static void DrawExposurePage(const char* name, Sensor::MeasurementType type)
+{
+    char line[LCD2004::kColumns + 1];
+    // The row type is spelled out and the chain split where the decimals come
+    // in, so nothing in here is a dependent name
+    using Row = TextRow<sizeof(line)>;
+    lcd->WriteLine(0, Row(line).Text(name).Pad<5>().Text<5>("p50").Text<5>("p95").Text<5>("p99").CStr());
+    const uint32_t windows[] = {kExposureShortWindowSec, kExposureLongWindowSec};
+    for (int i = 0; i < 2; i++) {
+        QuantileSketch::Percentiles percentiles = measurementStore->GetPercentiles(type, windows[i]);
+        Row row(line);
+        row.Int<3>(windows[i] / 3600).Text("h ");
+        row.Float<Decimals, 5>(percentiles.p50);
+        row.Float<Decimals, 5>(percentiles.p95);
+        row.Float<Decimals, 5>(percentiles.p99);
+        lcd->WriteLine(i + 1, line);
+    }
+    lcd->WriteLine(3, s_sensorRecovering ? "Sensor recovering..." : "exposure percentiles");
+}
+
+static void DrawDisplay()
 {
     if (lcd == nullptr || !lcd->IsBacklightOn()) {
         return;
     }
 
-    // Larger than one row on purpose: WriteLine() truncates to 20 columns
-    char line[48];
+    char line[LCD2004::kColumns + 1];
     int32_t now = NowSec();
 
     if (now < s_messageEndSec) {
@@ -348,8 +438,7 @@ static void RenderDisplay()
             lcd->WriteLine(2, "  LED is blinking");
             s_identifyPageDrawn = true;
         }
-        snprintf(line, sizeof(line), "Ends in %ds", (int)(s_identifyEndSec - now));
-        lcd->WriteLine(3, line);
+        lcd->WriteLine(3, TextRow(line).Text("Ends in ").Int(s_identifyEndSec - now).Char('s').CStr());
         return;
     }
     s_identifyPageDrawn = false;
@@ -361,86 +450,144 @@ static void RenderDisplay()
             lcd->WriteLine(2, "Code: 3497-011-2332");
             s_pairingPageDrawn = true;
         }
-        snprintf(line, sizeof(line), "Closes in %ds", (int)(s_pairingCloseAtSec - now));
-        lcd->WriteLine(3, line);
+        lcd->WriteLine(3, TextRow(line).Text("Closes in ").Int(s_pairingCloseAtSec - now).Char('s').CStr());
         return;
     }
     s_pairingPageDrawn = false;
 
+    // One consistent copy of the last two reports for this frame
+    const DisplayReadings readings = ReadingsOf(measurementStore->GetLatest());
+    const DisplayReadings previous = ReadingsOf(measurementStore->GetPrevious());
+
     switch (s_displayPage) {
-    case kPageLive: // \xDF is the degree symbol in the HD44780 charset
-        if (RenderWaitingIfNoData()) {
+    case kPageLive: {
+        if (RenderWaitingIfNoData(readings)) {
             break;
         }
         EnsureCharset(LcdCharset::Trend);
-        snprintf(line, sizeof(line), "%.1f\xDF" "C%c %.1f%%RH%c",
-                 s_readings.temperature, TrendChar(s_readings.temperature, s_prevReadings.temperature, 0.2f),
-                 s_readings.humidity, TrendChar(s_readings.humidity, s_prevReadings.humidity, 1.0f));
-        lcd->WriteLine(0, line);
-        snprintf(line, sizeof(line), "CO2 %.0fppm%c VOC %.0f",
-                 s_readings.co2, TrendChar(s_readings.co2, s_prevReadings.co2, 25.0f), s_readings.voc);
-        lcd->WriteLine(1, line);
-        snprintf(line, sizeof(line), "PM2.5 %.1f%c PM10 %.1f",
-                 s_readings.pm25, TrendChar(s_readings.pm25, s_prevReadings.pm25, 0.3f), s_readings.pm10);
-        lcd->WriteLine(2, line);
-        snprintf(line, sizeof(line), "Air: %s", AirQualityText());
-        lcd->WriteLine(3, line);
+        using Type = Sensor::MeasurementType;
+        lcd->WriteLine(0, TextRow(line)
+            .Native<1>(Type::Temperature, readings.temperature).Text(LcdUnit::kCelsius)
+            .Char(TrendChar(Type::Temperature, readings.temperature, previous.temperature, 2))
+            .Char(' ').Native<1>(Type::RelativeHumidity, readings.humidity).Text(LcdUnit::kPercentRH)
+            .Char(TrendChar(Type::RelativeHumidity, readings.humidity, previous.humidity, 10)).CStr());
+        lcd->WriteLine(1, TextRow(line)
+            .Text("CO2 ").Native<0>(Type::CO2, readings.co2).Text(LcdUnit::kPpm)
+            .Char(TrendChar(Type::CO2, readings.co2, previous.co2, 250))
+            .Text(" VOC ").Native<0>(Type::VOC, readings.voc).CStr());
+        lcd->WriteLine(2, TextRow(line)
+            .Text("PM2.5 ").Native<1>(Type::PM2p5, readings.pm25)
+            .Char(TrendChar(Type::PM2p5, readings.pm25, previous.pm25, 3))
+            .Text(" PM10 ").Native<1>(Type::PM10p0, readings.pm10).CStr());
+        if (s_sensorRecovering) {
+            lcd->WriteLine(3, "Sensor recovering...");
+        } else {
+            lcd->WriteLine(3, TextRow(line).Text("Air: ").Text(AirQualityText()).CStr());
+        }
         break;
+    }
 
     case kPageParticles:
-        if (RenderWaitingIfNoData()) {
+        if (RenderWaitingIfNoData(readings)) {
             break;
         }
-        lcd->WriteLine(0, "Particles \xE4g/m3"); // \xE4 = micro sign
-        snprintf(line, sizeof(line), "PM1  %.1f  PM2.5 %.1f", s_readings.pm1, s_readings.pm25);
-        lcd->WriteLine(1, line);
-        snprintf(line, sizeof(line), "PM4  %.1f  PM10  %.1f", s_readings.pm4, s_readings.pm10);
-        lcd->WriteLine(2, line);
-        snprintf(line, sizeof(line), "NOx index %.0f", s_readings.nox);
-        lcd->WriteLine(3, line);
+        lcd->WriteLine(0, TextRow(line).Text("Particles ").Text(LcdUnit::kMicrogramsPerM3).CStr());
+        lcd->WriteLine(1, TextRow(line)
+            .Text("PM1  ").Native<1>(Sensor::MeasurementType::PM1p0, readings.pm1)
+            .Text("  PM2.5 ").Native<1>(Sensor::MeasurementType::PM2p5, readings.pm25).CStr());
+        lcd->WriteLine(2, TextRow(line)
+            .Text("PM4  ").Native<1>(Sensor::MeasurementType::PM4p0, readings.pm4)
+            .Text("  PM10  ").Native<1>(Sensor::MeasurementType::PM10p0, readings.pm10).CStr());
+        lcd->WriteLine(3, TextRow(line).Text("NOx index ").Native<0>(Sensor::MeasurementType::NOx, readings.nox).CStr());
         break;
 
-    case kPageMinMax:
-        if (RenderWaitingIfNoData()) {
+    case kPageMinMax: {
+        if (RenderWaitingIfNoData(readings)) {
             break;
         }
-        lcd->WriteLine(0, "        MIN     MAX");
-        snprintf(line, sizeof(line), "T\xDF" "C %8.1f %7.1f", s_minReadings.temperature, s_maxReadings.temperature);
-        lcd->WriteLine(1, line);
-        snprintf(line, sizeof(line), "RH%% %8.1f %7.1f", s_minReadings.humidity, s_maxReadings.humidity);
-        lcd->WriteLine(2, line);
-        snprintf(line, sizeof(line), "CO2 %8.0f %7.0f", s_minReadings.co2, s_maxReadings.co2);
-        lcd->WriteLine(3, line);
+        RollupSeries::Summary temperature = measurementStore->GetRollup(Sensor::MeasurementType::Temperature, kMinMaxWindowSec);
+        RollupSeries::Summary humidity = measurementStore->GetRollup(Sensor::MeasurementType::RelativeHumidity, kMinMaxWindowSec);
+        RollupSeries::Summary co2 = measurementStore->GetRollup(Sensor::MeasurementType::CO2, kMinMaxWindowSec);
+        lcd->WriteLine(0, "24h     MIN     MAX");
+        lcd->WriteLine(1, TextRow(line).Char('T').Text(LcdUnit::kCelsius).Char(' ')
+            .Native<1, 8>(Sensor::MeasurementType::Temperature, temperature.min).Char(' ')
+            .Native<1, 7>(Sensor::MeasurementType::Temperature, temperature.max).CStr());
+        lcd->WriteLine(2, TextRow(line).Text("RH% ")
+            .Native<1, 8>(Sensor::MeasurementType::RelativeHumidity, humidity.min).Char(' ')
+            .Native<1, 7>(Sensor::MeasurementType::RelativeHumidity, humidity.max).CStr());
+        lcd->WriteLine(3, TextRow(line).Text("CO2 ")
+            .Native<0, 8>(Sensor::MeasurementType::CO2, co2.min).Char(' ')
+            .Native<0, 7>(Sensor::MeasurementType::CO2, co2.max).CStr());
+        break;
+    }
+
+    case kPageWeek: {
+        if (RenderWaitingIfNoData(readings)) {
+            break;
+        }
+        RollupSeries::Summary temperature = measurementStore->GetRollup(Sensor::MeasurementType::Temperature, kWeekWindowSec);
+        RollupSeries::Summary humidity = measurementStore->GetRollup(Sensor::MeasurementType::RelativeHumidity, kWeekWindowSec);
+        RollupSeries::Summary co2 = measurementStore->GetRollup(Sensor::MeasurementType::CO2, kWeekWindowSec);
+        lcd->WriteLine(0, "7d   AVG   MIN   MAX");
+        lcd->WriteLine(1, TextRow(line).Char('T').Text(LcdUnit::kCelsius)
+            .Native<1, 5>(Sensor::MeasurementType::Temperature, temperature.mean).Char(' ')
+            .Native<1, 5>(Sensor::MeasurementType::Temperature, temperature.min).Char(' ')
+            .Native<1, 5>(Sensor::MeasurementType::Temperature, temperature.max).CStr());
+        lcd->WriteLine(2, TextRow(line).Text("RH%")
+            .Native<1, 5>(Sensor::MeasurementType::RelativeHumidity, humidity.mean).Char(' ')
+            .Native<1, 5>(Sensor::MeasurementType::RelativeHumidity, humidity.min).Char(' ')
+            .Native<1, 5>(Sensor::MeasurementType::RelativeHumidity, humidity.max).CStr());
+        lcd->WriteLine(3, TextRow(line).Text("CO2")
+            .Native<0, 5>(Sensor::MeasurementType::CO2, co2.mean).Char(' ')
+            .Native<0, 5>(Sensor::MeasurementType::CO2, co2.min).Char(' ')
+            .Native<0, 5>(Sensor::MeasurementType::CO2, co2.max).CStr());
+        break;
+    }
+
+    case kPageCo2Exposure:
+        if (!RenderWaitingIfNoData(readings)) {
+            DrawExposurePage<0>("CO2", Sensor::MeasurementType::CO2);
+        }
+        break;
+
+    case kPagePm25Exposure:
+        if (!RenderWaitingIfNoData(readings)) {
+            DrawExposurePage<1>("PM2.5", Sensor::MeasurementType::PM2p5);
+        }
         break;
 
     case kPageCo2Chart: {
-        if (RenderWaitingIfNoData() || s_co2HistoryCount == 0) {
+        int32_t history[LCD2004::kColumns]; // whole ppm
+        uint32_t historySeconds;
+        int historyCount = (int)measurementStore->GetHistory(Sensor::MeasurementType::CO2, history, LCD2004::kColumns,
+                                                             historySeconds);
+        if (RenderWaitingIfNoData(readings) || historyCount == 0) {
             break;
         }
         EnsureCharset(LcdCharset::Bars);
 
-        float lo = s_co2History[0];
-        float hi = s_co2History[0];
-        for (int i = 1; i < s_co2HistoryCount; i++) {
-            if (s_co2History[i] < lo) lo = s_co2History[i];
-            if (s_co2History[i] > hi) hi = s_co2History[i];
+        int32_t lo = history[0];
+        int32_t hi = history[0];
+        for (int i = 1; i < historyCount; i++) {
+            if (history[i] < lo) lo = history[i];
+            if (history[i] > hi) hi = history[i];
         }
-        if (hi - lo < 100.0f) { // keep a sane scale on flat data
-            float mid = (hi + lo) / 2.0f;
-            lo = mid - 50.0f;
-            hi = mid + 50.0f;
+        if (hi - lo < 100) { // keep a sane scale on flat data
+            int32_t mid = (hi + lo) / 2;
+            lo = mid - 50;
+            hi = mid + 50;
         }
 
         char top[LCD2004::kColumns + 1];
         char bottom[LCD2004::kColumns + 1];
         for (int col = 0; col < LCD2004::kColumns; col++) {
-            int idx = col - (LCD2004::kColumns - s_co2HistoryCount); // right-aligned
+            int idx = col - (LCD2004::kColumns - historyCount); // right-aligned
             if (idx < 0) {
                 top[col] = ' ';
                 bottom[col] = ' ';
                 continue;
             }
-            int level = (int)lroundf((s_co2History[idx] - lo) / (hi - lo) * 16.0f);
+            int level = (int)(((history[idx] - lo) * 16 + (hi - lo) / 2) / (hi - lo)); // rounded
             if (level < 1) level = 1;
             if (level > 16) level = 16;
             int lowerFill = level > 8 ? 8 : level;
@@ -451,26 +598,28 @@ static void RenderDisplay()
         top[LCD2004::kColumns] = '\0';
         bottom[LCD2004::kColumns] = '\0';
 
-        snprintf(line, sizeof(line), "CO2 %d-%dppm", (int)lo, (int)hi);
-        lcd->WriteLine(0, line);
+        lcd->WriteLine(0, TextRow(line).Text("CO2 ").Int(lo).Char('-').Int(hi).Text(LcdUnit::kPpm).CStr());
         lcd->WriteLine(1, top);
         lcd->WriteLine(2, bottom);
-        snprintf(line, sizeof(line), "last %umin  now %.0f",
-                 (unsigned)((LCD2004::kColumns * s_settings.refreshSeconds + 30) / 60), s_readings.co2);
-        lcd->WriteLine(3, line);
+        // The span the chart's reports actually cover, stretched refresh and
+        // out-of-cycle reports included
+        TextRow label(line);
+        label.Text("last ");
+        FormatSpan(label, historySeconds);
+        lcd->WriteLine(3, label.Text("  now ").Native<0>(Sensor::MeasurementType::CO2, readings.co2).CStr());
         break;
     }
 
     case kPageCo2Big: {
-        if (RenderWaitingIfNoData()) {
+        if (RenderWaitingIfNoData(readings)) {
             break;
         }
         EnsureCharset(LcdCharset::BigDigits);
 
-        int co2 = (int)lroundf(s_readings.co2);
+        int32_t co2 = readings.co2; // whole ppm; kNoValue shows as 0
         if (co2 < 0) co2 = 0;
         char digits[12];
-        snprintf(digits, sizeof(digits), "%d", co2);
+        TextRow(digits).Int(co2);
 
         char top[LCD2004::kColumns + 1];
         char bottom[LCD2004::kColumns + 1];
@@ -488,8 +637,7 @@ static void RenderDisplay()
         lcd->WriteLine(0, "CO2");
         lcd->WriteLine(1, top);
         lcd->WriteLine(2, bottom);
-        snprintf(line, sizeof(line), "ppm   Air: %s", AirQualityText());
-        lcd->WriteLine(3, line);
+        lcd->WriteLine(3, TextRow(line).Text(LcdUnit::kPpm).Text("   Air: ").Text(AirQualityText()).CStr());
         break;
     }
 
@@ -500,13 +648,19 @@ static void RenderDisplay()
         int minutes = (uptimeSeconds % 3600) / 60;
 
         lcd->WriteLine(0, s_autoRotate ? "System status" : "System status     *");
-        snprintf(line, sizeof(line), "Up %dd %02d:%02d", days, hours, minutes);
+        // Uptime and the report period the adaptive refresh currently runs at
+        uint32_t refresh = s_effectiveRefreshSec;
+        TextRow uptime(line);
+        uptime.Text("Up ").Int(days).Text("d ").ZeroPadded<2>(hours).Char(':').ZeroPadded<2>(minutes).Text(" rpt ");
+        if (refresh < 60) {
+            uptime.Int(refresh).Char('s');
+        } else {
+            uptime.Int(refresh / 60).Char('m');
+        }
         lcd->WriteLine(1, line);
-        snprintf(line, sizeof(line), "Heap %uk min %uk",
-                 (unsigned)(esp_get_free_heap_size() / 1024), (unsigned)(esp_get_minimum_free_heap_size() / 1024));
-        lcd->WriteLine(2, line);
-        snprintf(line, sizeof(line), "FW %s", esp_app_get_description()->version);
-        lcd->WriteLine(3, line);
+        lcd->WriteLine(2, TextRow(line).Text("Heap ").Int(esp_get_free_heap_size() / 1024)
+            .Text("k min ").Int(esp_get_minimum_free_heap_size() / 1024).Char('k').CStr());
+        lcd->WriteLine(3, TextRow(line).Text("FW ").Text(esp_app_get_description()->version).CStr());
         break;
     }
 
@@ -515,9 +669,52 @@ static void RenderDisplay()
     }
 }
 
+/*
+ * UI latency probe. Buttons are handled on the esp_timer task, so a press
+ * first waits for whatever callback that task is busy with, then for the
+ * redraw. The display tick's lateness measures the wait and RenderDisplay()
+ * times the redraw; their worst-case sum bounds the button-to-screen latency.
+ */
+static constexpr int64_t kDisplayTickPeriodUs = 1000000;
+static constexpr int32_t kUiLatencyLogIntervalSec = 300;
+static int64_t s_worstTickDelayUs = 0;
+static int64_t s_worstRenderUs = 0;
+
+static void RenderDisplay()
+{
+    int64_t start = esp_timer_get_time();
+    DrawDisplay();
+    int64_t elapsed = esp_timer_get_time() - start;
+    if (elapsed > s_worstRenderUs) {
+        s_worstRenderUs = elapsed;
+    }
+}
+
+static void TrackUiLatency()
+{
+    static int64_t s_lastTickUs = 0;
+    static int32_t s_lastLogSec = 0;
+
+    int64_t nowUs = esp_timer_get_time();
+    if (s_lastTickUs != 0 && nowUs - s_lastTickUs - kDisplayTickPeriodUs > s_worstTickDelayUs) {
+        s_worstTickDelayUs = nowUs - s_lastTickUs - kDisplayTickPeriodUs;
+    }
+    s_lastTickUs = nowUs;
+
+    int32_t now = NowSec();
+    if (now - s_lastLogSec >= kUiLatencyLogIntervalSec) {
+        ESP_LOGI(TAG, "UI latency (worst): %u ms timer delay + %u ms redraw = %u ms button-to-screen",
+                 (unsigned)(s_worstTickDelayUs / 1000), (unsigned)(s_worstRenderUs / 1000),
+                 (unsigned)((s_worstTickDelayUs + s_worstRenderUs) / 1000));
+        s_worstTickDelayUs = 0;
+        s_worstRenderUs = 0;
+        s_lastLogSec = now;
+    }
+}
+
 static void ShowMessage(const char* text, int32_t seconds)
 {
-    snprintf(s_message, sizeof(s_message), "%s", text);
+    TextRow(s_message).Text(text);
     s_messageEndSec = NowSec() + seconds;
     s_messageDrawn = false;
     RenderDisplay();
@@ -626,6 +823,34 @@ static void OpenSettings()
     RenderDisplay();
 }
 
+// Requests to the acquisition task, sent as notification bits (see
+// AcquisitionTask() below)
+static constexpr uint32_t kAcqEventSample = 1 << 0;      // sensor timer tick
+static constexpr uint32_t kAcqEventForceReport = 1 << 1; // manual refresh button
+static constexpr uint32_t kAcqEventRestart = 1 << 2;     // refresh/averaging settings changed
+static constexpr uint32_t kAcqEventAltitude = 1 << 3;    // altitude setting changed
+static constexpr uint32_t kAcqEventFanCleaning = 1 << 4; // fan cleaning button
+
+// The settings the acquisition task works from. s_settings belongs to the
+// esp_timer task (settings menu); each change is published here before the
+// event that asks the acquisition task to apply it.
+struct AcquisitionSettings {
+    uint32_t refreshSeconds;
+    uint32_t idleRefreshSeconds;
+    uint16_t altitudeMeters;
+    bool oversample;
+};
+static SeqLock<AcquisitionSettings> s_acqSettings;
+
+static void PublishAcquisitionSettings()
+{
+    s_acqSettings.Publish({s_settings.refreshSeconds, s_settings.idleRefreshSeconds,
+                           s_settings.altitudeMeters, s_settings.oversample});
+}
+
+static void RestartUpdateSensorsTimer();
+static void NotifyAcquisitionTask(uint32_t events);
+
 static void ApplyAndCloseSettings()
 {
     s_settingsOpen = false;
@@ -635,37 +860,39 @@ static void ApplyAndCloseSettings()
                    s_editSettings.altitudeMeters != s_settings.altitudeMeters ||
                    s_editSettings.rotateSeconds != s_settings.rotateSeconds ||
                    s_editSettings.autoRotate != s_settings.autoRotate ||
-                   s_editSettings.netlogEnabled != s_settings.netlogEnabled;
+                   s_editSettings.netlogEnabled != s_settings.netlogEnabled ||
+                   s_editSettings.oversample != s_settings.oversample ||
+                   s_editSettings.idleRefreshSeconds != s_settings.idleRefreshSeconds;
 
     if (s_editSettings.netlogEnabled != s_settings.netlogEnabled) {
         NetLog::SetEnabled(s_editSettings.netlogEnabled);
     }
 
-    if (s_editSettings.refreshSeconds != s_settings.refreshSeconds && sensor_timer_handle) {
-        esp_timer_stop(sensor_timer_handle);
-        esp_timer_start_periodic(sensor_timer_handle, (uint64_t)s_editSettings.refreshSeconds * 1000000ULL);
-        ESP_LOGI(TAG, "Sensor refresh period set to %u s", (unsigned)s_editSettings.refreshSeconds);
-    }
-
-    if (s_editSettings.altitudeMeters != s_settings.altitudeMeters && airQualitySensor) {
-        int status = airQualitySensor->UpdateAltitude(s_editSettings.altitudeMeters);
-        if (status == 0) {
-            ESP_LOGI(TAG, "Sensor altitude set to %u m", s_editSettings.altitudeMeters);
-        } else {
-            ESP_LOGE(TAG, "Failed to set sensor altitude: %d", status);
-        }
-    }
+    bool samplingChanged = s_editSettings.refreshSeconds != s_settings.refreshSeconds ||
+                           s_editSettings.oversample != s_settings.oversample ||
+                           s_editSettings.idleRefreshSeconds != s_settings.idleRefreshSeconds;
+    bool altitudeChanged = s_editSettings.altitudeMeters != s_settings.altitudeMeters;
 
     s_autoRotate = s_editSettings.autoRotate;
     s_lastRotateSec = NowSec();
 
-    if (changed) {
-        s_settings = s_editSettings;
-        s_settings.Save();
-        ShowMessage("   Settings saved", 2);
-    } else {
+    if (!changed) {
         RenderDisplay();
+        return;
     }
+
+    s_settings = s_editSettings;
+    s_settings.Save();
+    PublishAcquisitionSettings();
+
+    if (samplingChanged) {
+        RestartUpdateSensorsTimer();
+    }
+    if (altitudeChanged) {
+        NotifyAcquisitionTask(kAcqEventAltitude);
+    }
+
+    ShowMessage("   Settings saved", 2);
 }
 
 static void StepSettingsField(int direction)
@@ -684,6 +911,19 @@ static void StepSettingsField(int direction)
         s_editSettings.refreshSeconds = AppSettings::kRefreshChoices[index];
         break;
     }
+    case kFieldIdleRefresh: {
+        constexpr int count = sizeof(AppSettings::kIdleRefreshChoices) / sizeof(AppSettings::kIdleRefreshChoices[0]);
+        int index = 0;
+        for (int i = 0; i < count; i++) {
+            if (AppSettings::kIdleRefreshChoices[i] == s_editSettings.idleRefreshSeconds) {
+                index = i;
+                break;
+            }
+        }
+        index = (index + direction + count) % count;
+        s_editSettings.idleRefreshSeconds = AppSettings::kIdleRefreshChoices[index];
+        break;
+    }
     case kFieldAltitude: {
         int32_t altitude = (int32_t)s_editSettings.altitudeMeters + direction * AppSettings::kAltitudeStepMeters;
         if (altitude < 0) {
@@ -704,6 +944,9 @@ static void StepSettingsField(int direction)
         s_editSettings.rotateSeconds = (uint8_t)rotate;
         break;
     }
+    case kFieldOversample:
+        s_editSettings.oversample = !s_editSettings.oversample;
+        break;
     case kFieldAutoRotate:
         s_editSettings.autoRotate = !s_editSettings.autoRotate;
         break;
@@ -716,46 +959,128 @@ static void StepSettingsField(int direction)
     RenderDisplay();
 }
 
-static void UpdateDisplay()
+// The hourly rollups of these types are appended to the "history" flash
+// partition as each hour closes and replayed at boot. That is one 48-byte
+// write an hour: a sector's 255 records last 85 h, the 26-sector ring keeps
+// at least the last 2125 h (88 days) and erases each sector every 2210 h
+// (92 days), about 4 times a year (HistoryLogTest measures this). There is
+// no wall clock, so the rollup clock resumes where the log ends: time the
+// device spent off is not shown as a gap.
+static const Sensor::MeasurementType kPersistedTypes[] = {
+    Sensor::MeasurementType::Temperature,
+    Sensor::MeasurementType::RelativeHumidity,
+    Sensor::MeasurementType::CO2,
+};
+static HistoryLog s_historyLog;
+static uint32_t s_persistedUntilSec = 0; // rollup clock; hours before it are in flash
+
+static void RestoreHistory()
 {
-    std::vector<Sensor::Measurement> measurements = airQualitySensor->ReadAllMeasurements();
-    if (measurements.empty()) {
+    if (!s_historyLog.Init("history")) {
         return;
     }
-
-    DisplayReadings readings;
-    for (const auto& measurement : measurements) {
-        switch (measurement.type) {
-        case Sensor::MeasurementType::Temperature:      readings.temperature = measurement.value; break;
-        case Sensor::MeasurementType::RelativeHumidity: readings.humidity = measurement.value; break;
-        case Sensor::MeasurementType::CO2:              readings.co2 = measurement.value; break;
-        case Sensor::MeasurementType::VOC:              readings.voc = measurement.value; break;
-        case Sensor::MeasurementType::NOx:              readings.nox = measurement.value; break;
-        case Sensor::MeasurementType::PM1p0:            readings.pm1 = measurement.value; break;
-        case Sensor::MeasurementType::PM2p5:            readings.pm25 = measurement.value; break;
-        case Sensor::MeasurementType::PM4p0:            readings.pm4 = measurement.value; break;
-        case Sensor::MeasurementType::PM10p0:           readings.pm10 = measurement.value; break;
-        default: break;
+    uint32_t nextHour = 0;
+    size_t restored = 0;
+    s_historyLog.ForEach([&](const HistoryLog::Record& record) {
+        if (record.type >= Sensor::kMeasurementTypeCount) {
+            return;
         }
-    }
-    readings.valid = true;
-    s_prevReadings = s_readings;
-    s_readings = readings;
+        auto type = static_cast<Sensor::MeasurementType>(record.type);
+        int32_t mean = HistoryLog::DecodeValue(type, record.mean);
+        int32_t min = HistoryLog::DecodeValue(type, record.min);
+        int32_t max = HistoryLog::DecodeValue(type, record.max);
+        if (mean == Sensor::kNoValue || min == Sensor::kNoValue || max == Sensor::kNoValue) {
+            return;
+        }
+        RollupSeries::Summary summary = {mean, min, max, record.count};
+        measurementStore->RestoreHour(type, record.hour * 3600, summary);
+        nextHour = std::max(nextHour, record.hour + 1);
+        restored++;
+    });
+    s_persistedUntilSec = nextHour * 3600;
+    measurementStore->SetRollupOffsetSeconds(s_persistedUntilSec);
+    ESP_LOGI(TAG, "Restored %u hourly record(s) of %u", (unsigned)restored, (unsigned)s_historyLog.GetCapacity());
+}
 
-    if (!std::isnan(readings.co2)) {
-        if (s_co2HistoryCount == LCD2004::kColumns) {
-            memmove(&s_co2History[0], &s_co2History[1], sizeof(float) * (LCD2004::kColumns - 1));
-            s_co2HistoryCount--;
+// Appends the hour that just closed, one flash write for all types
+static void PersistHistory()
+{
+    if (!s_historyLog.IsReady()) {
+        return;
+    }
+    HistoryLog::Record records[std::size(kPersistedTypes)];
+    size_t count = 0;
+    uint32_t newestStart = 0;
+    for (Sensor::MeasurementType type : kPersistedTypes) {
+        uint32_t startSeconds;
+        RollupSeries::Summary hour;
+        if (!measurementStore->GetNewestClosedHour(type, startSeconds, hour) || startSeconds < s_persistedUntilSec) {
+            continue;
         }
-        s_co2History[s_co2HistoryCount++] = readings.co2;
+        records[count++] = {startSeconds / 3600,
+                            (uint8_t)type,
+                            0,
+                            (uint16_t)std::min<uint32_t>(hour.count, UINT16_MAX),
+                            HistoryLog::EncodeValue(type, hour.mean),
+                            HistoryLog::EncodeValue(type, hour.min),
+                            HistoryLog::EncodeValue(type, hour.max),
+                            0};
+        newestStart = std::max(newestStart, startSeconds);
+    }
+    if (count == 0) {
+        return;
     }
+    s_persistedUntilSec = newestStart + 3600;
+    s_historyLog.Append(records, count);
+}
 
-    TrackMinMax(readings.temperature, s_minReadings.temperature, s_maxReadings.temperature);
-    TrackMinMax(readings.humidity, s_minReadings.humidity, s_maxReadings.humidity);
-    TrackMinMax(readings.co2, s_minReadings.co2, s_maxReadings.co2);
-    TrackMinMax(readings.pm25, s_minReadings.pm25, s_maxReadings.pm25);
+// Hourly trend and exposure lines in the log (and so over NetLog), read
+// from the store's rollups and percentiles
+static void LogTrends(int64_t timestampUs)
+{
+    int32_t hour = (int32_t)(timestampUs / 3600000000LL);
+    if (hour == s_lastTrendLogHour) {
+        return;
+    }
+    s_lastTrendLogHour = hour;
+
+    RollupSeries::Summary day = measurementStore->GetRollup(Sensor::MeasurementType::CO2, kMinMaxWindowSec);
+    RollupSeries::Summary week = measurementStore->GetRollup(Sensor::MeasurementType::CO2, kWeekWindowSec);
+    char line[96];
+    ESP_LOGI(TAG, "%s", TextRow(line)
+        .Text("CO2 24h avg ").Native<0>(Sensor::MeasurementType::CO2, day.mean)
+        .Text(" (").Native<0>(Sensor::MeasurementType::CO2, day.min)
+        .Char('-').Native<0>(Sensor::MeasurementType::CO2, day.max)
+        .Text("), 7d avg ").Native<0>(Sensor::MeasurementType::CO2, week.mean)
+        .Text(" (").Native<0>(Sensor::MeasurementType::CO2, week.min)
+        .Char('-').Native<0>(Sensor::MeasurementType::CO2, week.max)
+        .Char(')').CStr());
+    const uint32_t windows[] = {kExposureShortWindowSec, kExposureLongWindowSec};
+    for (uint32_t window : windows) {
+        QuantileSketch::Percentiles co2 = measurementStore->GetPercentiles(Sensor::MeasurementType::CO2, window);
+        QuantileSketch::Percentiles pm25 = measurementStore->GetPercentiles(Sensor::MeasurementType::PM2p5, window);
+        ESP_LOGI(TAG, "%s", TextRow(line)
+            .Text("Exposure ").Int(window / 3600).Text("h p50/p95/p99: CO2 ")
+            .Float<0>(co2.p50).Char('/').Float<0>(co2.p95).Char('/').Float<0>(co2.p99)
+            .Text(", PM2.5 ").Float<1>(pm25.p50).Char('/').Float<1>(pm25.p95).Char('/').Float<1>(pm25.p99)
+            .CStr());
+    }
+    if (s_historyLog.IsReady()) {
+        ESP_LOGI(TAG, "History log: %u bytes written, %u sector erase(s) since boot",
+                 (unsigned)s_historyLog.GetBytesWritten(), (unsigned)s_historyLog.GetSectorErases());
+    }
+}
 
-    RenderDisplay();
+// Sets up what the store keeps beyond the windows the Matter endpoints ask for
+static void SetUpMeasurementStore()
+{
+    measurementStore = std::make_shared<MeasurementStore>();
+    measurementStore->TrackRollups(Sensor::MeasurementType::Temperature);
+    measurementStore->TrackRollups(Sensor::MeasurementType::RelativeHumidity);
+    measurementStore->TrackRollups(Sensor::MeasurementType::CO2);
+    measurementStore->TrackPercentiles(Sensor::MeasurementType::CO2, 100.0f, 10000.0f, 0.03f, kExposureLongWindowSec);
+    measurementStore->TrackPercentiles(Sensor::MeasurementType::PM2p5, 1.0f, 1000.0f, 0.05f, kExposureLongWindowSec);
+    measurementStore->TrackHistory(Sensor::MeasurementType::CO2, LCD2004::kColumns); // CO2 chart
 }
 
 // The VOC gas-index algorithm state is persisted to NVS at this cadence so the
@@ -765,15 +1090,200 @@ static void UpdateDisplay()
 static constexpr int32_t kVocStateSaveIntervalSec = 1800; // 30 min
 static int32_t s_lastVocSaveSec = 0;
 
-// Timer callback to measure air quality
-void UpdateSensorsTimerCallback(void *arg)
+// Matter subscriptions, counted on the Matter thread
+static std::atomic<uint32_t> s_subscriptionCount{0};
+
+// Acquisition cost over the current report interval (see AcquireSnapshot)
+static uint32_t s_acquisitionCount = 0;
+static int64_t s_acquisitionUs = 0;
+static uint64_t s_acquisitionYieldedUs = 0;
+static uint64_t s_acquisitionSpunUs = 0;
+// Heap allocations on the acquisition path (CONFIG_ACQUISITION_ALLOCATION_CHECK)
+static uint32_t s_acquisitionAllocations = 0;
+// AcquisitionCycle::GetRejectedCount() and MeasurementStore::GetTornReads()
+// as of the last cost log
+static uint32_t s_loggedRejectedCount = 0;
+static uint32_t s_loggedTornReads = 0;
+// Least free stack the acquisition task has had, as last logged (bytes)
+static UBaseType_t s_loggedStackHeadroom = UINT32_MAX;
+// Below this the stack is too tight for a HAL retry path not yet taken
+static constexpr UBaseType_t kStackHeadroomWarning = 512;
+
+/*
+ * Acquisition task. A sensor read takes hundreds of milliseconds (seconds
+ * while the HAL retries), so it runs in its own task rather than on the
+ * esp_timer task that also serves the buttons, the identify blink and the
+ * display ticker. The sensor timer only notifies the task; buttons and the
+ * settings menu request sensor commands the same way, so nothing else ever
+ * touches the SEN66 driver. Finished reports go back to the esp_timer task
+ * through s_displayUpdateTimer, which keeps all LCD access on that one task.
+ */
+static TaskHandle_t s_acquisitionTask = nullptr;
+
+// The cycle the task runs; created with the task, once the store exists
+static std::optional<AcquisitionCycle> s_cycle;
+// The sensor timer's period as last set by the acquisition task
+static uint32_t s_acqSamplePeriodSec = 0;
+
+// Redraws the display on the esp_timer task after a report was published
+static esp_timer_handle_t s_displayUpdateTimer = nullptr;
+
+static void PollSubscriptions()
 {
-    matterAirQualitySensor->UpdateMeasurements();
-    matterTemperatureSensor->UpdateMeasurements();
-    matterHumiditySensor->UpdateMeasurements();
+    chip::DeviceLayer::SystemLayer().ScheduleLambda([]() {
+        s_subscriptionCount = chip::app::InteractionModelEngine::GetInstance()->GetNumActiveReadHandlers(
+            chip::app::ReadHandler::InteractionType::Subscribe);
+    });
+}
 
-    if (lcd) {
-        UpdateDisplay();
+static bool ConsumersIdle()
+{
+    return (lcd == nullptr || !s_displayAwake) && s_subscriptionCount == 0;
+}
+
+// Publishes the scheduler's report period and runs the sensor timer at the
+// sampling period it calls for. Only the acquisition task touches the timer
+// once it is running.
+static void ApplyAdaptivePeriod()
+{
+    uint32_t reportPeriod = s_cycle->GetReportPeriodSec();
+    uint32_t samplePeriod = s_cycle->GetSamplePeriodSec();
+    if (s_effectiveRefreshSec.exchange(reportPeriod) != reportPeriod) {
+        ESP_LOGI(TAG, "Refresh period now %u s (sampling every %u s)", (unsigned)reportPeriod, (unsigned)samplePeriod);
+    }
+    if (samplePeriod == s_acqSamplePeriodSec || sensor_timer_handle == nullptr) {
+        return;
+    }
+    s_acqSamplePeriodSec = samplePeriod;
+    esp_timer_stop(sensor_timer_handle);
+    esp_timer_start_periodic(sensor_timer_handle, (uint64_t)samplePeriod * 1000000ULL);
+}
+
+// Acquisition stage: reads the sensor once into an immutable, timestamped
+// snapshot. Returns false when the read produced no data. Also accounts how
+// long the read took and how much of that the HAL spent blocked (CPU handed
+// to the Thread/Matter stack) rather than busy-waiting; logged per report.
+static bool AcquireSnapshot(MeasurementSnapshot& snapshot)
+{
+    uint64_t yieldedBefore, spunBefore;
+    sensirion_i2c_hal_get_sleep_stats(&yieldedBefore, &spunBefore);
+    int64_t start = esp_timer_get_time();
+
+    Sensor::MeasurementRecord record;
+    bool read = airQualitySensor->ReadMeasurements(record);
+
+    int64_t end = esp_timer_get_time();
+    uint64_t yieldedAfter, spunAfter;
+    sensirion_i2c_hal_get_sleep_stats(&yieldedAfter, &spunAfter);
+    s_acquisitionCount++;
+    s_acquisitionUs += end - start;
+    s_acquisitionYieldedUs += yieldedAfter - yieldedBefore;
+    s_acquisitionSpunUs += spunAfter - spunBefore;
+
+    bool recovering = airQualitySensor->IsRecovering();
+    if (recovering != s_sensorRecovering.exchange(recovering) && lcd && s_displayUpdateTimer) {
+        esp_timer_start_once(s_displayUpdateTimer, 0);
+    }
+
+    if (!read || record.IsEmpty()) {
+        return false;
+    }
+    snapshot = MeasurementSnapshot::FromRecord(record, end);
+    return true;
+}
+
+static void LogAcquisitionCost()
+{
+    uint32_t rejected = s_cycle->GetRejectedCount();
+    ESP_LOGI(TAG, "Acquisition: %u read(s), %u ms total: %u ms yielded, %u ms busy-waiting, %u outlier(s) rejected",
+             (unsigned)s_acquisitionCount, (unsigned)(s_acquisitionUs / 1000),
+             (unsigned)(s_acquisitionYieldedUs / 1000), (unsigned)(s_acquisitionSpunUs / 1000),
+             (unsigned)(rejected - s_loggedRejectedCount));
+    s_loggedRejectedCount = rejected;
+    if (AllocationProbe::kEnabled) {
+        if (s_acquisitionAllocations == 0) {
+            ESP_LOGI(TAG, "Acquisition: no heap allocations");
+        } else {
+            ESP_LOGW(TAG, "Acquisition: %u heap allocation(s)", (unsigned)s_acquisitionAllocations);
+        }
+        s_acquisitionAllocations = 0;
+    }
+    uint32_t tornReads = measurementStore->GetTornReads();
+    if (tornReads != s_loggedTornReads) {
+        ESP_LOGW(TAG, "Acquisition: %u Matter snapshot read(s) raced a report and were retried",
+                 (unsigned)(tornReads - s_loggedTornReads));
+        s_loggedTornReads = tornReads;
+    }
+    // The high-water mark only ever drops; logged each time it does, so the
+    // log shows how much of CONFIG_ACQUISITION_TASK_STACK_SIZE is needed
+    UBaseType_t headroom = uxTaskGetStackHighWaterMark(nullptr);
+    if (headroom < s_loggedStackHeadroom) {
+        if (headroom < kStackHeadroomWarning) {
+            ESP_LOGW(TAG, "Acquisition: only %u of %u stack bytes never used", (unsigned)headroom,
+                     (unsigned)CONFIG_ACQUISITION_TASK_STACK_SIZE);
+        } else {
+            ESP_LOGI(TAG, "Acquisition: %u of %u stack bytes never used", (unsigned)headroom,
+                     (unsigned)CONFIG_ACQUISITION_TASK_STACK_SIZE);
+        }
+        s_loggedStackHeadroom = headroom;
+    }
+    s_acquisitionCount = 0;
+    s_acquisitionUs = 0;
+    s_acquisitionYieldedUs = 0;
+    s_acquisitionSpunUs = 0;
+}
+
+// Runs on the esp_timer task; redraws from the store after a report, or
+// when only the sensor's recovery state changed
+static void DisplayUpdateTimerCallback(void *arg)
+{
+    RenderDisplay();
+}
+
+// The cycle's sensor, flash history, Matter endpoints and display
+class FirmwareSinks : public AcquisitionCycle::Sinks
+{
+public:
+    bool Acquire(MeasurementSnapshot& sample) override { return AcquireSnapshot(sample); }
+
+    void PersistHistory(const MeasurementSnapshot& report) override
+    {
+        ::PersistHistory();
+        LogTrends(report.timestampUs);
+    }
+
+    void Publish(const MeasurementSnapshot& report) override
+    {
+        matterAirQualitySensor->UpdateMeasurements(report);
+        matterTemperatureSensor->UpdateMeasurements(report);
+        matterHumiditySensor->UpdateMeasurements(report);
+
+        if (lcd && s_displayUpdateTimer) {
+            // Fails harmlessly if a redraw is already queued; it shows the newest
+            esp_timer_start_once(s_displayUpdateTimer, 0);
+        }
+    }
+
+    void PollSubscriptions() override { ::PollSubscriptions(); }
+    bool ConsumersIdle() override { return ::ConsumersIdle(); }
+    void OnPeriodChanged() override { ApplyAdaptivePeriod(); }
+    bool IsSensorRecovering() override { return s_sensorRecovering; }
+};
+
+static FirmwareSinks s_acquisitionSinks;
+
+// One acquisition cycle (see AcquisitionCycle::Run()), then the per-report
+// cost log and the occasional VOC state save
+static void RunAcquisitionCycle(bool forceReport)
+{
+    AllocationProbe::Begin();
+    bool reported = s_cycle->Run(forceReport);
+
+    // The cycle runs every sample and must not touch the heap; the cost log
+    // and the occasional NVS save below may
+    s_acquisitionAllocations += AllocationProbe::End();
+    if (reported) {
+        LogAcquisitionCost();
     }
 
     if (airQualitySensor && NowSec() - s_lastVocSaveSec >= kVocStateSaveIntervalSec) {
@@ -782,10 +1292,75 @@ void UpdateSensorsTimerCallback(void *arg)
     }
 }
 
+static void AcquisitionTask(void *arg)
+{
+    AcquisitionSettings settings;
+    s_acqSettings.Read(settings);
+    s_cycle.emplace(*measurementStore, s_acquisitionSinks);
+    s_cycle->Configure(settings.oversample, settings.refreshSeconds, settings.idleRefreshSeconds,
+                       esp_timer_get_time());
+    // StartUpdateSensorsTimer() starts the timer at the unstretched period
+    s_acqSamplePeriodSec = s_cycle->GetSamplePeriodSec();
+    s_effectiveRefreshSec = s_cycle->GetReportPeriodSec();
+
+    while (true) {
+        uint32_t events = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &events, portMAX_DELAY);
+
+        // Settings are published to s_acqSettings before the event is sent
+        if (events & (kAcqEventRestart | kAcqEventAltitude)) {
+            s_acqSettings.Read(settings);
+        }
+
+        if (events & kAcqEventRestart) {
+            s_cycle->Configure(settings.oversample, settings.refreshSeconds, settings.idleRefreshSeconds,
+                               esp_timer_get_time());
+            s_acqSamplePeriodSec = 0; // restart the timer even if the period is unchanged
+            ApplyAdaptivePeriod();
+        }
+
+        if (events & kAcqEventAltitude) {
+            int status = airQualitySensor->UpdateAltitude(settings.altitudeMeters);
+            if (status == 0) {
+                ESP_LOGI(TAG, "Sensor altitude set to %u m", settings.altitudeMeters);
+            } else {
+                ESP_LOGE(TAG, "Failed to set sensor altitude: %d", status);
+            }
+        }
+
+        if (events & kAcqEventFanCleaning) {
+            int status = airQualitySensor->StartFanCleaning();
+            if (status == 0) {
+                ESP_LOGI(TAG, "SEN66 fan cleaning started (takes ~10 s)");
+            } else {
+                ESP_LOGE(TAG, "Failed to start fan cleaning: %d", status);
+            }
+        }
+
+        if (events & (kAcqEventSample | kAcqEventForceReport)) {
+            RunAcquisitionCycle((events & kAcqEventForceReport) != 0);
+        }
+    }
+}
+
+static void NotifyAcquisitionTask(uint32_t events)
+{
+    if (s_acquisitionTask) {
+        xTaskNotify(s_acquisitionTask, events, eSetBits);
+    }
+}
+
+// Timer callback to measure air quality; the read itself runs in AcquisitionTask
+void UpdateSensorsTimerCallback(void *arg)
+{
+    NotifyAcquisitionTask(kAcqEventSample);
+}
+
 /*
- * UI buttons. The iot_button callbacks run in the esp_timer task -- the same
- * task that runs UpdateSensorsTimerCallback -- so LCD and sensor access needs
- * no extra locking. Matter interactions are scheduled onto the Matter thread.
+ * UI buttons. The iot_button callbacks run in the esp_timer task, which owns
+ * the LCD, so display access needs no extra locking. Sensor commands are
+ * forwarded to the acquisition task and Matter interactions are scheduled
+ * onto the Matter thread, so a press never waits on I2C.
  */
 
 static constexpr int kDisplayButtonGpio = 23; // button 1
@@ -797,6 +1372,7 @@ static bool WakeDisplayOnly()
     s_lastActivitySec = NowSec();
     if (lcd && !lcd->IsBacklightOn()) {
         lcd->SetBacklight(true);
+        s_displayAwake = true;
         RenderDisplay();               // redraw fresh content while still blanked
         lcd->SetDisplayVisible(true);  // then reveal it
         return true;
@@ -860,7 +1436,7 @@ static void OnForceRefreshButton(void *arg, void *data)
         return;
     }
     ESP_LOGI(TAG, "Manual sensor refresh");
-    UpdateSensorsTimerCallback(nullptr);
+    NotifyAcquisitionTask(kAcqEventForceReport);
 }
 
 static void OnLightToggleButton(void *arg, void *data)
@@ -917,13 +1493,9 @@ static void OnFanCleaningButton(void *arg, void *data)
     if (!airQualitySensor) {
         return;
     }
-    int status = airQualitySensor->StartFanCleaning();
-    if (status == 0) {
-        ESP_LOGI(TAG, "SEN66 fan cleaning started (takes ~10 s)");
-        ShowMessage("   Fan cleaning...", 12);
-    } else {
-        ESP_LOGE(TAG, "Failed to start fan cleaning: %d", status);
-    }
+    // The acquisition task issues the command and logs the outcome
+    NotifyAcquisitionTask(kAcqEventFanCleaning);
+    ShowMessage("   Fan cleaning...", 12);
 }
 
 // Serial LONG_PRESS_HOLD events on button 2, throttled to a controlled
@@ -991,12 +1563,15 @@ static void DisplayTickCallback(void *arg)
         return;
     }
 
+    TrackUiLatency();
+
     int32_t now = NowSec();
 
     if (now < s_identifyEndSec) {
         s_lastActivitySec = now; // keep the display on while identifying
         if (!lcd->IsBacklightOn()) {
             lcd->SetBacklight(true);
+            s_displayAwake = true;
             RenderDisplay();               // draw the banner while still blanked
             lcd->SetDisplayVisible(true);  // then reveal it
         }
@@ -1015,6 +1590,7 @@ static void DisplayTickCallback(void *arg)
     if (lcd->IsBacklightOn() && !overlayActive && now - s_lastActivitySec >= kBacklightTimeoutSec) {
         lcd->SetBacklight(false);
         lcd->SetDisplayVisible(false); // blank the (reflective) panel too
+        s_displayAwake = false;
     }
 
     if (!lcd->IsBacklightOn()) {
@@ -1059,7 +1635,7 @@ static void StartDisplayTimer()
 
     esp_timer_handle_t handle = nullptr;
     if (esp_timer_create(&timer_args, &handle) == ESP_OK) {
-        esp_timer_start_periodic(handle, 1000000);
+        esp_timer_start_periodic(handle, kDisplayTickPeriodUs);
     }
 }
 
@@ -1097,11 +1673,44 @@ void StartUpdateSensorsTimer()
         return;
     }
     
-    err = esp_timer_start_periodic(sensor_timer_handle, (uint64_t)s_settings.refreshSeconds * 1000000ULL);
+    uint32_t samplePeriod = AcquisitionCycle::SamplePeriodSec(s_settings.oversample, s_settings.refreshSeconds, false);
+    err = esp_timer_start_periodic(sensor_timer_handle, (uint64_t)samplePeriod * 1000000ULL);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to start timer: %s", esp_err_to_name(err));
     }
-    ESP_LOGI(TAG, "Update sensors timer started (every %u s).", (unsigned)s_settings.refreshSeconds);
+    ESP_LOGI(TAG, "Update sensors timer started (every %u s, reporting every %u s).",
+             (unsigned)samplePeriod, (unsigned)s_settings.refreshSeconds);
+}
+
+// Applies a new refresh period or sampling mode from s_settings; the running
+// interval restarts. The acquisition task reprograms the sensor timer.
+static void RestartUpdateSensorsTimer()
+{
+    NotifyAcquisitionTask(kAcqEventRestart);
+    ESP_LOGI(TAG, "Sensor refresh period set to %u s%s, up to %u s when idle", (unsigned)s_settings.refreshSeconds,
+             s_settings.oversample ? " (1 Hz averaged)" : "", (unsigned)s_settings.idleRefreshSeconds);
+}
+
+static void StartAcquisitionTask()
+{
+    if (lcd) {
+        esp_timer_create_args_t timer_args = {
+            .callback = &DisplayUpdateTimerCallback,
+            .arg = nullptr,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "display_update",
+            .skip_unhandled_events = true,
+        };
+        if (esp_timer_create(&timer_args, &s_displayUpdateTimer) != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create display update timer");
+        }
+    }
+
+    if (xTaskCreate(&AcquisitionTask, "acquisition", CONFIG_ACQUISITION_TASK_STACK_SIZE, nullptr,
+                    CONFIG_ACQUISITION_TASK_PRIORITY, &s_acquisitionTask) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create acquisition task");
+        s_acquisitionTask = nullptr;
+    }
 }
 
 extern "C" void app_main()
@@ -1113,6 +1722,7 @@ extern "C" void app_main()
 
     s_settings.Load();
     s_autoRotate = s_settings.autoRotate;
+    PublishAcquisitionSettings(); // before the acquisition task starts
 
     /* Install the network-log tee early so it can capture boot logs once the
      * server is enabled (below, after the Thread stack is up). */
@@ -1143,18 +1753,21 @@ extern "C" void app_main()
         lcd = LCD2004::Create(i2c_bus);
     }
 
+    SetUpMeasurementStore();
+    RestoreHistory();
     RegisterUiButtons();
     StartDisplayTimer();
     CreateIdentifyBlinkTimer();
 
     // Create Matter Air Quality Sensor Endpoint
-    matterAirQualitySensor = MatterAirQualitySensor::CreateEndpoint(matterNode, airQualitySensor, matterExtendedColorLight);
+    matterAirQualitySensor = MatterAirQualitySensor::CreateEndpoint(matterNode, airQualitySensor, matterExtendedColorLight,
+                                                                    measurementStore);
 
     // Create Matter Temperature Sensor Endpoint
-    matterTemperatureSensor = MatterTemperatureSensor::CreateEndpoint(matterNode, airQualitySensor);
+    matterTemperatureSensor = MatterTemperatureSensor::CreateEndpoint(matterNode, measurementStore);
 
     // Create Humidity Sensor Endpoint
-    matterHumiditySensor = MatterHumiditySensor::CreateEndpoint(matterNode, airQualitySensor);
+    matterHumiditySensor = MatterHumiditySensor::CreateEndpoint(matterNode, measurementStore);
 
 #if CHIP_DEVICE_CONFIG_ENABLE_THREAD && CHIP_DEVICE_CONFIG_ENABLE_WIFI_STATION
     // Enable secondary network interface
@@ -1189,6 +1802,7 @@ extern "C" void app_main()
     /* The Thread netif is up now; start the log server if it was left enabled. */
     NetLog::SetEnabled(s_settings.netlogEnabled);
 
+    StartAcquisitionTask();
     StartUpdateSensorsTimer();
 
 #if CONFIG_ENABLE_ENCRYPTED_OTA
@@ -1,5 +1,4 @@
 #include "AirQualitySensor.h"
-#include <map>
 
 bool AirQualitySensor::Init()
 {
@@ -3,7 +3,6 @@
 #include "Sensor.h"
 #include "TemperatureSensor.h"
 #include "RelativeHumiditySensor.h"
-#include <string>
 
 
 class AirQualitySensor : public TemperatureSensor, public RelativeHumiditySensor
@@ -11,6 +10,16 @@ class AirQualitySensor : public TemperatureSensor, public RelativeHumiditySensor
 
 public:
 
+    // What a sensor model is and measures, fixed at compile time. Each
+    // sensor class has one as a static constexpr kCapabilities.
+    struct Capabilities {
+        const char* vendorName;
+        const char* productName;
+        MeasurementMask measurements;
+
+        constexpr bool Supports(MeasurementType type) const { return (measurements & MaskOf(type)) != 0; }
+    };
+
     // Constructor
     explicit AirQualitySensor(float sensorAltitude = 0.0f)
         : m_sensorAltitude(sensorAltitude)
@@ -24,23 +33,17 @@ public:
     bool Init() override;
     
     // Methods from Sensor
-    std::vector<Measurement> ReadAllMeasurements() override = 0;
-
-    // Methods from TemperatureSensor
-    std::optional<float> MeasureTemperature() override = 0;
+    bool ReadMeasurements(MeasurementRecord& record) override = 0;
 
-    // Methods from RelativeHumiditySensor
-    std::optional<float> MeasureRelativeHumidity() override = 0;
+    // The sensor model's constant descriptor
+    virtual const Capabilities& GetCapabilities() const = 0;
 
-    virtual std::string GetProductName() = 0;
+    const char* GetProductName() const { return GetCapabilities().productName; }
 
-    virtual std::string GetVendorName() = 0;
+    const char* GetVendorName() const { return GetCapabilities().vendorName; }
 
     virtual int GetFirmwareVersion(int* firmwareMajorVersion, int* firmwareMinorVersion) = 0;
 
-    // Get the set of measurement types supported by this sensor
-    virtual std::set<MeasurementType> GetSupportedMeasurements() const = 0;
-
     virtual int ActivateAutomaticSelfCalibration() = 0;
 
     virtual int SetAmbientPressure(float ambientPressureKiloPascal) = 0;
@@ -53,6 +56,10 @@ public:
     // no-op for sensors that have no such state.
     virtual void PersistState() {}
 
+    // True while the sensor is being reset/reconfigured after a fault, so the
+    // app can tell "recovering" apart from a plain failed read. Default false.
+    virtual bool IsRecovering() const { return false; }
+
     // Applies a new pressure-compensation altitude (meters) at runtime and
     // remembers it. May briefly interrupt measurement, depending on the sensor.
     virtual int UpdateAltitude(float altitudeMeters);
@@ -14,6 +14,14 @@ class RelativeHumiditySensor : public virtual Sensor {
 public:
     virtual ~RelativeHumiditySensor() = default;
 
-    // Return-based method for humidity measurement
-    virtual std::optional<float> MeasureRelativeHumidity() = 0;
+    // One relative humidity reading in %, taken with a full ReadMeasurements()
+    // transaction into a record on the stack
+    virtual std::optional<float> MeasureRelativeHumidity()
+    {
+        MeasurementRecord record;
+        if (!ReadMeasurements(record) || !record.Has(MeasurementType::RelativeHumidity)) {
+            return std::nullopt;
+        }
+        return (float)record.Get(MeasurementType::RelativeHumidity) / NativeScale(MeasurementType::RelativeHumidity);
+    }
 };
@@ -2,14 +2,22 @@
 
 #include <cmath>
 #include <stdint.h>
+#include <esp_log.h>
 #include "drivers/sensirion/scd30_i2c.h"
 #include "drivers/sensirion/sensirion_common.h"
 #include "drivers/sensirion/sensirion_i2c_hal.h"
 
+namespace {
+    const char* TAG = "SensirionSCD30";
+}
+
 bool SensirionSCD30::Init()
 {
   sensirion_i2c_hal_init();
-  scd30_init(SCD30_I2C_ADDR_61);
+  sensirion_i2c_hal_select_bus(m_i2cBus);
+  if (scd30_init(SCD30_I2C_ADDR_61) != NO_ERROR) {
+    ESP_LOGE(TAG, "SCD30 not reachable on I2C bus %u", (unsigned)m_i2cBus);
+  }
 
   AirQualitySensor::Init();
 
@@ -19,28 +27,9 @@ bool SensirionSCD30::Init()
   return true;
 }
 
-std::set<Sensor::MeasurementType> SensirionSCD30::GetSupportedMeasurements() const
-{
-    // Return the measurement types supported by SEN66
-    return {
-        Sensor::MeasurementType::CO2,
-        Sensor::MeasurementType::RelativeHumidity,
-        Sensor::MeasurementType::Temperature
-    };
-}
-
-std::string SensirionSCD30::GetProductName()
-{
-  return "SCD30";
-}
-
-std::string SensirionSCD30::GetVendorName()
-{
-  return "Sensirion";
-}
-
 int SensirionSCD30::GetFirmwareVersion(int* firmwareMajorVersion, int* firmwareMinorVersion)
 {
+  sensirion_i2c_hal_select_bus(m_i2cBus);
   uint8_t majorVersion;
   uint8_t minorVersion;
 
@@ -52,91 +41,54 @@ int SensirionSCD30::GetFirmwareVersion(int* firmwareMajorVersion, int* firmwareM
   return status;
 }
 
-std::vector<AirQualitySensor::Measurement> SensirionSCD30::ReadAllMeasurements()
+bool SensirionSCD30::ReadMeasurements(MeasurementRecord& record)
 {
+  sensirion_i2c_hal_select_bus(m_i2cBus);
   float co2_concentration;
   float temperature;
   float humidity;
 
-  std::vector<AirQualitySensor::Measurement> measurements;
+  record.Clear();
 
   int16_t local_error = 0;
   local_error = scd30_await_data_ready();
   if (local_error != NO_ERROR) {
-      return measurements; // Return an empty vector on error
+      return false;
   }
 
   local_error =
       scd30_read_measurement_data(&co2_concentration, &temperature, &humidity);
   if (local_error != NO_ERROR) {
-      return measurements; // Return an empty vector on error
+      return false;
   }
 
-  measurements.push_back({MeasurementType::RelativeHumidity, humidity});
-  measurements.push_back({MeasurementType::Temperature, temperature});
-  measurements.push_back({MeasurementType::CO2, static_cast<float>(co2_concentration)});
+  // The SCD30 driver decodes its float frame; scale to native steps once here
+  record.Set(MeasurementType::RelativeHumidity,
+             (int32_t)lroundf(humidity * Sensor::NativeScale(MeasurementType::RelativeHumidity)));
+  record.Set(MeasurementType::Temperature,
+             (int32_t)lroundf(temperature * Sensor::NativeScale(MeasurementType::Temperature)));
+  record.Set(MeasurementType::CO2, (int32_t)lroundf(co2_concentration));
 
-  return measurements;
-}
-
-// Methods from TemperatureSensor
-std::optional<float> SensirionSCD30::MeasureTemperature()
-{
-    float co2_concentration;
-    float temperature;
-    float humidity;
-
-    int16_t local_error = 0;
-    local_error = scd30_await_data_ready();
-    if (local_error != NO_ERROR) {
-        return std::nullopt; // Return nullopt on error
-    }
-
-    local_error =
-        scd30_read_measurement_data(&co2_concentration, &temperature, &humidity);
-    if (local_error != NO_ERROR) {
-        return std::nullopt; // Return nullopt on error
-    }
-
-    return temperature;
-}
-
-// Methods from RelativeHumiditySensor
-std::optional<float> SensirionSCD30::MeasureRelativeHumidity()
-{
-    float co2_concentration;
-    float temperature;
-    float humidity;
-
-    int16_t local_error = 0;
-    local_error = scd30_await_data_ready();
-    if (local_error != NO_ERROR) {
-        return std::nullopt; // Return nullopt on error
-    }
-
-    local_error =
-        scd30_read_measurement_data(&co2_concentration, &temperature, &humidity);
-    if (local_error != NO_ERROR) {
-        return std::nullopt; // Return nullopt on error
-    }
-
-    return humidity;
+  return true;
 }
 
 int SensirionSCD30::ActivateAutomaticSelfCalibration()
 {
+  sensirion_i2c_hal_select_bus(m_i2cBus);
   int16_t status = scd30_activate_auto_calibration(1);
   return status;
 }
 
 int SensirionSCD30::SetAltitude(float altitude)
 {
+  sensirion_i2c_hal_select_bus(m_i2cBus);
   int16_t status = scd30_set_altitude_compensation(altitude);
   return status;
 }
 
 int SensirionSCD30::SetAmbientPressure(float ambientPressureKiloPascal)
 {
+  sensirion_i2c_hal_select_bus(m_i2cBus);
   // Round the float to the nearest integer and convert to uint16_t
   uint16_t pressureHektoPascal = static_cast<uint16_t>(std::round(ambientPressureKiloPascal * 10.0f));
 
@@ -147,6 +99,7 @@ int SensirionSCD30::SetAmbientPressure(float ambientPressureKiloPascal)
 
 int SensirionSCD30::StartContinuousMeasurement()
 {
+  sensirion_i2c_hal_select_bus(m_i2cBus);
   uint16_t ambient_pressure = 0; // Disable pressure compensation
   int16_t status = scd30_start_periodic_measurement(ambient_pressure);
 
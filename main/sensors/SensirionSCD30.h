@@ -1,37 +1,31 @@
 #include "AirQualitySensor.h"
-#include <set>
-#include <vector>
-#include <optional>
 
 class SensirionSCD30 : public AirQualitySensor
 {
 public:
-    // Constructor
-    explicit SensirionSCD30(float sensorAltitude = 0.0f)
-      : AirQualitySensor(sensorAltitude)
+    // Constructor. i2cBus is the I2C port the sensor is wired to; the HAL
+    // creates port 0, any other port must exist before Init().
+    explicit SensirionSCD30(float sensorAltitude = 0.0f, uint8_t i2cBus = 0)
+      : AirQualitySensor(sensorAltitude), m_i2cBus(i2cBus)
     {
     }
 
     // Initialize the sensor
     bool Init() override;
 
-    virtual std::string GetProductName() override;
+    static constexpr Capabilities kCapabilities = {
+        "Sensirion", "SCD30",
+        MaskOf(MeasurementType::CO2) |
+        MaskOf(MeasurementType::RelativeHumidity) |
+        MaskOf(MeasurementType::Temperature),
+    };
 
-    virtual std::string GetVendorName() override;
+    const Capabilities& GetCapabilities() const override { return kCapabilities; }
 
     int GetFirmwareVersion(int* firmwareMajorVersion, int* firmwareMinorVersion) override;
 
-    // Get the set of measurement types supported by this sensor
-    std::set<Sensor::MeasurementType> GetSupportedMeasurements() const override;
-
     // Read all supported measurements
-    std::vector<AirQualitySensor::Measurement> ReadAllMeasurements() override;
-
-    // Methods from TemperatureSensor
-    std::optional<float> MeasureTemperature() override;
-
-    // Methods from RelativeHumiditySensor
-    std::optional<float> MeasureRelativeHumidity() override;
+    bool ReadMeasurements(MeasurementRecord& record) override;
 
     int ActivateAutomaticSelfCalibration() override;
 
@@ -44,4 +38,7 @@ protected:
     // Set sensor altitude
     int SetAltitude(float altitude) override;
 
+private:
+    // I2C port selected before every command, see sensirion_i2c_hal_select_bus()
+    uint8_t m_i2cBus;
 };
@@ -4,9 +4,11 @@
 #include <cstring>
 #include <stdint.h>
 #include <esp_log.h>
+#include <esp_timer.h>
 #include <nvs.h>
 #include "drivers/sensirion/sen66_i2c.h"
 #include "drivers/sensirion/sensirion_common.h"
+#include "drivers/sensirion/sensirion_i2c.h"
 #include "drivers/sensirion/sensirion_i2c_hal.h"
 
 namespace {
@@ -16,24 +18,47 @@ namespace {
     const char* kVocNvsKey = "voc_state";
     constexpr uint16_t INVALID_UINT16 = 0xFFFF;
     constexpr int16_t INVALID_INT16 = 0x7FFF;
-    constexpr float PM_CONVERSION_FACTOR = 10.0f;
-    constexpr float HUMIDITY_CONVERSION_FACTOR = 100.0f;
-    constexpr float TEMPERATURE_CONVERSION_FACTOR = 200.0f;
-    constexpr float VOC_CONVERSION_FACTOR = 10.0f;
-    constexpr float NOX_CONVERSION_FACTOR = 10.0f;
-}
 
-// Initialize SensorData with default invalid values
-SensirionSEN66::SensorData::SensorData()
-    : pm1p0(INVALID_UINT16), pm2p5(INVALID_UINT16), pm4p0(INVALID_UINT16), pm10p0(INVALID_UINT16),
-      humidity(INVALID_INT16), temperature(INVALID_INT16), vocIndex(INVALID_INT16), noxIndex(INVALID_INT16),
-      co2(INVALID_UINT16) {
+    // Words of the "read measured values as integers" response, in order.
+    // Signed words mark a missing value with INVALID_INT16, unsigned ones
+    // with INVALID_UINT16; all are already in native steps.
+    struct MeasuredWord {
+        Sensor::MeasurementType type;
+        bool isSigned;
+    };
+    constexpr MeasuredWord kMeasuredWords[] = {
+        {Sensor::MeasurementType::PM1p0, false},
+        {Sensor::MeasurementType::PM2p5, false},
+        {Sensor::MeasurementType::PM4p0, false},
+        {Sensor::MeasurementType::PM10p0, false},
+        {Sensor::MeasurementType::RelativeHumidity, true},
+        {Sensor::MeasurementType::Temperature, true},
+        {Sensor::MeasurementType::VOC, true},
+        {Sensor::MeasurementType::NOx, true},
+        {Sensor::MeasurementType::CO2, false},
+    };
+    constexpr uint16_t kMeasuredWordCount = sizeof(kMeasuredWords) / sizeof(kMeasuredWords[0]);
+
+    // One response word as a value in native steps, or Sensor::kNoValue for
+    // the missing-value marker. Unsigned words keep their full 16-bit range:
+    // CO2 goes up to 40000 ppm, past what an int16_t holds.
+    int32_t DecodeWord(uint16_t word, bool isSigned)
+    {
+        if (isSigned) {
+            int16_t value = static_cast<int16_t>(word);
+            return value == INVALID_INT16 ? Sensor::kNoValue : value;
+        }
+        return word == INVALID_UINT16 ? Sensor::kNoValue : static_cast<int32_t>(word);
+    }
 }
 
 bool SensirionSEN66::Init()
 {
   sensirion_i2c_hal_init();
-  sen66_init(SEN66_I2C_ADDR_6B);
+  sensirion_i2c_hal_select_bus(m_i2cBus);
+  if (sen66_init(SEN66_I2C_ADDR_6B) != NO_ERROR) {
+    ESP_LOGE(TAG, "SEN66 not reachable on I2C bus %u", (unsigned)m_i2cBus);
+  }
 
   AirQualitySensor::Init();
 
@@ -44,32 +69,23 @@ bool SensirionSEN66::Init()
   return true;
 }
 
-std::set<AirQualitySensor::MeasurementType> SensirionSEN66::GetSupportedMeasurements() const
-{
-    // Return the measurement types supported by SEN66
-    return {
-        Sensor::MeasurementType::CO2,
-        Sensor::MeasurementType::PM1p0,
-        Sensor::MeasurementType::PM2p5,
-        Sensor::MeasurementType::PM4p0,
-        Sensor::MeasurementType::PM10p0,
-        Sensor::MeasurementType::RelativeHumidity,
-        Sensor::MeasurementType::Temperature,
-        Sensor::MeasurementType::VOC,
-        Sensor::MeasurementType::NOx
-    };
-}
-
 // Private helper that reads all sensor values in one transaction. Tracks
-// consecutive failures and triggers a recovery once they cross the threshold,
+// consecutive failures and starts a recovery once they cross the threshold,
 // so a wedged sensor gets reset instead of silently returning no data forever.
-int16_t SensirionSEN66::ReadSensorData(SensorData& data) {
-    int16_t error = sen66_read_measured_values_as_integers(
-        &data.pm1p0, &data.pm2p5, &data.pm4p0, &data.pm10p0,
-        &data.humidity, &data.temperature, &data.vocIndex, &data.noxIndex, &data.co2);
+// While recovering, each call advances the recovery by one step instead.
+int16_t SensirionSEN66::ReadSensorData(MeasurementRecord& record) {
+    sensirion_i2c_hal_select_bus(m_i2cBus);
+
+    if (m_recoveryStep != RecoveryStep::None) {
+        StepRecovery();
+        return I2C_BUS_ERROR;
+    }
+
+    int16_t error = ReadMeasuredValues(record);
 
     if (error == NO_ERROR) {
         m_consecutiveReadFailures = 0;
+        m_recoveryAttempts = 0;
         return error;
     }
 
@@ -78,35 +94,135 @@ int16_t SensirionSEN66::ReadSensorData(SensorData& data) {
              error, m_consecutiveReadFailures);
 
     if (m_consecutiveReadFailures >= kMaxConsecutiveReadFailures) {
-        Recover();
         m_consecutiveReadFailures = 0;
+        StartRecovery();
     }
 
     return error;
 }
 
-// Recovers the sensor after repeated read failures: a soft reset returns it to
-// idle (the driver waits ~1.2 s internally), then the volatile configuration is
-// re-applied and continuous measurement restarted. This runs on the
-// measurement-timer task, so a rare ~1.3 s stall here is acceptable.
-void SensirionSEN66::Recover() {
-    ESP_LOGW(TAG, "SEN66 unresponsive; attempting recovery (device reset + reconfigure)");
+// Same transaction as sen66_read_measured_values_as_integers(), but the
+// 27-byte response is CRC-checked and unpacked into record in one pass instead
+// of being compacted in place and then converted field by field.
+int16_t SensirionSEN66::ReadMeasuredValues(MeasurementRecord& record) {
+    uint8_t command[SENSIRION_COMMAND_SIZE];
+    uint16_t length = sensirion_i2c_add_command16_to_buffer(command, 0, SEN66_READ_MEASURED_VALUES_AS_INTEGERS_CMD_ID);
+    int16_t error = sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, command, length);
+    if (error != NO_ERROR) {
+        return error;
+    }
+    sensirion_i2c_hal_sleep_usec(20 * 1000);
+
+    uint16_t words[kMeasuredWordCount];
+    error = sensirion_i2c_read_words_decoded(SEN66_I2C_ADDR_6B, words, kMeasuredWordCount);
+    if (error != NO_ERROR) {
+        return error;
+    }
+    for (uint16_t i = 0; i < kMeasuredWordCount; i++) {
+        int32_t value = DecodeWord(words[i], kMeasuredWords[i].isSigned);
+        if (value != Sensor::kNoValue) {
+            record.Set(kMeasuredWords[i].type, value);
+        }
+    }
+    return NO_ERROR;
+}
+
+// Enters recovery. The first attempt after a good read resets right away;
+// each further attempt waits twice as long as the previous one, so a sensor
+// that stays dead costs one short I2C command every few minutes at most.
+void SensirionSEN66::StartRecovery() {
+    int64_t backoffUs = 0;
+    if (m_recoveryAttempts > 0) {
+        backoffUs = kRecoveryBackoffMinUs;
+        for (int i = 1; i < m_recoveryAttempts && backoffUs < kRecoveryBackoffMaxUs; i++) {
+            backoffUs *= 2;
+        }
+        if (backoffUs > kRecoveryBackoffMaxUs) {
+            backoffUs = kRecoveryBackoffMaxUs;
+        }
+    }
 
-    int16_t status = sen66_device_reset();
-    if (status != NO_ERROR) {
-        ESP_LOGE(TAG, "SEN66 device reset failed (error %d); will retry next cycle", status);
+    ESP_LOGW(TAG, "SEN66 unresponsive; recovery attempt %d in %u s",
+             m_recoveryAttempts + 1, (unsigned)(backoffUs / 1000000));
+    m_recoveryStep = RecoveryStep::Reset;
+    m_recoveryNextStepUs = esp_timer_get_time() + backoffUs;
+}
+
+void SensirionSEN66::FailRecovery(const char* step, int16_t status) {
+    ESP_LOGE(TAG, "SEN66 recovery failed at %s (error %d)", step, status);
+    m_recoveryAttempts++;
+    StartRecovery();
+}
+
+// Runs at most one recovery step: a single short command, or nothing while a
+// wait is pending. Sensor altitude, automatic self-calibration, the VOC
+// algorithm state and the measurement mode are all reset by the device reset,
+// so they are re-applied exactly as Init() does.
+void SensirionSEN66::StepRecovery() {
+    if (esp_timer_get_time() < m_recoveryNextStepUs) {
+        return;
+    }
+
+    int16_t status = NO_ERROR;
+    switch (m_recoveryStep) {
+    case RecoveryStep::None:
+        return;
+
+    case RecoveryStep::Reset: {
+        // sen66_device_reset() would block for the whole reset time; send the
+        // bare command and wait for the sensor in AwaitReset instead.
+        uint8_t buffer[2];
+        uint16_t length = sensirion_i2c_add_command16_to_buffer(buffer, 0, SEN66_DEVICE_RESET_CMD_ID);
+        status = sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer, length);
+        if (status != NO_ERROR) {
+            FailRecovery("device reset", status);
+            return;
+        }
+        m_recoveryStep = RecoveryStep::AwaitReset;
+        m_recoveryNextStepUs = esp_timer_get_time() + kResetDurationUs;
         return;
     }
 
-    // Sensor altitude, automatic self-calibration, the VOC algorithm state and
-    // the measurement mode are all reset by device_reset, so re-apply them
-    // exactly as Init() does.
-    sen66_set_sensor_altitude(static_cast<uint16_t>(m_sensorAltitude));
-    ActivateAutomaticSelfCalibration();
-    RestoreVocState();
-    StartContinuousMeasurement();
+    case RecoveryStep::AwaitReset:
+        m_recoveryStep = RecoveryStep::SetAltitude;
+        return;
+
+    case RecoveryStep::SetAltitude:
+        status = sen66_set_sensor_altitude(static_cast<uint16_t>(m_sensorAltitude));
+        if (status != NO_ERROR) {
+            FailRecovery("altitude", status);
+            return;
+        }
+        m_recoveryStep = RecoveryStep::EnableSelfCalibration;
+        return;
 
-    ESP_LOGI(TAG, "SEN66 recovery complete");
+    case RecoveryStep::EnableSelfCalibration:
+        status = sen66_set_co2_sensor_automatic_self_calibration(1);
+        if (status != NO_ERROR) {
+            FailRecovery("self-calibration", status);
+            return;
+        }
+        m_recoveryStep = RecoveryStep::RestoreVocState;
+        return;
+
+    case RecoveryStep::RestoreVocState:
+        RestoreVocState(); // best effort; the algorithm can start fresh
+        m_recoveryStep = RecoveryStep::StartMeasurement;
+        return;
+
+    case RecoveryStep::StartMeasurement:
+        status = sen66_start_continuous_measurement();
+        if (status != NO_ERROR) {
+            FailRecovery("start measurement", status);
+            return;
+        }
+        // Counts as a failed attempt until a read succeeds, so a sensor that
+        // reconfigures fine but still can't be read keeps backing off.
+        m_recoveryAttempts++;
+        m_recoveryStep = RecoveryStep::None;
+        ESP_LOGI(TAG, "SEN66 recovery complete");
+        return;
+    }
 }
 
 // Restores the VOC gas-index algorithm state saved in NVS into the sensor so it
@@ -147,6 +263,10 @@ void SensirionSEN66::RestoreVocState() {
 // to call while measuring. Skips the write when the state is unchanged, to
 // avoid needless flash wear.
 void SensirionSEN66::PersistState() {
+    sensirion_i2c_hal_select_bus(m_i2cBus);
+    if (m_recoveryStep != RecoveryStep::None) {
+        return; // the sensor is mid-reset; its state is not meaningful
+    }
     uint8_t state[kVocStateSize];
     int16_t status = sen66_get_voc_algorithm_state(state, kVocStateSize);
     if (status != NO_ERROR) {
@@ -181,86 +301,28 @@ void SensirionSEN66::PersistState() {
     ESP_LOGI(TAG, "Persisted VOC algorithm state to NVS");
 }
 
-std::vector<AirQualitySensor::Measurement> SensirionSEN66::ReadAllMeasurements() {
-      SensorData data;
-      std::vector<AirQualitySensor::Measurement> measurements;
-
-      if (ReadSensorData(data) != NO_ERROR) {
-          return measurements; // Return empty vector on error
-      }
-
-      // Add valid measurements to the vector
-      if (data.pm1p0 != INVALID_UINT16) {
-          measurements.push_back({MeasurementType::PM1p0, data.pm1p0 / PM_CONVERSION_FACTOR});
-      }
-      if (data.pm2p5 != INVALID_UINT16) {
-          measurements.push_back({MeasurementType::PM2p5, data.pm2p5 / PM_CONVERSION_FACTOR});
-      }
-      if (data.pm4p0 != INVALID_UINT16) {
-          measurements.push_back({MeasurementType::PM4p0, data.pm4p0 / PM_CONVERSION_FACTOR});
-      }
-      if (data.pm10p0 != INVALID_UINT16) {
-          measurements.push_back({MeasurementType::PM10p0, data.pm10p0 / PM_CONVERSION_FACTOR});
-      }
-      if (data.humidity != INVALID_INT16) {
-          measurements.push_back({MeasurementType::RelativeHumidity, data.humidity / HUMIDITY_CONVERSION_FACTOR});
-      }
-      if (data.temperature != INVALID_INT16) {
-          measurements.push_back({MeasurementType::Temperature, data.temperature / TEMPERATURE_CONVERSION_FACTOR});
-      }
-      if (data.vocIndex != INVALID_INT16) {
-          measurements.push_back({MeasurementType::VOC, data.vocIndex / VOC_CONVERSION_FACTOR});
-      }
-      if (data.noxIndex != INVALID_INT16) {
-          measurements.push_back({MeasurementType::NOx, data.noxIndex / NOX_CONVERSION_FACTOR});
-      }
-      if (data.co2 != INVALID_UINT16) {
-          measurements.push_back({MeasurementType::CO2, static_cast<float>(data.co2)});
-      }
-
-      return measurements;
-}
-
-std::optional<float> SensirionSEN66::MeasureTemperature() {
-    SensorData data;
-    if (ReadSensorData(data) != NO_ERROR || data.temperature == INVALID_INT16) {
-        return std::nullopt;
-    }
-    return data.temperature / TEMPERATURE_CONVERSION_FACTOR;
-}
-
-std::optional<float> SensirionSEN66::MeasureRelativeHumidity() {
-    SensorData data;
-    if (ReadSensorData(data) != NO_ERROR || data.humidity == INVALID_INT16) {
-        return std::nullopt;
-    }
-    return data.humidity / HUMIDITY_CONVERSION_FACTOR;
+bool SensirionSEN66::ReadMeasurements(MeasurementRecord& record) {
+    record.Clear();
+    return ReadSensorData(record) == NO_ERROR;
 }
 
 int SensirionSEN66::ActivateAutomaticSelfCalibration()
 {
+  sensirion_i2c_hal_select_bus(m_i2cBus);
   int16_t status = sen66_set_co2_sensor_automatic_self_calibration(1);
   return status;
 }
 
 int SensirionSEN66::StartFanCleaning()
 {
+  sensirion_i2c_hal_select_bus(m_i2cBus);
   int16_t status = sen66_start_fan_cleaning();
   return status;
 }
 
-std::string SensirionSEN66::GetProductName()
-{
-  return "SEN66";
-}
-
-std::string SensirionSEN66::GetVendorName()
-{
-  return "Sensirion";
-}
-
 int SensirionSEN66::GetFirmwareVersion(int* firmwareMajorVersion, int* firmwareMinorVersion)
 {
+  sensirion_i2c_hal_select_bus(m_i2cBus);
   uint8_t majorVersion;
   uint8_t minorVersion;
   int16_t status = sen66_get_version(&majorVersion, &minorVersion);
@@ -277,6 +339,7 @@ int SensirionSEN66::GetFirmwareVersion(int* firmwareMajorVersion, int* firmwareM
 // This configuration is volatile, i.e. the parameter will be reverted to its default value after a device reset.
 int SensirionSEN66::SetAltitude(float altitude)
 {
+  sensirion_i2c_hal_select_bus(m_i2cBus);
   int16_t status = sen66_set_sensor_altitude(altitude);
   return status;
 }
@@ -289,6 +352,7 @@ int SensirionSEN66::SetAltitude(float altitude)
 // This configuration is volatile, i.e. the parameter will be reverted to its default value after a device reset.
 int SensirionSEN66::SetAmbientPressure(float ambientPressureKiloPascal)
 {
+  sensirion_i2c_hal_select_bus(m_i2cBus);
   // Round the float to the nearest integer and convert to uint16_t
   uint16_t pressureHektoPascal = static_cast<uint16_t>(std::round(ambientPressureKiloPascal * 10.0f));
 
@@ -299,6 +363,7 @@ int SensirionSEN66::SetAmbientPressure(float ambientPressureKiloPascal)
 
 int SensirionSEN66::StartContinuousMeasurement()
 {
+  sensirion_i2c_hal_select_bus(m_i2cBus);
   int16_t status = sen66_start_continuous_measurement();
 
   return status;
@@ -306,6 +371,7 @@ int SensirionSEN66::StartContinuousMeasurement()
 
 int SensirionSEN66::UpdateAltitude(float altitudeMeters)
 {
+  sensirion_i2c_hal_select_bus(m_i2cBus);
   m_sensorAltitude = altitudeMeters;
 
   sen66_stop_measurement();
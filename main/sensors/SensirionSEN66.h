@@ -1,38 +1,38 @@
 #include "AirQualitySensor.h"
 #include "TemperatureSensor.h"
-#include <set>
-#include <vector>
-#include <optional>
 
 class SensirionSEN66 : public AirQualitySensor
 {
 public:
-    // Constructor
-    explicit SensirionSEN66(float sensorAltitude = 0.0f)
-      : AirQualitySensor(sensorAltitude)
+    // Constructor. i2cBus is the I2C port the sensor is wired to; the HAL
+    // creates port 0, any other port must exist before Init().
+    explicit SensirionSEN66(float sensorAltitude = 0.0f, uint8_t i2cBus = 0)
+      : AirQualitySensor(sensorAltitude), m_i2cBus(i2cBus)
     {
     }
 
     // Initialize the sensor
     bool Init() override;
 
-    virtual std::string GetProductName() override;
+    static constexpr Capabilities kCapabilities = {
+        "Sensirion", "SEN66",
+        MaskOf(MeasurementType::CO2) |
+        MaskOf(MeasurementType::PM1p0) |
+        MaskOf(MeasurementType::PM2p5) |
+        MaskOf(MeasurementType::PM4p0) |
+        MaskOf(MeasurementType::PM10p0) |
+        MaskOf(MeasurementType::RelativeHumidity) |
+        MaskOf(MeasurementType::Temperature) |
+        MaskOf(MeasurementType::VOC) |
+        MaskOf(MeasurementType::NOx),
+    };
 
-    virtual std::string GetVendorName() override;
+    const Capabilities& GetCapabilities() const override { return kCapabilities; }
 
     int GetFirmwareVersion(int* firmwareMajorVersion, int* firmwareMinorVersion) override;
 
-    // Get the set of measurement types supported by this sensor
-    std::set<Sensor::MeasurementType> GetSupportedMeasurements() const override;
-
     // Read all supported measurements
-    std::vector<AirQualitySensor::Measurement> ReadAllMeasurements() override;
-
-    // Methods from TemperatureSensor
-    std::optional<float> MeasureTemperature() override;
-
-    // Methods from RelativeHumiditySensor
-    std::optional<float> MeasureRelativeHumidity() override;
+    bool ReadMeasurements(MeasurementRecord& record) override;
 
     int ActivateAutomaticSelfCalibration() override;
 
@@ -52,27 +52,20 @@ public:
     // reboot. Skips the write when the state is unchanged.
     void PersistState() override;
 
+    // True while a recovery is in progress; reads return no data meanwhile.
+    bool IsRecovering() const override { return m_recoveryStep != RecoveryStep::None; }
+
 protected:
     // Set sensor altitude
     int SetAltitude(float altitude) override;
 
 private:
 
-    struct SensorData {
-        uint16_t pm1p0;
-        uint16_t pm2p5;
-        uint16_t pm4p0;
-        uint16_t pm10p0;
-        int16_t humidity;
-        int16_t temperature;
-        int16_t vocIndex;
-        int16_t noxIndex;
-        uint16_t co2;
-
-        SensorData();
-    };
+    int16_t ReadSensorData(MeasurementRecord& record);
 
-    int16_t ReadSensorData(SensorData& data);
+    // One "read measured values as integers" transaction, decoded straight
+    // into record.
+    int16_t ReadMeasuredValues(MeasurementRecord& record);
 
     // Restores the VOC gas-index algorithm state from NVS (if any) into the
     // sensor. Must be called in idle mode, before StartContinuousMeasurement.
@@ -85,12 +78,37 @@ private:
     bool m_hasSavedVocState = false;
     uint8_t m_lastSavedVocState[kVocStateSize] = {0};
 
-    // Resets and reconfigures the sensor after repeated read failures.
-    void Recover();
+    // Recovery after repeated read failures: a device reset followed by
+    // re-applying the volatile configuration. It advances one step per
+    // ReadMeasurements() call instead of blocking for the ~1.2 s reset, and
+    // failed attempts are retried with exponential backoff.
+    enum class RecoveryStep {
+        None,             // healthy, reading normally
+        Reset,            // send the device reset once the backoff expires
+        AwaitReset,       // wait for the sensor to come back out of reset
+        SetAltitude,
+        EnableSelfCalibration,
+        RestoreVocState,
+        StartMeasurement,
+    };
+
+    void StartRecovery();
+    void StepRecovery();
+    void FailRecovery(const char* step, int16_t status);
+
+    RecoveryStep m_recoveryStep = RecoveryStep::None;
+    int64_t m_recoveryNextStepUs = 0; // esp_timer time the current step may run
+    int m_recoveryAttempts = 0;       // failed attempts since the last good read
+
+    static constexpr int64_t kResetDurationUs = 1200 * 1000;
+    static constexpr int64_t kRecoveryBackoffMinUs = 2 * 1000 * 1000;
+    static constexpr int64_t kRecoveryBackoffMaxUs = 5 * 60 * 1000 * 1000LL;
 
     // Consecutive ReadSensorData failures; once this reaches
-    // kMaxConsecutiveReadFailures a recovery is attempted.
+    // kMaxConsecutiveReadFailures a recovery is started.
     int m_consecutiveReadFailures = 0;
     static constexpr int kMaxConsecutiveReadFailures = 5;
 
+    // I2C port selected before every command, see sensirion_i2c_hal_select_bus()
+    uint8_t m_i2cBus;
 };
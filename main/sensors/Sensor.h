@@ -7,9 +7,8 @@
 
 #pragma once
 
-#include <set>
-#include <string>
-#include <vector>
+#include <stddef.h>
+#include <stdint.h>
 
 class Sensor
 {
@@ -30,20 +29,120 @@ public:
     VOC
   };
 
+  // Number of MeasurementType values, for tables indexed by type
+  static constexpr size_t kMeasurementTypeCount = static_cast<size_t>(MeasurementType::VOC) + 1;
+
+  // Bit set of MeasurementTypes, e.g. what a sensor can measure
+  using MeasurementMask = uint32_t;
+
+  static constexpr MeasurementMask MaskOf(MeasurementType measurementType) {
+    return 1u << static_cast<uint32_t>(measurementType);
+  }
+
+  // Per-type constants, indexed by MeasurementType:
+  //  - name: short ASCII name for logs
+  //  - unit: UTF-8 unit for logs, "" for the unitless indices
+  //  - nativeScale: steps per unit at the sensors' native integer resolution
+  //    (the SEN66's wire encoding). Measurements travel from the sensor to
+  //    the Matter attributes as integers in these steps; the chip has no FPU,
+  //    so floats are only made where a value is shown.
+  //  - decimals: digits after the point when a value is logged
+  //  - isSigned: values can be negative. Unsigned types get the full 0-65534
+  //    step range where values are stored in 16 bits (CO2 reaches 40000 ppm).
+  struct MeasurementInfo {
+    MeasurementType type;
+    const char* name;
+    const char* unit;
+    int32_t nativeScale;
+    int decimals;
+    bool isSigned;
+  };
+
+  static constexpr MeasurementInfo kMeasurementInfo[kMeasurementTypeCount] = {
+    {MeasurementType::AmbientLight,       "AmbientLight",       "",                      1,   0, false},
+    {MeasurementType::BarometricPressure, "BarometricPressure", "",                      1,   0, false},
+    {MeasurementType::CO2,                "CO2",                " ppm",                  1,   0, false},
+    {MeasurementType::NOx,                "NOx",                "",                      10,  1, false},
+    {MeasurementType::PM1p0,              "PM1",                " \xC2\xB5g/m\xC2\xB3", 10,  1, false},
+    {MeasurementType::PM2p5,              "PM25",               " \xC2\xB5g/m\xC2\xB3", 10,  1, false},
+    {MeasurementType::PM4p0,              "PM4",                " \xC2\xB5g/m\xC2\xB3", 10,  1, false},
+    {MeasurementType::PM10p0,             "PM10",               " \xC2\xB5g/m\xC2\xB3", 10,  1, false},
+    {MeasurementType::RelativeHumidity,   "Humidity",           " %RH",                  100, 2, false},
+    {MeasurementType::Temperature,        "Temperature",        " \xC2\xB0" "C",        200, 2, true},
+    {MeasurementType::VOC,                "VOC",                "",                      10,  1, false},
+  };
+
+  static constexpr const MeasurementInfo& InfoOf(MeasurementType measurementType) {
+    return kMeasurementInfo[static_cast<size_t>(measurementType)];
+  }
+
+  static constexpr int32_t NativeScale(MeasurementType measurementType) {
+    return InfoOf(measurementType).nativeScale;
+  }
+
+  // Short name of a type for logs; a static string, never allocates
+  static constexpr const char* MeasurementTypeToString(MeasurementType measurementType) {
+    return InfoOf(measurementType).name;
+  }
+
+  // Converts a value in native steps to stepsPerUnit (e.g. 100 for the 0.01
+  // units Matter uses), rounding half away from zero
+  static constexpr int32_t Rescale(MeasurementType measurementType, int32_t nativeValue, int32_t stepsPerUnit) {
+    int32_t scale = NativeScale(measurementType);
+    int32_t scaled = nativeValue * stepsPerUnit;
+    return (scaled + (scaled >= 0 ? scale / 2 : -scale / 2)) / scale;
+  }
+
+  static constexpr bool IsSigned(MeasurementType measurementType) {
+    return InfoOf(measurementType).isSigned;
+  }
+
+  // A value the sensor did not provide, where an int32_t stands for one
+  static constexpr int32_t kNoValue = INT32_MIN;
+
   // Struct to hold a single measurement value and its type
   struct Measurement {
       MeasurementType type;
-      float value;
+      int32_t value; // in NativeScale() steps
+  };
+
+  // The values of one read, indexed by type, in NativeScale() steps. Bit n of
+  // validMask is set when values[n] holds a reading. Fixed-size and owned by
+  // the caller, so a read never touches the heap.
+  struct MeasurementRecord {
+      MeasurementMask validMask = 0;
+      int32_t values[kMeasurementTypeCount] = {};
+
+      bool IsEmpty() const { return validMask == 0; }
+      bool Has(MeasurementType type) const { return (validMask & MaskOf(type)) != 0; }
+      int32_t Get(MeasurementType type) const { return Has(type) ? values[static_cast<size_t>(type)] : kNoValue; }
+
+      void Set(MeasurementType type, int32_t value) {
+          values[static_cast<size_t>(type)] = value;
+          validMask |= MaskOf(type);
+      }
+
+      void Clear() { *this = MeasurementRecord(); }
   };
 
   // Initialize the sensor
   virtual bool Init() = 0;
 
-  // Read all supported measurements
-  // Returns a vector of Measurement structs for all available measurements
-  virtual std::vector<Measurement> ReadAllMeasurements() = 0;
+  // Reads all supported measurements in one transaction into record, which
+  // is cleared first. Returns false when the read failed; record then holds
+  // no values.
+  virtual bool ReadMeasurements(MeasurementRecord& record) = 0;
 
-  // Convert SensorType to string
-  static std::string MeasurementTypeToString(MeasurementType measurementType);
+  // True when kMeasurementInfo lists the types in enum order
+  static constexpr bool IsInfoInTypeOrder() {
+    for (size_t i = 0; i < kMeasurementTypeCount; i++) {
+      if (static_cast<size_t>(kMeasurementInfo[i].type) != i) {
+        return false;
+      }
+    }
+    return true;
+  }
 
 };
+
+static_assert(Sensor::IsInfoInTypeOrder(), "Sensor::kMeasurementInfo must list the types in enum order");
@@ -14,6 +14,14 @@ class TemperatureSensor : public virtual Sensor {
 public:
     virtual ~TemperatureSensor() = default;
 
-    // Return-based method for temperature measurement
-    virtual std::optional<float> MeasureTemperature() = 0;
+    // One temperature reading in °C, taken with a full ReadMeasurements()
+    // transaction into a record on the stack
+    virtual std::optional<float> MeasureTemperature()
+    {
+        MeasurementRecord record;
+        if (!ReadMeasurements(record) || !record.Has(MeasurementType::Temperature)) {
+            return std::nullopt;
+        }
+        return (float)record.Get(MeasurementType::Temperature) / NativeScale(MeasurementType::Temperature);
+    }
 };
@@ -0,0 +1,726 @@
+#include "sensirion_i2c_hal_emulator.h"
+#include "../sen66_i2c.h"
+#include "../sensirion_common.h"
+#include "../sensirion_i2c.h"
+#include "../sensirion_i2c_hal.h"
+
+#include <string.h>
+
+/*
+ * See sensirion_i2c_hal_emulator.h. The emulated devices decode the same
+ * frames the drivers build (16-bit command, then CRC-protected argument
+ * words) and answer with CRC-protected response words, so a driver bug in
+ * framing or CRC handling shows up here exactly as on the bus.
+ */
+
+#define EMU_MAX_DEVICES 4
+#define EMU_MAX_BUSES 4
+#define EMU_MAX_RESPONSE_WORDS 16
+
+/* Mirror of the target HAL's retry policy (sensirion_i2c_hal.c), so failure
+ * handling costs the same virtual time as it does on the device. */
+#define EMU_MAX_ATTEMPTS 3
+#define EMU_RETRY_DELAY_US (2 * 1000)
+#define EMU_TXN_TIMEOUT_US (1000 * 1000)
+
+/* The target's RTOS tick (CONFIG_FREERTOS_HZ=100): sleeps of a tick or more
+ * block the task there, shorter ones busy-wait */
+#define EMU_TICK_US (10 * 1000)
+
+/* 9 clocks per byte at 100 kHz, plus the address byte */
+#define EMU_BYTE_TIME_US 90
+
+#define SEN66_SAMPLE_PERIOD_US (1000 * 1000)
+#define SCD30_DEFAULT_INTERVAL_S 2
+
+typedef enum { EMU_SEN66, EMU_SCD30 } emu_kind_t;
+
+typedef struct {
+    emu_kind_t kind;
+    uint8_t bus_idx;
+    uint8_t address;
+
+    bool measuring;
+    uint64_t measure_start_us;
+    uint32_t samples_read;     /* intervals already returned by a read */
+    uint64_t busy_until_us;    /* NACKs until the current command finishes */
+
+    uint8_t response[EMU_MAX_RESPONSE_WORDS * 3];
+    uint16_t response_len;
+
+    /* volatile configuration, reset by a device reset */
+    uint16_t altitude;
+    uint16_t ambient_pressure;
+    uint16_t asc_enabled;
+    uint16_t interval_s;       /* SCD30 only */
+    uint16_t temperature_offset;
+    uint16_t frc_reference;
+
+    uint8_t voc_state[8];
+    uint64_t voc_learned_us;   /* measuring time folded into voc_state */
+
+    const sensirion_emu_sample_t* trace;
+    size_t trace_len;
+
+    uint32_t pending_nacks;
+    uint32_t pending_timeouts;
+    bool unresponsive;
+    sensirion_emu_stats_t stats;
+} emu_device_t;
+
+static const sensirion_emu_sample_t s_default_sample = {
+    .pm1p0 = 32, .pm2p5 = 45, .pm4p0 = 51, .pm10p0 = 54,
+    .humidity = 4500, .temperature = 4300, .voc_index = 1000,
+    .nox_index = 10, .co2 = 650,
+};
+
+static emu_device_t s_devices[EMU_MAX_DEVICES];
+static size_t s_device_count = 0;
+static uint64_t s_now_us = 0;
+static uint64_t s_yielded_us = 0;
+static uint64_t s_spun_us = 0;
+static __thread uint8_t s_selected_bus = 0;
+
+static emu_device_t* emu_find(uint8_t bus_idx, uint8_t address) {
+    for (size_t i = 0; i < s_device_count; i++) {
+        if (s_devices[i].bus_idx == bus_idx &&
+            s_devices[i].address == address) {
+            return &s_devices[i];
+        }
+    }
+    return NULL;
+}
+
+static void emu_power_on(emu_device_t* dev) {
+    dev->measuring = false;
+    dev->samples_read = 0;
+    dev->response_len = 0;
+    dev->altitude = 0;
+    dev->ambient_pressure = 1013;
+    dev->asc_enabled = 1;
+    dev->interval_s = SCD30_DEFAULT_INTERVAL_S;
+    dev->temperature_offset = 0;
+    dev->frc_reference = 400;
+}
+
+static int emu_add(emu_kind_t kind, uint8_t bus_idx, uint8_t address) {
+    if (s_device_count == EMU_MAX_DEVICES || bus_idx >= EMU_MAX_BUSES ||
+        emu_find(bus_idx, address) != NULL) {
+        return -1;
+    }
+    emu_device_t* dev = &s_devices[s_device_count++];
+    memset(dev, 0, sizeof(*dev));
+    dev->kind = kind;
+    dev->bus_idx = bus_idx;
+    dev->address = address;
+    emu_power_on(dev);
+    return 0;
+}
+
+/* Folds the time measured since the last call into the VOC state, standing
+ * in for the algorithm's learning. */
+static void emu_update_voc_state(emu_device_t* dev) {
+    if (!dev->measuring) {
+        return;
+    }
+    uint64_t measured = s_now_us - dev->measure_start_us;
+    uint32_t seconds = (uint32_t)((measured - dev->voc_learned_us) / 1000000);
+    uint32_t learned_s = sensirion_common_bytes_to_uint32_t(&dev->voc_state[4]);
+    sensirion_common_uint32_t_to_bytes(learned_s + seconds, &dev->voc_state[4]);
+    dev->voc_learned_us += (uint64_t)seconds * 1000000;
+}
+
+/* Measurement intervals completed since measurement started. */
+static uint32_t emu_samples_available(const emu_device_t* dev) {
+    if (!dev->measuring) {
+        return 0;
+    }
+    uint64_t period_us = dev->kind == EMU_SEN66
+                             ? SEN66_SAMPLE_PERIOD_US
+                             : (uint64_t)dev->interval_s * 1000000;
+    return (uint32_t)((s_now_us - dev->measure_start_us) / period_us);
+}
+
+static const sensirion_emu_sample_t* emu_sample(const emu_device_t* dev,
+                                                uint32_t index) {
+    if (dev->trace == NULL || dev->trace_len == 0) {
+        return &s_default_sample;
+    }
+    return &dev->trace[index < dev->trace_len ? index : dev->trace_len - 1];
+}
+
+static void emu_respond(emu_device_t* dev, uint16_t word) {
+    uint8_t* p = &dev->response[dev->response_len];
+    p[0] = (uint8_t)(word >> 8);
+    p[1] = (uint8_t)word;
+    p[2] = sensirion_i2c_generate_crc(p, SENSIRION_WORD_SIZE);
+    dev->response_len += SENSIRION_WORD_SIZE + CRC8_LEN;
+}
+
+static void emu_respond_string(emu_device_t* dev, const char* text) {
+    char padded[32] = {0};
+    strncpy(padded, text, sizeof(padded) - 1);
+    for (size_t i = 0; i < sizeof(padded); i += 2) {
+        emu_respond(dev, (uint16_t)((uint8_t)padded[i] << 8 |
+                                    (uint8_t)padded[i + 1]));
+    }
+}
+
+static void emu_respond_float(emu_device_t* dev, float value) {
+    uint8_t bytes[4];
+    sensirion_common_float_to_bytes(value, bytes);
+    emu_respond(dev, sensirion_common_bytes_to_uint16_t(&bytes[0]));
+    emu_respond(dev, sensirion_common_bytes_to_uint16_t(&bytes[2]));
+}
+
+/* Executes one SEN66 command. Returns the execution time in microseconds,
+ * or -1 to NACK it (unknown, wrong argument count or not allowed in the
+ * current mode). */
+static int32_t emu_sen66_execute(emu_device_t* dev, uint16_t cmd,
+                                 const uint16_t* args, uint16_t num_args) {
+    const sensirion_emu_sample_t* sample;
+    bool get = num_args == 0;
+
+    switch (cmd) {
+    case SEN66_GET_VOC_ALGORITHM_TUNING_PARAMETERS_CMD_ID:
+        if (get) {
+            const uint16_t defaults[6] = {100, 12, 12, 180, 50, 230};
+            for (int i = 0; i < 6; i++) {
+                emu_respond(dev, defaults[i]);
+            }
+            return 20000;
+        }
+        return num_args == 6 && !dev->measuring ? 20000 : -1;
+
+    case SEN66_GET_NOX_ALGORITHM_TUNING_PARAMETERS_CMD_ID:
+        if (get) {
+            const uint16_t defaults[6] = {1, 12, 12, 720, 50, 230};
+            for (int i = 0; i < 6; i++) {
+                emu_respond(dev, defaults[i]);
+            }
+            return 20000;
+        }
+        return num_args == 6 && !dev->measuring ? 20000 : -1;
+
+    case SEN66_GET_VOC_ALGORITHM_STATE_CMD_ID:
+        if (get) {
+            emu_update_voc_state(dev);
+            for (int i = 0; i < 8; i += 2) {
+                emu_respond(dev, sensirion_common_bytes_to_uint16_t(
+                                     &dev->voc_state[i]));
+            }
+            return 20000;
+        }
+        if (num_args != 4 || dev->measuring) {
+            return -1;
+        }
+        for (int i = 0; i < 4; i++) {
+            sensirion_common_uint16_t_to_bytes(args[i], &dev->voc_state[i * 2]);
+        }
+        dev->voc_learned_us = 0;
+        return 20000;
+
+    case SEN66_PERFORM_FORCED_CO2_RECALIBRATION_CMD_ID:
+        if (num_args != 1 || dev->measuring) {
+            return -1;
+        }
+        emu_respond(dev, 0x8000); /* zero correction */
+        return 500000;
+
+    case SEN66_PERFORM_CO2_SENSOR_FACTORY_RESET_CMD_ID:
+        return dev->measuring ? -1 : 1400000;
+
+    case SEN66_GET_CO2_SENSOR_AUTOMATIC_SELF_CALIBRATION_CMD_ID:
+        if (get) {
+            emu_respond(dev, dev->asc_enabled);
+            return 20000;
+        }
+        if (num_args != 1 || dev->measuring) {
+            return -1;
+        }
+        dev->asc_enabled = args[0];
+        return 20000;
+
+    case SEN66_GET_AMBIENT_PRESSURE_CMD_ID:
+        if (get) {
+            emu_respond(dev, dev->ambient_pressure);
+            return 20000;
+        }
+        if (num_args != 1) {
+            return -1;
+        }
+        dev->ambient_pressure = args[0];
+        return 20000;
+
+    case SEN66_GET_SENSOR_ALTITUDE_CMD_ID:
+        if (get) {
+            emu_respond(dev, dev->altitude);
+            return 20000;
+        }
+        if (num_args != 1 || dev->measuring) {
+            return -1;
+        }
+        dev->altitude = args[0];
+        return 20000;
+
+    case SEN66_START_CONTINUOUS_MEASUREMENT_CMD_ID:
+        if (dev->measuring) {
+            return -1;
+        }
+        dev->measuring = true;
+        dev->measure_start_us = s_now_us;
+        dev->samples_read = 0;
+        dev->voc_learned_us = 0;
+        return 50000;
+
+    case SEN66_STOP_MEASUREMENT_CMD_ID:
+        if (!dev->measuring) {
+            return -1;
+        }
+        emu_update_voc_state(dev);
+        dev->measuring = false;
+        return 1400000;
+
+    case SEN66_GET_DATA_READY_CMD_ID:
+        emu_respond(dev, emu_samples_available(dev) > dev->samples_read);
+        return 20000;
+
+    case SEN66_READ_NUMBER_CONCENTRATION_VALUES_AS_INTEGERS_CMD_ID:
+        if (!dev->measuring) {
+            return -1;
+        }
+        sample = emu_sample(dev, emu_samples_available(dev));
+        /* particles/cm³ × 10, roughly proportional to the mass values */
+        emu_respond(dev, (uint16_t)(sample->pm1p0 * 7));
+        emu_respond(dev, (uint16_t)(sample->pm1p0 * 8));
+        emu_respond(dev, (uint16_t)(sample->pm2p5 * 8));
+        emu_respond(dev, (uint16_t)(sample->pm4p0 * 8));
+        emu_respond(dev, (uint16_t)(sample->pm10p0 * 8));
+        return 20000;
+
+    case SEN66_SET_TEMPERATURE_OFFSET_PARAMETERS_CMD_ID:
+    case SEN66_SET_TEMPERATURE_ACCELERATION_PARAMETERS_CMD_ID:
+        return num_args == 4 ? 20000 : -1;
+
+    case SEN66_GET_PRODUCT_TYPE_CMD_ID:
+        emu_respond_string(dev, "00080000");
+        return 20000;
+
+    case SEN66_GET_PRODUCT_NAME_CMD_ID:
+        emu_respond_string(dev, "SEN66");
+        return 20000;
+
+    case SEN66_GET_SERIAL_NUMBER_CMD_ID:
+        emu_respond_string(dev, "EMULATED0001");
+        return 20000;
+
+    case SEN66_READ_DEVICE_STATUS_CMD_ID:
+    case SEN66_READ_AND_CLEAR_DEVICE_STATUS_CMD_ID:
+        emu_respond(dev, 0);
+        emu_respond(dev, 0);
+        return 20000;
+
+    case SEN66_GET_VERSION_CMD_ID:
+        emu_respond(dev, 0x0400);
+        return 20000;
+
+    case SEN66_DEVICE_RESET_CMD_ID:
+        emu_power_on(dev);
+        return 1200000;
+
+    case SEN66_START_FAN_CLEANING_CMD_ID:
+        return dev->measuring ? 20000 : -1;
+
+    case SEN66_ACTIVATE_SHT_HEATER_CMD_ID:
+        return dev->measuring ? -1 : 20000;
+
+    case SEN66_GET_SHT_HEATER_MEASUREMENTS_CMD_ID:
+        sample = emu_sample(dev, 0);
+        emu_respond(dev, (uint16_t)sample->humidity);
+        emu_respond(dev, (uint16_t)(sample->temperature + 2000));
+        return 20000;
+
+    case SEN66_READ_MEASURED_VALUES_AS_INTEGERS_CMD_ID: {
+        if (!dev->measuring) {
+            return -1;
+        }
+        uint32_t available = emu_samples_available(dev);
+        if (available == 0) {
+            /* no measurement finished yet: everything reads "unknown" */
+            for (int i = 0; i < 4; i++) {
+                emu_respond(dev, 0xFFFF);
+            }
+            for (int i = 0; i < 4; i++) {
+                emu_respond(dev, 0x7FFF);
+            }
+            emu_respond(dev, 0xFFFF);
+            return 20000;
+        }
+        sample = emu_sample(dev, available - 1);
+        dev->samples_read = available;
+        emu_respond(dev, sample->pm1p0);
+        emu_respond(dev, sample->pm2p5);
+        emu_respond(dev, sample->pm4p0);
+        emu_respond(dev, sample->pm10p0);
+        emu_respond(dev, (uint16_t)sample->humidity);
+        emu_respond(dev, (uint16_t)sample->temperature);
+        emu_respond(dev, (uint16_t)sample->voc_index);
+        emu_respond(dev, (uint16_t)sample->nox_index);
+        emu_respond(dev, sample->co2);
+        return 20000;
+    }
+
+    case SEN66_READ_MEASURED_RAW_VALUES_CMD_ID:
+        if (!dev->measuring) {
+            return -1;
+        }
+        sample = emu_sample(dev, emu_samples_available(dev));
+        emu_respond(dev, (uint16_t)sample->humidity);
+        emu_respond(dev, (uint16_t)sample->temperature);
+        emu_respond(dev, 30000);
+        emu_respond(dev, 16000);
+        emu_respond(dev, sample->co2);
+        return 20000;
+
+    default:
+        return -1;
+    }
+}
+
+/* Executes one SCD30 command; same contract as emu_sen66_execute(). The
+ * SCD30 needs 3 ms between a command and reading its response. */
+static int32_t emu_scd30_execute(emu_device_t* dev, uint16_t cmd,
+                                 const uint16_t* args, uint16_t num_args) {
+    bool get = num_args == 0;
+
+    switch (cmd) {
+    case 0x0010: /* start periodic measurement */
+        if (num_args != 1) {
+            return -1;
+        }
+        if (!dev->measuring) {
+            dev->measuring = true;
+            dev->measure_start_us = s_now_us;
+            dev->samples_read = 0;
+        }
+        dev->ambient_pressure = args[0];
+        return 3000;
+
+    case 0x0104: /* stop periodic measurement */
+        dev->measuring = false;
+        return 3000;
+
+    case 0x4600: /* measurement interval */
+        if (get) {
+            emu_respond(dev, dev->interval_s);
+            return 3000;
+        }
+        if (num_args != 1 || args[0] < 2 || args[0] > 1800) {
+            return -1;
+        }
+        dev->interval_s = args[0];
+        return 3000;
+
+    case 0x0202: /* data ready */
+        emu_respond(dev, emu_samples_available(dev) > dev->samples_read);
+        return 3000;
+
+    case 0x0300: { /* read measurement */
+        uint32_t available = emu_samples_available(dev);
+        if (available == 0) {
+            return -1;
+        }
+        const sensirion_emu_sample_t* sample = emu_sample(dev, available - 1);
+        dev->samples_read = available;
+        emu_respond_float(dev, (float)sample->co2);
+        emu_respond_float(dev, sample->temperature / 200.0f);
+        emu_respond_float(dev, sample->humidity / 100.0f);
+        return 3000;
+    }
+
+    case 0x5306: /* automatic self-calibration */
+        if (get) {
+            emu_respond(dev, dev->asc_enabled);
+            return 3000;
+        }
+        if (num_args != 1) {
+            return -1;
+        }
+        dev->asc_enabled = args[0];
+        return 3000;
+
+    case 0x5204: /* forced recalibration reference */
+        if (get) {
+            emu_respond(dev, dev->frc_reference);
+            return 3000;
+        }
+        if (num_args != 1) {
+            return -1;
+        }
+        dev->frc_reference = args[0];
+        return 3000;
+
+    case 0x5403: /* temperature offset */
+        if (get) {
+            emu_respond(dev, dev->temperature_offset);
+            return 3000;
+        }
+        if (num_args != 1) {
+            return -1;
+        }
+        dev->temperature_offset = args[0];
+        return 3000;
+
+    case 0x5102: /* altitude compensation */
+        if (get) {
+            emu_respond(dev, dev->altitude);
+            return 3000;
+        }
+        if (num_args != 1) {
+            return -1;
+        }
+        dev->altitude = args[0];
+        return 3000;
+
+    case 0xd100: /* firmware version */
+        emu_respond(dev, 0x0342);
+        return 3000;
+
+    case 0xd304: /* soft reset */
+        emu_power_on(dev);
+        return 2000000;
+
+    default:
+        return -1;
+    }
+}
+
+/* One attempt at a transaction. Returns NO_ERROR, I2C_NACK_ERROR or
+ * I2C_BUS_ERROR (timeout); advances the clock by what it would cost. */
+static int8_t emu_transaction(emu_device_t* dev, bool is_read, uint8_t* data,
+                              const uint8_t* write_data, uint8_t count) {
+    if (dev != NULL && dev->pending_timeouts > 0) {
+        dev->pending_timeouts--;
+        dev->stats.timeouts++;
+        s_now_us += EMU_TXN_TIMEOUT_US;
+        return I2C_BUS_ERROR;
+    }
+
+    /* the address byte goes out before anyone can NACK it */
+    s_now_us += EMU_BYTE_TIME_US;
+    if (dev == NULL || dev->unresponsive || s_now_us < dev->busy_until_us) {
+        if (dev != NULL) {
+            dev->stats.nacks++;
+        }
+        return I2C_NACK_ERROR;
+    }
+    if (dev->pending_nacks > 0) {
+        dev->pending_nacks--;
+        dev->stats.nacks++;
+        return I2C_NACK_ERROR;
+    }
+    s_now_us += (uint64_t)count * EMU_BYTE_TIME_US;
+
+    if (is_read) {
+        dev->stats.reads++;
+        if (count > dev->response_len) {
+            dev->stats.nacks++;
+            return I2C_NACK_ERROR;
+        }
+        memcpy(data, dev->response, count);
+        dev->response_len = 0;
+        return NO_ERROR;
+    }
+
+    dev->stats.writes++;
+    dev->response_len = 0;
+    if (count < SENSIRION_COMMAND_SIZE ||
+        (count - SENSIRION_COMMAND_SIZE) % (SENSIRION_WORD_SIZE + CRC8_LEN)) {
+        dev->stats.nacks++;
+        return I2C_NACK_ERROR;
+    }
+
+    uint16_t cmd = (uint16_t)(write_data[0] << 8 | write_data[1]);
+    uint16_t args[EMU_MAX_RESPONSE_WORDS];
+    uint16_t num_args = (count - SENSIRION_COMMAND_SIZE) /
+                        (SENSIRION_WORD_SIZE + CRC8_LEN);
+    if (num_args > EMU_MAX_RESPONSE_WORDS) {
+        dev->stats.nacks++;
+        return I2C_NACK_ERROR;
+    }
+    for (uint16_t i = 0; i < num_args; i++) {
+        const uint8_t* word = &write_data[SENSIRION_COMMAND_SIZE + i * 3];
+        if (sensirion_i2c_generate_crc(word, SENSIRION_WORD_SIZE) != word[2]) {
+            dev->stats.crc_errors++;
+            dev->stats.nacks++;
+            return I2C_NACK_ERROR;
+        }
+        args[i] = (uint16_t)(word[0] << 8 | word[1]);
+    }
+
+    int32_t exec_us = dev->kind == EMU_SEN66
+                          ? emu_sen66_execute(dev, cmd, args, num_args)
+                          : emu_scd30_execute(dev, cmd, args, num_args);
+    if (exec_us < 0) {
+        dev->response_len = 0;
+        dev->stats.nacks++;
+        return I2C_NACK_ERROR;
+    }
+    dev->busy_until_us = s_now_us + (uint64_t)exec_us;
+    return NO_ERROR;
+}
+
+static int8_t emu_transfer(uint8_t address, bool is_read, uint8_t* data,
+                           const uint8_t* write_data, uint8_t count) {
+    emu_device_t* dev = emu_find(s_selected_bus, address);
+    int8_t status = I2C_NACK_ERROR;
+
+    for (uint8_t attempt = 1; attempt <= EMU_MAX_ATTEMPTS; attempt++) {
+        status = emu_transaction(dev, is_read, data, write_data, count);
+        if (status == NO_ERROR) {
+            return NO_ERROR;
+        }
+        if (attempt < EMU_MAX_ATTEMPTS) {
+            sensirion_i2c_hal_sleep_usec(EMU_RETRY_DELAY_US);
+        }
+    }
+    /* like the target HAL: a failed transfer is reported as a NACK, a
+     * missing device as a bus error */
+    return dev == NULL ? I2C_BUS_ERROR : I2C_NACK_ERROR;
+}
+
+int16_t sensirion_i2c_hal_select_bus(uint8_t bus_idx) {
+    if (bus_idx >= EMU_MAX_BUSES) {
+        return I2C_BUS_ERROR;
+    }
+    s_selected_bus = bus_idx;
+    return NO_ERROR;
+}
+
+int16_t sensirion_i2c_hal_attach(uint8_t address) {
+    return emu_find(s_selected_bus, address) != NULL ? NO_ERROR
+                                                     : I2C_BUS_ERROR;
+}
+
+void sensirion_i2c_hal_init(void) {
+}
+
+void sensirion_i2c_hal_free(void) {
+}
+
+int8_t sensirion_i2c_hal_read(uint8_t address, uint8_t* data, uint8_t count) {
+    return emu_transfer(address, true, data, NULL, count);
+}
+
+int8_t sensirion_i2c_hal_write(uint8_t address, const uint8_t* data,
+                               uint8_t count) {
+    return emu_transfer(address, false, NULL, data, count);
+}
+
+void sensirion_i2c_hal_sleep_usec(uint32_t useconds) {
+    /* the clock advances by exactly the request; only the accounting
+     * follows the target's split */
+    s_now_us += useconds;
+    if (useconds >= EMU_TICK_US) {
+        s_yielded_us += useconds;
+    } else {
+        s_spun_us += useconds;
+    }
+}
+
+void sensirion_i2c_hal_get_sleep_stats(uint64_t* yielded_us,
+                                       uint64_t* spun_us) {
+    *yielded_us = s_yielded_us;
+    *spun_us = s_spun_us;
+}
+
+void sensirion_emu_reset(void) {
+    memset(s_devices, 0, sizeof(s_devices));
+    s_device_count = 0;
+    s_now_us = 0;
+    s_yielded_us = 0;
+    s_spun_us = 0;
+    s_selected_bus = 0;
+}
+
+int sensirion_emu_add_sen66(uint8_t bus_idx, uint8_t address) {
+    return emu_add(EMU_SEN66, bus_idx, address);
+}
+
+int sensirion_emu_add_scd30(uint8_t bus_idx, uint8_t address) {
+    return emu_add(EMU_SCD30, bus_idx, address);
+}
+
+void sensirion_emu_set_trace(uint8_t bus_idx, uint8_t address,
+                             const sensirion_emu_sample_t* samples,
+                             size_t count) {
+    emu_device_t* dev = emu_find(bus_idx, address);
+    if (dev != NULL) {
+        dev->trace = samples;
+        dev->trace_len = count;
+    }
+}
+
+void sensirion_emu_inject_nacks(uint8_t bus_idx, uint8_t address,
+                                uint32_t count) {
+    emu_device_t* dev = emu_find(bus_idx, address);
+    if (dev != NULL) {
+        dev->pending_nacks += count;
+    }
+}
+
+void sensirion_emu_inject_timeouts(uint8_t bus_idx, uint8_t address,
+                                   uint32_t count) {
+    emu_device_t* dev = emu_find(bus_idx, address);
+    if (dev != NULL) {
+        dev->pending_timeouts += count;
+    }
+}
+
+void sensirion_emu_set_unresponsive(uint8_t bus_idx, uint8_t address,
+                                    bool unresponsive) {
+    emu_device_t* dev = emu_find(bus_idx, address);
+    if (dev != NULL) {
+        dev->unresponsive = unresponsive;
+    }
+}
+
+int sensirion_emu_get_voc_state(uint8_t bus_idx, uint8_t address,
+                                uint8_t* state) {
+    emu_device_t* dev = emu_find(bus_idx, address);
+    if (dev == NULL || dev->kind != EMU_SEN66) {
+        return -1;
+    }
+    emu_update_voc_state(dev);
+    memcpy(state, dev->voc_state, sizeof(dev->voc_state));
+    return 0;
+}
+
+int sensirion_emu_set_voc_state(uint8_t bus_idx, uint8_t address,
+                                const uint8_t* state) {
+    emu_device_t* dev = emu_find(bus_idx, address);
+    if (dev == NULL || dev->kind != EMU_SEN66) {
+        return -1;
+    }
+    memcpy(dev->voc_state, state, sizeof(dev->voc_state));
+    dev->voc_learned_us = dev->measuring ? s_now_us - dev->measure_start_us : 0;
+    return 0;
+}
+
+int sensirion_emu_get_stats(uint8_t bus_idx, uint8_t address,
+                            sensirion_emu_stats_t* stats) {
+    emu_device_t* dev = emu_find(bus_idx, address);
+    if (dev == NULL) {
+        return -1;
+    }
+    *stats = dev->stats;
+    return 0;
+}
+
+uint64_t sensirion_emu_now_us(void) {
+    return s_now_us;
+}
+
+void sensirion_emu_advance_us(uint64_t useconds) {
+    s_now_us += useconds;
+}
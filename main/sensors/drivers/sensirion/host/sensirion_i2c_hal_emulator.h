@@ -0,0 +1,102 @@
+#ifndef SENSIRION_I2C_HAL_EMULATOR_H
+#define SENSIRION_I2C_HAL_EMULATOR_H
+
+/*
+ * Host-side implementation of sensirion_i2c_hal.h that emulates SEN66 and
+ * SCD30 sensors instead of talking to a bus, so the Sensirion drivers and the
+ * code built on them can run on a Linux machine.
+ *
+ * Time is virtual: sensirion_i2c_hal_sleep_usec() and every transaction
+ * advance an emulated clock instead of waiting, so a run is deterministic and
+ * as fast as the host allows. Each transaction costs its 100 kHz wire time,
+ * and a command keeps the device busy (NACKing) for its documented execution
+ * time, as on the real part.
+ *
+ * Not part of the firmware build; the component only compiles the
+ * directories listed in main/CMakeLists.txt. host_test/CMakeLists.txt builds
+ * it with the drivers as the sensirion_emulated library, and
+ * host_test/SensirionEmulatorTest.cpp shows how to drive it.
+ */
+
+#include "../sensirion_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* One scripted measurement, in the SEN66 integer encoding. The SCD30 uses
+ * co2, humidity and temperature. Unavailable values use 0xFFFF (unsigned)
+ * or 0x7FFF (signed), as the SEN66 itself reports them. */
+typedef struct {
+    uint16_t pm1p0;       /* µg/m³ × 10 */
+    uint16_t pm2p5;       /* µg/m³ × 10 */
+    uint16_t pm4p0;       /* µg/m³ × 10 */
+    uint16_t pm10p0;      /* µg/m³ × 10 */
+    int16_t humidity;     /* %RH × 100 */
+    int16_t temperature;  /* °C × 200 */
+    int16_t voc_index;    /* index × 10 */
+    int16_t nox_index;    /* index × 10 */
+    uint16_t co2;         /* ppm */
+} sensirion_emu_sample_t;
+
+typedef struct {
+    uint32_t writes;
+    uint32_t reads;
+    uint32_t nacks;       /* busy, unsupported, injected or wrong CRC */
+    uint32_t timeouts;    /* injected */
+    uint32_t crc_errors;  /* commands received with a bad argument CRC */
+} sensirion_emu_stats_t;
+
+/* Removes all emulated devices and rewinds the clock to zero. */
+void sensirion_emu_reset(void);
+
+/* Adds an emulated sensor at (bus, address), idle and with default
+ * configuration, as after power-up. Returns 0, or -1 if the table is full or
+ * the slot is taken. */
+int sensirion_emu_add_sen66(uint8_t bus_idx, uint8_t address);
+int sensirion_emu_add_scd30(uint8_t bus_idx, uint8_t address);
+
+/* Scripts the measurements: sample i is what the sensor produces during its
+ * i-th measurement interval after measurement starts. Past the end the last
+ * sample is held. The array must outlive the emulation. Without a trace the
+ * sensor reports a constant indoor reading. */
+void sensirion_emu_set_trace(uint8_t bus_idx, uint8_t address,
+                             const sensirion_emu_sample_t* samples,
+                             size_t count);
+
+/* The next count transactions to the device are NACKed. */
+void sensirion_emu_inject_nacks(uint8_t bus_idx, uint8_t address,
+                                uint32_t count);
+
+/* The next count transactions to the device fail after the HAL's
+ * per-attempt timeout of virtual time, like a stuck bus. */
+void sensirion_emu_inject_timeouts(uint8_t bus_idx, uint8_t address,
+                                   uint32_t count);
+
+/* While set, every transaction to the device is NACKed, as if unplugged. */
+void sensirion_emu_set_unresponsive(uint8_t bus_idx, uint8_t address,
+                                    bool unresponsive);
+
+/* VOC algorithm state held by an emulated SEN66 (8 bytes). It advances
+ * while the sensor measures, so savers see it change. Return 0, or -1 if
+ * there is no SEN66 at (bus, address). */
+int sensirion_emu_get_voc_state(uint8_t bus_idx, uint8_t address,
+                                uint8_t* state);
+int sensirion_emu_set_voc_state(uint8_t bus_idx, uint8_t address,
+                                const uint8_t* state);
+
+/* Returns 0, or -1 if there is no device at (bus, address). */
+int sensirion_emu_get_stats(uint8_t bus_idx, uint8_t address,
+                            sensirion_emu_stats_t* stats);
+
+/* The emulated clock, in microseconds since sensirion_emu_reset(). */
+uint64_t sensirion_emu_now_us(void);
+
+/* Lets virtual time pass, e.g. between two acquisition cycles. */
+void sensirion_emu_advance_us(uint64_t useconds);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SENSIRION_I2C_HAL_EMULATOR_H */
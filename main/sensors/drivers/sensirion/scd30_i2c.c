@@ -44,10 +44,13 @@
 
 #define sensirion_hal_sleep_us sensirion_i2c_hal_sleep_usec
 
-static uint8_t _i2c_address;
-
-void scd30_init(uint8_t i2c_address) {
-    _i2c_address = i2c_address;
+/* The SCD30 only answers at 0x61, so commands address it directly and the
+ * per-bus handle lives in the HAL device table; the driver keeps no state. */
+int16_t scd30_init(uint8_t i2c_address) {
+    if (i2c_address != SCD30_I2C_ADDR_61) {
+        return NOT_IMPLEMENTED_ERROR;
+    }
+    return sensirion_i2c_hal_attach(i2c_address);
 }
 
 int16_t scd30_await_data_ready() {
@@ -89,7 +92,7 @@ int16_t scd30_start_periodic_measurement(uint16_t ambient_pressure) {
     local_offset = sensirion_i2c_add_uint16_t_to_buffer(
         local_buffer, local_offset, ambient_pressure);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, local_buffer, local_offset);
+        sensirion_i2c_write_data(SCD30_I2C_ADDR_61, local_buffer, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -103,7 +106,7 @@ int16_t scd30_stop_periodic_measurement() {
     local_offset =
         sensirion_i2c_add_command_to_buffer(local_buffer, local_offset, 0x104);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, local_buffer, local_offset);
+        sensirion_i2c_write_data(SCD30_I2C_ADDR_61, local_buffer, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -120,7 +123,7 @@ int16_t scd30_set_measurement_interval(uint16_t interval) {
     local_offset = sensirion_i2c_add_uint16_t_to_buffer(local_buffer,
                                                         local_offset, interval);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, local_buffer, local_offset);
+        sensirion_i2c_write_data(SCD30_I2C_ADDR_61, local_buffer, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -135,13 +138,13 @@ int16_t scd30_get_measurement_interval(uint16_t* interval) {
     local_offset =
         sensirion_i2c_add_command_to_buffer(local_buffer, local_offset, 0x4600);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, local_buffer, local_offset);
+        sensirion_i2c_write_data(SCD30_I2C_ADDR_61, local_buffer, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(10 * 1000);
     local_error =
-        sensirion_i2c_read_data_inplace(_i2c_address, local_buffer, 2);
+        sensirion_i2c_read_data_inplace(SCD30_I2C_ADDR_61, local_buffer, 2);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -156,13 +159,13 @@ int16_t scd30_get_data_ready(uint16_t* data_ready_flag) {
     local_offset =
         sensirion_i2c_add_command_to_buffer(local_buffer, local_offset, 0x202);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, local_buffer, local_offset);
+        sensirion_i2c_write_data(SCD30_I2C_ADDR_61, local_buffer, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(10 * 1000);
     local_error =
-        sensirion_i2c_read_data_inplace(_i2c_address, local_buffer, 2);
+        sensirion_i2c_read_data_inplace(SCD30_I2C_ADDR_61, local_buffer, 2);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -178,13 +181,13 @@ int16_t scd30_read_measurement_data(float* co2_concentration,
     local_offset =
         sensirion_i2c_add_command_to_buffer(local_buffer, local_offset, 0x300);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, local_buffer, local_offset);
+        sensirion_i2c_write_data(SCD30_I2C_ADDR_61, local_buffer, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(10 * 1000);
     local_error =
-        sensirion_i2c_read_data_inplace(_i2c_address, local_buffer, 12);
+        sensirion_i2c_read_data_inplace(SCD30_I2C_ADDR_61, local_buffer, 12);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -203,7 +206,7 @@ int16_t scd30_activate_auto_calibration(uint16_t do_activate) {
     local_offset = sensirion_i2c_add_uint16_t_to_buffer(
         local_buffer, local_offset, do_activate);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, local_buffer, local_offset);
+        sensirion_i2c_write_data(SCD30_I2C_ADDR_61, local_buffer, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -218,13 +221,13 @@ int16_t scd30_get_auto_calibration_status(uint16_t* is_active) {
     local_offset =
         sensirion_i2c_add_command_to_buffer(local_buffer, local_offset, 0x5306);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, local_buffer, local_offset);
+        sensirion_i2c_write_data(SCD30_I2C_ADDR_61, local_buffer, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(10 * 1000);
     local_error =
-        sensirion_i2c_read_data_inplace(_i2c_address, local_buffer, 2);
+        sensirion_i2c_read_data_inplace(SCD30_I2C_ADDR_61, local_buffer, 2);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -241,7 +244,7 @@ int16_t scd30_force_recalibration(uint16_t co2_ref_concentration) {
     local_offset = sensirion_i2c_add_uint16_t_to_buffer(
         local_buffer, local_offset, co2_ref_concentration);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, local_buffer, local_offset);
+        sensirion_i2c_write_data(SCD30_I2C_ADDR_61, local_buffer, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -256,13 +259,13 @@ int16_t scd30_get_force_recalibration_status(uint16_t* co2_ref_concentration) {
     local_offset =
         sensirion_i2c_add_command_to_buffer(local_buffer, local_offset, 0x5204);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, local_buffer, local_offset);
+        sensirion_i2c_write_data(SCD30_I2C_ADDR_61, local_buffer, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(10 * 1000);
     local_error =
-        sensirion_i2c_read_data_inplace(_i2c_address, local_buffer, 2);
+        sensirion_i2c_read_data_inplace(SCD30_I2C_ADDR_61, local_buffer, 2);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -280,7 +283,7 @@ int16_t scd30_set_temperature_offset(uint16_t temperature_offset) {
     local_offset = sensirion_i2c_add_uint16_t_to_buffer(
         local_buffer, local_offset, temperature_offset);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, local_buffer, local_offset);
+        sensirion_i2c_write_data(SCD30_I2C_ADDR_61, local_buffer, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -295,13 +298,13 @@ int16_t scd30_get_temperature_offset(uint16_t* temperature_offset) {
     local_offset =
         sensirion_i2c_add_command_to_buffer(local_buffer, local_offset, 0x5403);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, local_buffer, local_offset);
+        sensirion_i2c_write_data(SCD30_I2C_ADDR_61, local_buffer, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(10 * 1000);
     local_error =
-        sensirion_i2c_read_data_inplace(_i2c_address, local_buffer, 2);
+        sensirion_i2c_read_data_inplace(SCD30_I2C_ADDR_61, local_buffer, 2);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -316,13 +319,13 @@ int16_t scd30_get_altitude_compensation(uint16_t* altitude) {
     local_offset =
         sensirion_i2c_add_command_to_buffer(local_buffer, local_offset, 0x5102);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, local_buffer, local_offset);
+        sensirion_i2c_write_data(SCD30_I2C_ADDR_61, local_buffer, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(10 * 1000);
     local_error =
-        sensirion_i2c_read_data_inplace(_i2c_address, local_buffer, 2);
+        sensirion_i2c_read_data_inplace(SCD30_I2C_ADDR_61, local_buffer, 2);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -339,7 +342,7 @@ int16_t scd30_set_altitude_compensation(uint16_t altitude) {
     local_offset = sensirion_i2c_add_uint16_t_to_buffer(local_buffer,
                                                         local_offset, altitude);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, local_buffer, local_offset);
+        sensirion_i2c_write_data(SCD30_I2C_ADDR_61, local_buffer, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -354,13 +357,13 @@ int16_t scd30_read_firmware_version(uint8_t* major, uint8_t* minor) {
     local_offset =
         sensirion_i2c_add_command_to_buffer(local_buffer, local_offset, 0xd100);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, local_buffer, local_offset);
+        sensirion_i2c_write_data(SCD30_I2C_ADDR_61, local_buffer, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(10 * 1000);
     local_error =
-        sensirion_i2c_read_data_inplace(_i2c_address, local_buffer, 2);
+        sensirion_i2c_read_data_inplace(SCD30_I2C_ADDR_61, local_buffer, 2);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -376,7 +379,7 @@ int16_t scd30_soft_reset() {
     local_offset =
         sensirion_i2c_add_command_to_buffer(local_buffer, local_offset, 0xd304);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, local_buffer, local_offset);
+        sensirion_i2c_write_data(SCD30_I2C_ADDR_61, local_buffer, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
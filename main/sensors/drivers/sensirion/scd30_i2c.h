@@ -66,12 +66,13 @@ typedef enum {
 } cmd_id_t;
 
 /**
- * @brief Initialize i2c address of driver
+ * @brief Attach the sensor on the currently selected bus
  *
- * @param[in] i2c_address Used i2c address
+ * @param[in] i2c_address Used i2c address; must be SCD30_I2C_ADDR_61
  *
+ * @return error_code 0 on success, an error code otherwise.
  */
-void scd30_init(uint8_t i2c_address);
+int16_t scd30_init(uint8_t i2c_address);
 
 /**
  * @brief Poll the data ready flag.
@@ -43,12 +43,18 @@
 
 #define sensirion_hal_sleep_us sensirion_i2c_hal_sleep_usec
 
-static uint8_t communication_buffer[48] = {0};
+/* Largest frame of any SEN66 command. Each command builds its frame in a
+ * buffer on the caller's stack rather than a shared static one, so commands
+ * issued from different tasks cannot clobber each other's frames. */
+#define SEN66_COMMUNICATION_BUFFER_SIZE 48
 
-static uint8_t _i2c_address;
-
-void sen66_init(uint8_t i2c_address) {
-    _i2c_address = i2c_address;
+/* The SEN66 only answers at 0x6B, so commands address it directly and the
+ * per-bus handle lives in the HAL device table; the driver keeps no state. */
+int16_t sen66_init(uint8_t i2c_address) {
+    if (i2c_address != SEN66_I2C_ADDR_6B) {
+        return NOT_IMPLEMENTED_ERROR;
+    }
+    return sensirion_i2c_hal_attach(i2c_address);
 }
 
 int16_t sen66_get_voc_algorithm_tuning_parameters(
@@ -56,6 +62,7 @@ int16_t sen66_get_voc_algorithm_tuning_parameters(
     int16_t* learning_time_gain_hours, int16_t* gating_max_duration_minutes,
     int16_t* std_initial, int16_t* gain_factor) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
@@ -63,12 +70,13 @@ int16_t sen66_get_voc_algorithm_tuning_parameters(
         buffer_ptr, local_offset,
         SEN66_GET_VOC_ALGORITHM_TUNING_PARAMETERS_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(20 * 1000);
-    local_error = sensirion_i2c_read_data_inplace(_i2c_address, buffer_ptr, 12);
+    local_error =
+        sensirion_i2c_read_data_inplace(SEN66_I2C_ADDR_6B, buffer_ptr, 12);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -89,6 +97,7 @@ int16_t sen66_set_voc_algorithm_tuning_parameters(
     int16_t learning_time_gain_hours, int16_t gating_max_duration_minutes,
     int16_t std_initial, int16_t gain_factor) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
@@ -108,7 +117,7 @@ int16_t sen66_set_voc_algorithm_tuning_parameters(
     local_offset = sensirion_i2c_add_int16_t_to_buffer(buffer_ptr, local_offset,
                                                        gain_factor);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -118,18 +127,20 @@ int16_t sen66_set_voc_algorithm_tuning_parameters(
 
 int16_t sen66_get_voc_algorithm_state(uint8_t* state, uint16_t state_size) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
     local_offset = sensirion_i2c_add_command16_to_buffer(
         buffer_ptr, local_offset, SEN66_GET_VOC_ALGORITHM_STATE_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(20 * 1000);
-    local_error = sensirion_i2c_read_data_inplace(_i2c_address, buffer_ptr, 8);
+    local_error =
+        sensirion_i2c_read_data_inplace(SEN66_I2C_ADDR_6B, buffer_ptr, 8);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -140,6 +151,7 @@ int16_t sen66_get_voc_algorithm_state(uint8_t* state, uint16_t state_size) {
 int16_t sen66_set_voc_algorithm_state(const uint8_t* state,
                                       uint16_t state_size) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
@@ -149,7 +161,7 @@ int16_t sen66_set_voc_algorithm_state(const uint8_t* state,
                                                      state, state_size);
 
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -161,6 +173,7 @@ int16_t sen66_get_nox_algorithm_tuning_parameters(
     int16_t* learning_time_gain_hours, int16_t* gating_max_duration_minutes,
     int16_t* std_initial, int16_t* gain_factor) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
@@ -168,12 +181,13 @@ int16_t sen66_get_nox_algorithm_tuning_parameters(
         buffer_ptr, local_offset,
         SEN66_GET_NOX_ALGORITHM_TUNING_PARAMETERS_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(20 * 1000);
-    local_error = sensirion_i2c_read_data_inplace(_i2c_address, buffer_ptr, 12);
+    local_error =
+        sensirion_i2c_read_data_inplace(SEN66_I2C_ADDR_6B, buffer_ptr, 12);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -194,6 +208,7 @@ int16_t sen66_set_nox_algorithm_tuning_parameters(
     int16_t learning_time_gain_hours, int16_t gating_max_duration_minutes,
     int16_t std_initial, int16_t gain_factor) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
@@ -213,7 +228,7 @@ int16_t sen66_set_nox_algorithm_tuning_parameters(
     local_offset = sensirion_i2c_add_int16_t_to_buffer(buffer_ptr, local_offset,
                                                        gain_factor);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -225,6 +240,7 @@ int16_t
 sen66_perform_forced_co2_recalibration(uint16_t target_co2_concentration,
                                        uint16_t* correction) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
@@ -234,12 +250,13 @@ sen66_perform_forced_co2_recalibration(uint16_t target_co2_concentration,
     local_offset = sensirion_i2c_add_uint16_t_to_buffer(
         buffer_ptr, local_offset, target_co2_concentration);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(500 * 1000);
-    local_error = sensirion_i2c_read_data_inplace(_i2c_address, buffer_ptr, 2);
+    local_error =
+        sensirion_i2c_read_data_inplace(SEN66_I2C_ADDR_6B, buffer_ptr, 2);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -249,6 +266,7 @@ sen66_perform_forced_co2_recalibration(uint16_t target_co2_concentration,
 
 int16_t sen66_perform_co2_sensor_factory_reset(void) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
@@ -256,7 +274,7 @@ int16_t sen66_perform_co2_sensor_factory_reset(void) {
         buffer_ptr, local_offset,
         SEN66_PERFORM_CO2_SENSOR_FACTORY_RESET_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -267,6 +285,7 @@ int16_t sen66_perform_co2_sensor_factory_reset(void) {
 int16_t sen66_get_co2_sensor_automatic_self_calibration(uint8_t* padding,
                                                         bool* status) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
@@ -274,12 +293,13 @@ int16_t sen66_get_co2_sensor_automatic_self_calibration(uint8_t* padding,
         buffer_ptr, local_offset,
         SEN66_GET_CO2_SENSOR_AUTOMATIC_SELF_CALIBRATION_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(20 * 1000);
-    local_error = sensirion_i2c_read_data_inplace(_i2c_address, buffer_ptr, 2);
+    local_error =
+        sensirion_i2c_read_data_inplace(SEN66_I2C_ADDR_6B, buffer_ptr, 2);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -290,6 +310,7 @@ int16_t sen66_get_co2_sensor_automatic_self_calibration(uint8_t* padding,
 
 int16_t sen66_set_co2_sensor_automatic_self_calibration(uint16_t status) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
@@ -299,7 +320,7 @@ int16_t sen66_set_co2_sensor_automatic_self_calibration(uint16_t status) {
     local_offset =
         sensirion_i2c_add_uint16_t_to_buffer(buffer_ptr, local_offset, status);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -309,18 +330,20 @@ int16_t sen66_set_co2_sensor_automatic_self_calibration(uint16_t status) {
 
 int16_t sen66_get_ambient_pressure(uint16_t* ambient_pressure) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
     local_offset = sensirion_i2c_add_command16_to_buffer(
         buffer_ptr, local_offset, SEN66_GET_AMBIENT_PRESSURE_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(20 * 1000);
-    local_error = sensirion_i2c_read_data_inplace(_i2c_address, buffer_ptr, 2);
+    local_error =
+        sensirion_i2c_read_data_inplace(SEN66_I2C_ADDR_6B, buffer_ptr, 2);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -330,6 +353,7 @@ int16_t sen66_get_ambient_pressure(uint16_t* ambient_pressure) {
 
 int16_t sen66_set_ambient_pressure(uint16_t ambient_pressure) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
@@ -338,7 +362,7 @@ int16_t sen66_set_ambient_pressure(uint16_t ambient_pressure) {
     local_offset = sensirion_i2c_add_uint16_t_to_buffer(
         buffer_ptr, local_offset, ambient_pressure);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -348,18 +372,20 @@ int16_t sen66_set_ambient_pressure(uint16_t ambient_pressure) {
 
 int16_t sen66_get_sensor_altitude(uint16_t* altitude) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
     local_offset = sensirion_i2c_add_command16_to_buffer(
         buffer_ptr, local_offset, SEN66_GET_SENSOR_ALTITUDE_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(20 * 1000);
-    local_error = sensirion_i2c_read_data_inplace(_i2c_address, buffer_ptr, 2);
+    local_error =
+        sensirion_i2c_read_data_inplace(SEN66_I2C_ADDR_6B, buffer_ptr, 2);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -369,6 +395,7 @@ int16_t sen66_get_sensor_altitude(uint16_t* altitude) {
 
 int16_t sen66_set_sensor_altitude(uint16_t altitude) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
@@ -377,7 +404,7 @@ int16_t sen66_set_sensor_altitude(uint16_t altitude) {
     local_offset = sensirion_i2c_add_uint16_t_to_buffer(buffer_ptr,
                                                         local_offset, altitude);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -387,13 +414,14 @@ int16_t sen66_set_sensor_altitude(uint16_t altitude) {
 
 int16_t sen66_start_continuous_measurement(void) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
     local_offset = sensirion_i2c_add_command16_to_buffer(
         buffer_ptr, local_offset, SEN66_START_CONTINUOUS_MEASUREMENT_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -403,13 +431,14 @@ int16_t sen66_start_continuous_measurement(void) {
 
 int16_t sen66_stop_measurement(void) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
     local_offset = sensirion_i2c_add_command16_to_buffer(
         buffer_ptr, local_offset, SEN66_STOP_MEASUREMENT_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -419,18 +448,20 @@ int16_t sen66_stop_measurement(void) {
 
 int16_t sen66_get_data_ready(uint8_t* padding, bool* data_ready) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
     local_offset = sensirion_i2c_add_command16_to_buffer(
         buffer_ptr, local_offset, SEN66_GET_DATA_READY_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(20 * 1000);
-    local_error = sensirion_i2c_read_data_inplace(_i2c_address, buffer_ptr, 2);
+    local_error =
+        sensirion_i2c_read_data_inplace(SEN66_I2C_ADDR_6B, buffer_ptr, 2);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -444,6 +475,7 @@ int16_t sen66_read_number_concentration_values_as_integers(
     uint16_t* number_concentration_pm2p5, uint16_t* number_concentration_pm4p0,
     uint16_t* number_concentration_pm10p0) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
@@ -451,12 +483,13 @@ int16_t sen66_read_number_concentration_values_as_integers(
         buffer_ptr, local_offset,
         SEN66_READ_NUMBER_CONCENTRATION_VALUES_AS_INTEGERS_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(20 * 1000);
-    local_error = sensirion_i2c_read_data_inplace(_i2c_address, buffer_ptr, 10);
+    local_error =
+        sensirion_i2c_read_data_inplace(SEN66_I2C_ADDR_6B, buffer_ptr, 10);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -477,6 +510,7 @@ int16_t sen66_set_temperature_offset_parameters(int16_t offset, int16_t slope,
                                                 uint16_t time_constant,
                                                 uint16_t slot) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
@@ -492,7 +526,7 @@ int16_t sen66_set_temperature_offset_parameters(int16_t offset, int16_t slope,
     local_offset =
         sensirion_i2c_add_uint16_t_to_buffer(buffer_ptr, local_offset, slot);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -504,6 +538,7 @@ int16_t sen66_set_temperature_acceleration_parameters(uint16_t k, uint16_t p,
                                                       uint16_t t1,
                                                       uint16_t t2) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
@@ -519,7 +554,7 @@ int16_t sen66_set_temperature_acceleration_parameters(uint16_t k, uint16_t p,
     local_offset =
         sensirion_i2c_add_uint16_t_to_buffer(buffer_ptr, local_offset, t2);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -530,18 +565,20 @@ int16_t sen66_set_temperature_acceleration_parameters(uint16_t k, uint16_t p,
 int16_t sen66_get_product_type(int8_t* product_type,
                                uint16_t product_type_size) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
     local_offset = sensirion_i2c_add_command16_to_buffer(
         buffer_ptr, local_offset, SEN66_GET_PRODUCT_TYPE_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(20 * 1000);
-    local_error = sensirion_i2c_read_data_inplace(_i2c_address, buffer_ptr, 32);
+    local_error =
+        sensirion_i2c_read_data_inplace(SEN66_I2C_ADDR_6B, buffer_ptr, 32);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -553,18 +590,20 @@ int16_t sen66_get_product_type(int8_t* product_type,
 int16_t sen66_get_product_name(int8_t* product_name,
                                uint16_t product_name_size) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
     local_offset = sensirion_i2c_add_command16_to_buffer(
         buffer_ptr, local_offset, SEN66_GET_PRODUCT_NAME_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(20 * 1000);
-    local_error = sensirion_i2c_read_data_inplace(_i2c_address, buffer_ptr, 32);
+    local_error =
+        sensirion_i2c_read_data_inplace(SEN66_I2C_ADDR_6B, buffer_ptr, 32);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -576,18 +615,20 @@ int16_t sen66_get_product_name(int8_t* product_name,
 int16_t sen66_get_serial_number(int8_t* serial_number,
                                 uint16_t serial_number_size) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
     local_offset = sensirion_i2c_add_command16_to_buffer(
         buffer_ptr, local_offset, SEN66_GET_SERIAL_NUMBER_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(20 * 1000);
-    local_error = sensirion_i2c_read_data_inplace(_i2c_address, buffer_ptr, 32);
+    local_error =
+        sensirion_i2c_read_data_inplace(SEN66_I2C_ADDR_6B, buffer_ptr, 32);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -598,18 +639,20 @@ int16_t sen66_get_serial_number(int8_t* serial_number,
 
 int16_t sen66_read_device_status(sen66_device_status* device_status) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
     local_offset = sensirion_i2c_add_command16_to_buffer(
         buffer_ptr, local_offset, SEN66_READ_DEVICE_STATUS_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(20 * 1000);
-    local_error = sensirion_i2c_read_data_inplace(_i2c_address, buffer_ptr, 4);
+    local_error =
+        sensirion_i2c_read_data_inplace(SEN66_I2C_ADDR_6B, buffer_ptr, 4);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -619,18 +662,20 @@ int16_t sen66_read_device_status(sen66_device_status* device_status) {
 
 int16_t sen66_read_and_clear_device_status(sen66_device_status* device_status) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
     local_offset = sensirion_i2c_add_command16_to_buffer(
         buffer_ptr, local_offset, SEN66_READ_AND_CLEAR_DEVICE_STATUS_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(20 * 1000);
-    local_error = sensirion_i2c_read_data_inplace(_i2c_address, buffer_ptr, 4);
+    local_error =
+        sensirion_i2c_read_data_inplace(SEN66_I2C_ADDR_6B, buffer_ptr, 4);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -640,18 +685,20 @@ int16_t sen66_read_and_clear_device_status(sen66_device_status* device_status) {
 
 int16_t sen66_get_version(uint8_t* firmware_major, uint8_t* firmware_minor) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
     local_offset = sensirion_i2c_add_command16_to_buffer(
         buffer_ptr, local_offset, SEN66_GET_VERSION_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(20 * 1000);
-    local_error = sensirion_i2c_read_data_inplace(_i2c_address, buffer_ptr, 2);
+    local_error =
+        sensirion_i2c_read_data_inplace(SEN66_I2C_ADDR_6B, buffer_ptr, 2);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -662,13 +709,14 @@ int16_t sen66_get_version(uint8_t* firmware_major, uint8_t* firmware_minor) {
 
 int16_t sen66_device_reset(void) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
     local_offset = sensirion_i2c_add_command16_to_buffer(
         buffer_ptr, local_offset, SEN66_DEVICE_RESET_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -678,13 +726,14 @@ int16_t sen66_device_reset(void) {
 
 int16_t sen66_start_fan_cleaning(void) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
     local_offset = sensirion_i2c_add_command16_to_buffer(
         buffer_ptr, local_offset, SEN66_START_FAN_CLEANING_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -694,13 +743,14 @@ int16_t sen66_start_fan_cleaning(void) {
 
 int16_t sen66_activate_sht_heater(void) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
     local_offset = sensirion_i2c_add_command16_to_buffer(
         buffer_ptr, local_offset, SEN66_ACTIVATE_SHT_HEATER_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -711,18 +761,20 @@ int16_t sen66_activate_sht_heater(void) {
 int16_t sen66_get_sht_heater_measurements(int16_t* sht_relative_humidity,
                                           int16_t* sht_temperature) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
     local_offset = sensirion_i2c_add_command16_to_buffer(
         buffer_ptr, local_offset, SEN66_GET_SHT_HEATER_MEASUREMENTS_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(20 * 1000);
-    local_error = sensirion_i2c_read_data_inplace(_i2c_address, buffer_ptr, 4);
+    local_error =
+        sensirion_i2c_read_data_inplace(SEN66_I2C_ADDR_6B, buffer_ptr, 4);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -737,6 +789,7 @@ int16_t sen66_read_measured_values_as_integers(
     int16_t* ambient_humidity, int16_t* ambient_temperature, int16_t* voc_index,
     int16_t* nox_index, uint16_t* co2) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
@@ -744,12 +797,13 @@ int16_t sen66_read_measured_values_as_integers(
         buffer_ptr, local_offset,
         SEN66_READ_MEASURED_VALUES_AS_INTEGERS_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(20 * 1000);
-    local_error = sensirion_i2c_read_data_inplace(_i2c_address, buffer_ptr, 18);
+    local_error =
+        sensirion_i2c_read_data_inplace(SEN66_I2C_ADDR_6B, buffer_ptr, 18);
     if (local_error != NO_ERROR) {
         return local_error;
     }
@@ -774,18 +828,20 @@ int16_t sen66_read_measured_raw_values(int16_t* raw_humidity,
                                        uint16_t* raw_voc, uint16_t* raw_nox,
                                        uint16_t* raw_co2) {
     int16_t local_error = NO_ERROR;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE] = {0};
     uint8_t* buffer_ptr = communication_buffer;
     uint16_t local_offset = 0;
 
     local_offset = sensirion_i2c_add_command16_to_buffer(
         buffer_ptr, local_offset, SEN66_READ_MEASURED_RAW_VALUES_CMD_ID);
     local_error =
-        sensirion_i2c_write_data(_i2c_address, buffer_ptr, local_offset);
+        sensirion_i2c_write_data(SEN66_I2C_ADDR_6B, buffer_ptr, local_offset);
     if (local_error != NO_ERROR) {
         return local_error;
     }
     sensirion_i2c_hal_sleep_usec(20 * 1000);
-    local_error = sensirion_i2c_read_data_inplace(_i2c_address, buffer_ptr, 10);
+    local_error =
+        sensirion_i2c_read_data_inplace(SEN66_I2C_ADDR_6B, buffer_ptr, 10);
     if (local_error != NO_ERROR) {
         return local_error;
     }
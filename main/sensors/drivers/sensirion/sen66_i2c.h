@@ -101,12 +101,13 @@ typedef union {
 } sen66_device_status;
 
 /**
- * @brief Initialize i2c address of driver
+ * @brief Attach the sensor on the currently selected bus
  *
- * @param[in] i2c_address Used i2c address
+ * @param[in] i2c_address Used i2c address; must be SEN66_I2C_ADDR_6B
  *
+ * @return error_code 0 on success, an error code otherwise.
  */
-void sen66_init(uint8_t i2c_address);
+int16_t sen66_init(uint8_t i2c_address);
 
 /**
  * @brief sen66_get_voc_algorithm_tuning_parameters
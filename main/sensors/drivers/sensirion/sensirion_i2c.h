@@ -341,6 +341,22 @@ int16_t sensirion_i2c_write_data(uint8_t address, const uint8_t* data,
  */
 int16_t sensirion_i2c_read_data_inplace(uint8_t address, uint8_t* buffer,
                                         uint16_t expected_data_length);
+
+/**
+ * sensirion_i2c_read_words_decoded() - Reads a response of num_words words
+ * and checks and unpacks it in a single pass over the raw frame, without
+ * compacting the buffer first.
+ *
+ * @param address   Sensor I2C address
+ * @param words     Receives the words in host byte order. Signed values can
+ *                  be cast to int16_t.
+ * @param num_words Number of words to read, at most
+ *                  SENSIRION_MAX_BUFFER_WORDS.
+ *
+ * @return          NO_ERROR on success, an error code otherwise
+ */
+int16_t sensirion_i2c_read_words_decoded(uint8_t address, uint16_t* words,
+                                         uint16_t num_words);
 #ifdef __cplusplus
 }
 #endif
@@ -5,7 +5,12 @@
 
 #include <esp_err.h>
 #include <esp_log.h>
+#include <esp_rom_sys.h>
+#include <esp_timer.h>
 #include "driver/i2c_master.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
 #include "sdkconfig.h"
 
 /*
@@ -20,7 +25,7 @@ static const char * TAG = "SEN66";
 
 #define I2C_MASTER_SCL_IO CONFIG_SEN66_I2C_SCL_PIN
 #define I2C_MASTER_SDA_IO CONFIG_SEN66_I2C_SDA_PIN
-#define I2C_MASTER_NUM I2C_NUM_0    /*!< I2C port number for master dev */
+#define I2C_MASTER_NUM I2C_NUM_0    /*!< I2C port the HAL creates at init */
 #define I2C_MASTER_FREQ_HZ 100000   /*!< I2C master clock frequency */
 
 /* A single I2C transaction is retried a few times before it is reported as an
@@ -31,56 +36,136 @@ static const char * TAG = "SEN66";
 #define I2C_HAL_RETRY_DELAY_US (2 * 1000)  /* 2 ms between attempts */
 #define I2C_HAL_TXN_TIMEOUT_MS 1000        /* per-attempt timeout */
 
-i2c_master_bus_handle_t bus_handle;
-i2c_master_dev_handle_t dev_handle = NULL;
+/* Device handles, one per (bus, address) pair seen so far. Entries are only
+ * ever added, so a handle looked up under s_devices_lock stays valid after
+ * the lock is released; the ESP-IDF master driver serialises transactions
+ * on each bus itself. */
+#define I2C_HAL_MAX_DEVICES 4
 
-/* Lazily attach the sensor to the shared I2C bus. Non-fatal: on failure the
- * global dev_handle stays NULL and the caller returns an I2C error instead of
- * aborting the whole device. */
-static esp_err_t hal_ensure_device(uint8_t address)
+typedef struct {
+    uint8_t bus_idx;
+    uint8_t address;
+    i2c_master_dev_handle_t handle;
+} hal_device_t;
+
+static hal_device_t s_devices[I2C_HAL_MAX_DEVICES];
+static size_t s_device_count = 0;
+static SemaphoreHandle_t s_devices_lock = NULL;
+static StaticSemaphore_t s_devices_lock_buffer;
+
+/* Bus used by the calling task; see sensirion_i2c_hal_select_bus(). */
+static __thread uint8_t s_selected_bus = I2C_MASTER_NUM;
+
+/* Time spent in sensirion_i2c_hal_sleep_usec(), split by how it was spent;
+ * see sensirion_i2c_hal_get_sleep_stats(). */
+static portMUX_TYPE s_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint64_t s_yielded_us = 0;
+static uint64_t s_spun_us = 0;
+
+/* Returns the handle of the device at address on the calling task's bus,
+ * attaching it on first use. Non-fatal: on failure NULL is returned and the
+ * caller reports an I2C error instead of aborting the whole device. */
+static i2c_master_dev_handle_t hal_get_device(uint8_t address)
 {
-    if (dev_handle != NULL) {
-        return ESP_OK;
+    uint8_t bus_idx = s_selected_bus;
+    i2c_master_dev_handle_t handle = NULL;
+
+    if (s_devices_lock == NULL) {
+        ESP_LOGE(TAG, "I2C access before sensirion_i2c_hal_init()");
+        return NULL;
     }
 
-    i2c_device_config_t dev_cfg = {
-        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
-        .device_address = address,
-        .scl_speed_hz = I2C_MASTER_FREQ_HZ,
-    };
+    xSemaphoreTake(s_devices_lock, portMAX_DELAY);
+
+    for (size_t i = 0; i < s_device_count; i++) {
+        if (s_devices[i].bus_idx == bus_idx && s_devices[i].address == address) {
+            handle = s_devices[i].handle;
+            break;
+        }
+    }
 
-    esp_err_t err = i2c_master_bus_add_device(bus_handle, &dev_cfg, &dev_handle);
-    if (err != ESP_OK) {
-        dev_handle = NULL;
-        ESP_LOGE(TAG, "i2c_master_bus_add_device(0x%02x) failed: %s", address,
-                 esp_err_to_name(err));
+    if (handle == NULL) {
+        i2c_master_bus_handle_t bus = NULL;
+        esp_err_t err = i2c_master_get_bus_handle((i2c_port_num_t)bus_idx, &bus);
+        if (err == ESP_OK && s_device_count == I2C_HAL_MAX_DEVICES) {
+            err = ESP_ERR_NO_MEM;
+        }
+        if (err == ESP_OK) {
+            i2c_device_config_t dev_cfg = {
+                .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+                .device_address = address,
+                .scl_speed_hz = I2C_MASTER_FREQ_HZ,
+            };
+            err = i2c_master_bus_add_device(bus, &dev_cfg, &handle);
+        }
+        if (err == ESP_OK) {
+            s_devices[s_device_count].bus_idx = bus_idx;
+            s_devices[s_device_count].address = address;
+            s_devices[s_device_count].handle = handle;
+            s_device_count++;
+        } else {
+            handle = NULL;
+            ESP_LOGE(TAG, "Attaching I2C device 0x%02x on bus %u failed: %s",
+                     address, (unsigned)bus_idx, esp_err_to_name(err));
+        }
     }
-    return err;
+
+    xSemaphoreGive(s_devices_lock);
+    return handle;
 }
 
 /**
  * Select the current i2c bus by index.
  * All following i2c operations will be directed at that bus.
  *
- * THE IMPLEMENTATION IS OPTIONAL ON SINGLE-BUS SETUPS (all sensors on the same
- * bus)
+ * The bus index is the ESP-IDF I2C port number and the selection is per
+ * task, so sensors on different buses can be driven from different tasks.
+ * Buses other than the one sensirion_i2c_hal_init() creates must already
+ * have been created with i2c_new_master_bus().
  *
  * @param bus_idx   Bus index to select
  * @returns         0 on success, an error code otherwise
  */
 int16_t sensirion_i2c_hal_select_bus(uint8_t bus_idx) {
-    /* TODO:IMPLEMENT or leave empty if all sensors are located on one single
-     * bus
-     */
-    return NOT_IMPLEMENTED_ERROR;
+    i2c_master_bus_handle_t bus = NULL;
+    if (i2c_master_get_bus_handle((i2c_port_num_t)bus_idx, &bus) != ESP_OK) {
+        ESP_LOGE(TAG, "I2C bus %u has not been created", (unsigned)bus_idx);
+        return I2C_BUS_ERROR;
+    }
+    s_selected_bus = bus_idx;
+    return NO_ERROR;
+}
+
+/**
+ * Attach the device at address on the calling task's bus to the device
+ * table, so a missing bus or a full table shows up when the sensor driver
+ * initialises rather than on its first command.
+ *
+ * @param address 7-bit I2C address of the device
+ * @returns       0 on success, an error code otherwise
+ */
+int16_t sensirion_i2c_hal_attach(uint8_t address) {
+    return hal_get_device(address) != NULL ? NO_ERROR : I2C_BUS_ERROR;
 }
 
 /**
  * Initialize all hard- and software components that are needed for the I2C
  * communication.
+ *
+ * Every sensor driver calls this from its Init(); only the first call
+ * creates the bus, later ones find it already there.
  */
 void sensirion_i2c_hal_init(void)
 {
+    if (s_devices_lock == NULL) {
+        s_devices_lock = xSemaphoreCreateMutexStatic(&s_devices_lock_buffer);
+    }
+
+    i2c_master_bus_handle_t bus_handle = NULL;
+    if (i2c_master_get_bus_handle(I2C_MASTER_NUM, &bus_handle) == ESP_OK) {
+        return;
+    }
+
     i2c_master_bus_config_t i2c_mst_config = {
         .clk_source = I2C_CLK_SRC_DEFAULT,
         .i2c_port = I2C_MASTER_NUM,
@@ -116,7 +201,8 @@ void sensirion_i2c_hal_free(void) {
  */
 int8_t sensirion_i2c_hal_read(uint8_t address, uint8_t* data, uint8_t count)
 {
-    if (hal_ensure_device(address) != ESP_OK) {
+    i2c_master_dev_handle_t dev_handle = hal_get_device(address);
+    if (dev_handle == NULL) {
         return I2C_BUS_ERROR;
     }
 
@@ -152,7 +238,8 @@ int8_t sensirion_i2c_hal_read(uint8_t address, uint8_t* data, uint8_t count)
  */
 int8_t sensirion_i2c_hal_write(uint8_t address, const uint8_t* data, uint8_t count)
 {
-    if (hal_ensure_device(address) != ESP_OK) {
+    i2c_master_dev_handle_t dev_handle = hal_get_device(address);
+    if (dev_handle == NULL) {
         return I2C_BUS_ERROR;
     }
 
@@ -181,8 +268,40 @@ int8_t sensirion_i2c_hal_write(uint8_t address, const uint8_t* data, uint8_t cou
  *
  * Despite the unit, a <10 millisecond precision is sufficient.
  *
+ * Waits of at least one RTOS tick block the calling task, so the single core
+ * runs the Thread/Matter stack and the other timers meanwhile instead of
+ * spinning through the 20 ms command delays or the ~1.2 s device reset. The
+ * delay is rounded up by one tick because vTaskDelay(n) may return up to a
+ * tick early. Only sub-tick waits (e.g. the 2 ms retry delay), or calls made
+ * before the scheduler runs, busy-wait.
+ *
  * @param useconds the sleep time in microseconds
  */
 void sensirion_i2c_hal_sleep_usec(uint32_t useconds) {
+    const uint32_t tick_us = portTICK_PERIOD_MS * 1000;
+    int64_t start = esp_timer_get_time();
+
+    if (useconds >= tick_us &&
+        xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+        vTaskDelay((TickType_t)((useconds + tick_us - 1) / tick_us) + 1);
+        uint64_t elapsed = (uint64_t)(esp_timer_get_time() - start);
+        taskENTER_CRITICAL(&s_stats_lock);
+        s_yielded_us += elapsed;
+        taskEXIT_CRITICAL(&s_stats_lock);
+        return;
+    }
+
     esp_rom_delay_us(useconds);
+    uint64_t elapsed = (uint64_t)(esp_timer_get_time() - start);
+    taskENTER_CRITICAL(&s_stats_lock);
+    s_spun_us += elapsed;
+    taskEXIT_CRITICAL(&s_stats_lock);
+}
+
+void sensirion_i2c_hal_get_sleep_stats(uint64_t* yielded_us,
+                                       uint64_t* spun_us) {
+    taskENTER_CRITICAL(&s_stats_lock);
+    *yielded_us = s_yielded_us;
+    *spun_us = s_spun_us;
+    taskEXIT_CRITICAL(&s_stats_lock);
 }
\ No newline at end of file
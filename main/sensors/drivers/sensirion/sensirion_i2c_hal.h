@@ -42,17 +42,28 @@ extern "C" {
  * Select the current i2c bus by index.
  * All following i2c operations will be directed at that bus.
  *
- * THE IMPLEMENTATION IS OPTIONAL ON SINGLE-BUS SETUPS (all sensors on the same
- * bus)
+ * The bus index is the ESP-IDF I2C port number and the selection is per
+ * task. Devices are tracked per (bus, address), so sensors can share a bus or
+ * sit on different ones.
  *
  * @param bus_idx   Bus index to select
  * @returns         0 on success, an error code otherwise
  */
 int16_t sensirion_i2c_hal_select_bus(uint8_t bus_idx);
 
+/**
+ * Attach the device at the given address on the current bus. The HAL keeps
+ * one handle per (bus, address) in its device table; reads and writes find
+ * it there, attaching on first use if this was not called.
+ * @param address 7-bit I2C address of the device
+ * @returns       0 on success, an error code otherwise
+ */
+int16_t sensirion_i2c_hal_attach(uint8_t address);
+
 /**
  * Initialize all hard- and software components that are needed for the I2C
- * communication.
+ * communication. Safe to call once per sensor driver; only the first call
+ * creates the bus.
  */
 void sensirion_i2c_hal_init(void);
 
@@ -105,6 +116,18 @@ int8_t sensirion_i2c_hal_write(uint8_t address, const uint8_t* data,
  */
 void sensirion_i2c_hal_sleep_usec(uint32_t useconds);
 
+/**
+ * Cumulative time spent in sensirion_i2c_hal_sleep_usec() since boot: the
+ * part that blocked the calling task (CPU left to other tasks) and the part
+ * that busy-waited. Lets the application measure how much CPU time the
+ * acquisition path gives back.
+ *
+ * @param yielded_us receives the total blocking sleep time in microseconds
+ * @param spun_us    receives the total busy-wait time in microseconds
+ */
+void sensirion_i2c_hal_get_sleep_stats(uint64_t* yielded_us,
+                                       uint64_t* spun_us);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */